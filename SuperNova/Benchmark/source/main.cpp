@@ -0,0 +1,143 @@
+#include <Engine/Assets/AssetDatabase.hpp>
+#include <Engine/Assets/Model.hpp>
+#include <Engine/Assets/Shader.hpp>
+#include <Engine/Components/Camera.hpp>
+#include <Engine/Components/Transform.hpp>
+#include <Engine/Core/Core.hpp>
+#include <Engine/Core/JobSystem.hpp>
+#include <Engine/Core/Log.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
+#include <Engine/Core/Profiler.hpp>
+#include <Engine/Entity/GameObject.hpp>
+#include <Engine/Renderer/Renderer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+
+// NOTE(v.matushkin): Headless CPU-only benchmark of the frame submission path.
+//  Usage: SuperNovaBenchmark [frameCount] [assetDirectory] [tracePath]
+//  With tracePath the measured frames are captured by the Profiler into a Chrome trace.
+
+
+using Clock = std::chrono::high_resolution_clock;
+
+
+const ui32  k_DefaultFrameCount = 1000;
+const ui32  k_WarmupFrameCount  = 10;
+const char* k_DefaultAssetDir   = "../../assets/";
+const char* k_SponzaObjPath     = "Sponza/sponza.obj";
+const char* k_ShaderName        = "triangle";
+
+// NOTE(v.matushkin): HeapAllocationGuardMode::Assert breaks on the first heap allocation of a measured frame
+const snv::HeapAllocationGuardMode k_HeapAllocationGuardMode = snv::HeapAllocationGuardMode::Count;
+
+
+f64 ToMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<f64, std::milli>(duration).count();
+}
+
+
+i32 main(i32 argc, char** argv)
+{
+    const ui32  frameCount = argc > 1 ? static_cast<ui32>(std::strtoul(argv[1], nullptr, 10)) : k_DefaultFrameCount;
+    std::string assetDir   = argc > 2 ? argv[2] : k_DefaultAssetDir;
+    const char* tracePath  = argc > 3 ? argv[3] : nullptr;
+
+    PROFILE_THREAD("Main");
+
+    snv::JobSystem::Init();
+    // NOTE(v.matushkin): NullBackend doesn't have a swapchain, the desc is ignored
+    snv::Renderer::Init(snv::GraphicsApi::Null, {.PreferredPresentMode = snv::PresentMode::Immediate, .FramesInFlight = 1});
+    snv::AssetDatabase::Init(std::move(assetDir));
+
+    (void) snv::AssetDatabase::LoadAsset<snv::Shader>(k_ShaderName);
+
+    const auto sponzaLoadStart = Clock::now();
+    const auto sponzaModel     = snv::AssetDatabase::LoadAsset<snv::Model>(k_SponzaObjPath);
+    const auto sponzaLoadTime  = Clock::now() - sponzaLoadStart;
+    LOG_INFO("Sponza loading time: {:.3f}ms", ToMilliseconds(sponzaLoadTime));
+
+    snv::GameObject sponzaGO;
+    sponzaGO.GetComponent<snv::Transform>().SetScale(0.005f);
+    const auto& sponzaTransform = sponzaGO.GetComponent<snv::Transform>();
+
+    snv::GameObject camera;
+    camera.AddComponent<snv::Camera>(90.0f, 1100.0f / 800.0f, 0.1f, 100.0f);
+
+    for (ui32 i = 0; i < k_WarmupFrameCount; ++i)
+    {
+        snv::Renderer::RenderFrame(sponzaTransform.GetMatrix());
+    }
+
+    std::vector<f64> frameTimes;
+    frameTimes.reserve(frameCount);
+
+    // NOTE(v.matushkin): After the warmup, everything the steady state frames need is allocated by now
+    snv::MemoryTracker::SetHeapAllocationGuardMode(k_HeapAllocationGuardMode);
+
+    if (tracePath != nullptr)
+    {
+        snv::Profiler::BeginCapture();
+    }
+
+    const auto benchmarkStart = Clock::now();
+    for (ui32 i = 0; i < frameCount; ++i)
+    {
+        const auto frameStart = Clock::now();
+        snv::Renderer::RenderFrame(sponzaTransform.GetMatrix());
+        frameTimes.push_back(ToMilliseconds(Clock::now() - frameStart));
+    }
+    const auto benchmarkTime = ToMilliseconds(Clock::now() - benchmarkStart);
+
+    if (tracePath != nullptr)
+    {
+        snv::Profiler::EndCapture(tracePath);
+    }
+
+    const auto& frameStats = snv::Renderer::GetFrameStats();
+
+    if (frameTimes.empty() == false)
+    {
+        std::sort(frameTimes.begin(), frameTimes.end());
+        const auto percentile = [&frameTimes](f64 p) {
+            return frameTimes[static_cast<size_t>(p * (frameTimes.size() - 1))];
+        };
+
+        LOG_INFO(
+            "Frame submission benchmark\n"
+            "\tFrames: {}\n"
+            "\tDraw calls per frame: {}\n"
+            "\tCulled objects per frame: {}\n"
+            "\tTriangles per frame: {}\n"
+            "\tState changes per frame: {}\n"
+            "\tInstanced objects per frame: {}\n"
+            "\tHeap allocations per frame: {}\n"
+            "\tCPU frame time (ms): avg {:.4f} | min {:.4f} | p50 {:.4f} | p99 {:.4f} | max {:.4f}",
+            frameCount,
+            frameStats.DrawCalls,
+            frameStats.CulledObjects,
+            frameStats.Triangles,
+            frameStats.StateChanges,
+            frameStats.InstancedObjects,
+            frameStats.HeapAllocations,
+            benchmarkTime / frameCount,
+            frameTimes.front(),
+            percentile(0.5),
+            percentile(0.99),
+            frameTimes.back()
+        );
+    }
+
+    snv::MemoryTracker::LogTagStats();
+
+    snv::AssetDatabase::Shutdown();
+    snv::Renderer::Shutdown();
+    snv::JobSystem::Shutdown();
+
+    return 0;
+}
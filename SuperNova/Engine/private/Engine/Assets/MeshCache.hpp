@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+#include <Engine/Utils/MappedFile.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+
+// NOTE(v.matushkin): Cooked model format, written on the first import and memory mapped after that.
+//  File layout:
+//    FileHeader
+//    FileMaterial[MaterialCount]
+//    FileMesh[MeshCount]
+//    String table (material names and texture paths, not null terminated)
+//    Index/Vertex data, every stream is k_DataAlignment aligned
+//  Only the source file content and the mesh import settings are hashed, so changes in the referenced .mtl/textures are not detected.
+//  Bump k_Version every time the format or the import settings are changed.
+
+
+namespace snv::MeshCache
+{
+
+inline constexpr const char* k_FileExtension = ".snvmesh";
+
+
+struct MaterialRecord
+{
+    std::string Name;
+    // NOTE(v.matushkin): Empty path means that the material doesn't have this texture
+    std::string BaseColorMapPath;
+    std::string NormalMapPath;
+};
+
+// NOTE(v.matushkin): Doesn't own the data, it points either into the MappedFile or into the import buffers
+struct MeshRecord
+{
+    std::span<const std::byte>       IndexData;
+    IndexFormat                      IndexDataFormat;
+    std::span<const std::byte>       VertexData;
+    i32                              VertexCount;
+    std::vector<VertexAttributeDesc> VertexLayout;
+    AABB                             Bounds;
+    ui32                             MaterialIndex;
+};
+
+struct CookedModel
+{
+    MappedFile                  File;
+    std::vector<MaterialRecord> Materials;
+    std::vector<MeshRecord>     Meshes;
+};
+
+
+// NOTE(v.matushkin): Returns false if there is no cache, or it's stale/corrupted
+[[nodiscard]] bool Read(const std::string& cachePath, ui64 sourceHash, CookedModel& cookedModel);
+bool Write(
+    const std::string&              cachePath,
+    ui64                            sourceHash,
+    std::span<const MaterialRecord> materials,
+    std::span<const MeshRecord>     meshes
+);
+
+} // namespace snv::MeshCache
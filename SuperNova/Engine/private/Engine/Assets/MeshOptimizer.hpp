@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <span>
+#include <vector>
+
+
+// NOTE(v.matushkin): Import time triangle/vertex reordering, all functions work on triangle lists.
+//  The usual order is OptimizeVertexCache -> OptimizeOverdraw -> OptimizeVertexFetch,
+//  the last one changes the vertex order, so the vertex data has to be written after it.
+
+
+namespace snv::MeshOptimizer
+{
+
+// NOTE(v.matushkin): FIFO size used to measure the result, somewhere around what the hardware has
+inline constexpr ui32 k_FifoCacheSize = 16;
+
+
+// NOTE(v.matushkin): How many vertices a FIFO cache of k_FifoCacheSize would have to transform,
+//  divided by the triangle count it's the ACMR (average cache miss ratio), 0.5 is the best, 3 is the worst
+[[nodiscard]] ui32 CountTransformedVertices(std::span<const ui32> indices, ui32 vertexCount);
+
+// NOTE(v.matushkin): Tom Forsyth's linear-speed vertex cache optimisation, reorders the triangles in place
+void OptimizeVertexCache(std::span<ui32> indices, ui32 vertexCount);
+
+// NOTE(v.matushkin): Splits the triangles into clusters where the vertex cache starts from scratch anyway,
+//  and sorts the clusters so the ones facing away from the mesh center are drawn first.
+//  Must be called after OptimizeVertexCache, positions are 3 f32 with positionStride bytes between them.
+void OptimizeOverdraw(std::span<ui32> indices, const f32* positions, ui32 positionStride);
+
+// NOTE(v.matushkin): Renumbers vertices in the order of the first use, so the vertex fetch is as linear as possible.
+//  vertexOrder[newIndex] = oldIndex, vertices that are not referenced are dropped. Returns the new vertex count.
+[[nodiscard]] ui32 OptimizeVertexFetch(std::span<ui32> indices, ui32 vertexCount, std::vector<ui32>& vertexOrder);
+
+} // namespace snv::MeshOptimizer
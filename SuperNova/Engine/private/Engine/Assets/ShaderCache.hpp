@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Utils/MappedFile.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+
+// NOTE(v.matushkin): Precompiled SPIR-V of a Vulkan shader stage, written by SuperNovaShaderCompiler
+//  next to the GLSL source and memory mapped by AssetDatabase::LoadShader().
+//  File layout:
+//    FileHeader
+//    SPIR-V words, k_DataAlignment aligned
+//  SourceHash is the HashBytes() of the GLSL source, a changed source makes the cache stale.
+//  Bump k_Version every time the format or the compiler options are changed.
+
+
+namespace snv::ShaderCache
+{
+
+inline constexpr const char* k_FileExtension = ".snvspv";
+
+
+struct CookedShader
+{
+    // NOTE(v.matushkin): Points into the File
+    std::span<const std::byte> Bytecode;
+    MappedFile                 File;
+};
+
+
+// NOTE(v.matushkin): Returns false if there is no cache, or it's stale/corrupted
+[[nodiscard]] bool Read(const std::string& cachePath, ui64 sourceHash, CookedShader& cookedShader);
+bool Write(const std::string& cachePath, ui64 sourceHash, std::span<const ui32> spirvBytecode);
+
+} // namespace snv::ShaderCache
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// NOTE(v.matushkin): Shader hot reload. A background thread polls the write time of the watched shader sources
+//  and calls OnShaderChanged on that same thread, so the recompilation never runs on the main thread.
+//  Polling instead of inotify/ReadDirectoryChangesW, it's a handful of files and it works the same everywhere.
+//  Editors often write a file in several steps, a change is reported once the write time stops changing.
+
+
+namespace snv
+{
+
+class ShaderWatcher
+{
+    static constexpr std::chrono::milliseconds k_PollInterval{200};
+
+    struct WatchedFile
+    {
+        std::string                     Path;
+        std::filesystem::file_time_type WriteTime;
+    };
+
+    struct WatchedShader
+    {
+        ShaderHandle             Handle;
+        std::string              Name;
+        std::vector<WatchedFile> Files;
+        bool                     IsChanged; // NOTE(v.matushkin): Changed on the previous poll, reported on this one
+    };
+
+public:
+    using OnShaderChanged = std::function<void(ShaderHandle shaderHandle, const std::string& shaderName)>;
+
+    explicit ShaderWatcher(OnShaderChanged onShaderChanged);
+    ~ShaderWatcher();
+
+    ShaderWatcher(ShaderWatcher&& other) = delete;
+    ShaderWatcher& operator=(ShaderWatcher&& other) = delete;
+
+    ShaderWatcher(const ShaderWatcher& other) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher& other) = delete;
+
+    void Watch(ShaderHandle shaderHandle, std::string shaderName, std::span<const std::string> filePaths);
+
+private:
+    void WatcherLoop();
+    // NOTE(v.matushkin): Returns false if the file can't be accessed right now, it's probably being written
+    [[nodiscard]] static bool GetWriteTime(const std::string& filePath, std::filesystem::file_time_type& writeTime);
+
+private:
+    OnShaderChanged            m_onShaderChanged;
+
+    std::mutex                 m_mutex;
+    std::condition_variable    m_stop;
+    std::vector<WatchedShader> m_shaders;
+    bool                       m_isStopping;
+
+    std::thread                m_thread; // NOTE(v.matushkin): Last, so it starts after everything else is initialized
+};
+
+} // namespace snv
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+#include <Engine/Utils/MappedFile.hpp>
+
+#include <memory>
+#include <span>
+#include <string>
+
+
+// NOTE(v.matushkin): Cooked texture format, written on the first import and memory mapped after that.
+//  File layout:
+//    FileHeader
+//    Mip chain in the CreateTexture() layout, k_DataAlignment aligned
+//  Bump k_Version every time the format or the import settings are changed.
+
+
+namespace snv::TextureCache
+{
+
+inline constexpr const char* k_FileExtension = ".snvtex";
+
+
+struct CookedTexture
+{
+    TextureDesc            Desc;
+    // NOTE(v.matushkin): Data points either into the File or into the OwnedData
+    std::span<const ui8>   Data;
+    MappedFile             File;
+    std::unique_ptr<ui8[]> OwnedData;
+};
+
+
+// NOTE(v.matushkin): Returns false if there is no cache, or it's stale/corrupted
+[[nodiscard]] bool Read(const std::string& cachePath, ui64 sourceHash, CookedTexture& cookedTexture);
+bool Write(const std::string& cachePath, ui64 sourceHash, const TextureDesc& textureDesc, std::span<const ui8> textureData);
+
+// NOTE(v.matushkin): Box filters mip 0 of RGBA8 textureData into the rest of the mip chain, textureData must hold all the mips
+void GenerateMipChain(const TextureDesc& textureDesc, std::span<ui8> textureData);
+
+} // namespace snv::TextureCache
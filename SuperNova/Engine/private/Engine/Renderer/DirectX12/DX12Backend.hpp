@@ -31,14 +31,11 @@ class DX12Backend final : public IRendererBackend
     struct DX12Buffer
     {
         Microsoft::WRL::ComPtr<ID3D12Resource2> Index;
-        Microsoft::WRL::ComPtr<ID3D12Resource2> Position;
-        Microsoft::WRL::ComPtr<ID3D12Resource2> Normal;
-        Microsoft::WRL::ComPtr<ID3D12Resource2> TexCoord0;
+        Microsoft::WRL::ComPtr<ID3D12Resource2> Vertex;
 
         D3D12_INDEX_BUFFER_VIEW  IndexView;
-        D3D12_VERTEX_BUFFER_VIEW PositionView;
-        D3D12_VERTEX_BUFFER_VIEW NormalView;
-        D3D12_VERTEX_BUFFER_VIEW TexCoord0View;
+        // NOTE(v.matushkin): View per attribute, they all point into the Vertex buffer
+        D3D12_VERTEX_BUFFER_VIEW VertexViews[static_cast<ui8>(VertexAttribute::Count)];
     };
 
     struct DX12Texture
@@ -67,6 +64,7 @@ class DX12Backend final : public IRendererBackend
 
 
     static const ui32 k_BackBufferFrames = 3;
+    static const ui32 k_MaxDrawsPerFrame = 4096;
 
 public:
     DX12Backend();
@@ -82,19 +80,21 @@ public:
 
     void Clear(BufferBit bufferBitMask) override;
 
-    void BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
+    void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
     void EndFrame() override;
-    void DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount) override;
+    void Submit(const RenderCommandStream& commandStream) override;
     void DrawArrays(i32 count) override;
     void DrawElements(i32 count) override;
 
     BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) override;
     TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) override;
     ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+    bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
 
 private:
     void CreateDevice();
@@ -111,6 +111,8 @@ private:
     void CreateRootSignature();
     void CreatePipeline();
 
+    void SetPerDraw(const glm::mat4x4& objectToWorld);
+
     void WaitForPreviousFrame();
 
     bool CheckTearingSupport();
@@ -141,7 +143,10 @@ private:
     Microsoft::WRL::ComPtr<ID3D12Resource2> m_cbPerFrame;
     Microsoft::WRL::ComPtr<ID3D12Resource2> m_cbPerDraw;
     PerFrame                                m_cbPerFrameData;
-    PerDraw                                 m_cbPerDrawData;
+    // NOTE(v.matushkin): Mapped once on creation, UPLOAD heap resources can stay mapped
+    ui8*                                    m_cbPerFrameMapped;
+    ui8*                                    m_cbPerDrawMapped;
+    ui32                                    m_cbPerDrawCount; // NOTE(v.matushkin): Draws recorded in the current frame
 
     D3D12_VIEWPORT m_viewport;
     D3D12_RECT     m_scissorRect;
@@ -161,6 +166,10 @@ private:
 
     f32 m_clearColor[4] = {0.098f, 0.439f, 0.439f, 1.000f};
 
+    // NOTE(v.matushkin): The pipeline input layout is built from the layout of the first buffer,
+    //  every other buffer must have the same vertex format
+    std::vector<VertexAttributeDesc> m_vertexLayout;
+
     std::unordered_map<BufferHandle,  DX12Buffer>  m_buffers;
     std::unordered_map<TextureHandle, DX12Texture> m_textures;
     std::unordered_map<ShaderHandle,  DX12Shader>  m_shaders;
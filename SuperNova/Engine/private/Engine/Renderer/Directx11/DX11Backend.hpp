@@ -3,6 +3,7 @@
 #include <Engine/Renderer/IRendererBackend.hpp>
 
 #include <glm/ext/matrix_float4x4.hpp>
+#include <dxgiformat.h>
 #include <wrl/client.h>
 
 #include <unordered_map>
@@ -14,6 +15,8 @@ struct IDXGISwapChain4;
 struct ID3D11RenderTargetView;
 struct ID3D11DepthStencilView;
 struct ID3D11InputLayout;
+struct ID3D10Blob;
+using ID3DBlob = ID3D10Blob;
 struct ID3D11VertexShader;
 struct ID3D11PixelShader;
 struct ID3D11Buffer;
@@ -30,9 +33,11 @@ class DX11Backend final : public IRendererBackend
     struct DX11Buffer
     {
         Microsoft::WRL::ComPtr<ID3D11Buffer> Index;
-        Microsoft::WRL::ComPtr<ID3D11Buffer> Position;
-        Microsoft::WRL::ComPtr<ID3D11Buffer> Normal;
-        Microsoft::WRL::ComPtr<ID3D11Buffer> TexCoord0;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> Vertex;
+        DXGI_FORMAT                          IndexFormat;
+        // NOTE(v.matushkin): Every attribute has its own input slot, they all point into the Vertex buffer
+        ui32                                 VertexOffsets[static_cast<ui8>(VertexAttribute::Count)];
+        ui32                                 VertexStrides[static_cast<ui8>(VertexAttribute::Count)];
     };
 
     struct DX11Texture
@@ -44,7 +49,7 @@ class DX11Backend final : public IRendererBackend
 
     struct DX11Shader
     {
-        Microsoft::WRL::ComPtr<ID3D11InputLayout>  InputLayout;
+        Microsoft::WRL::ComPtr<ID3DBlob>           VertexBytecode; // NOTE(v.matushkin): For the input layout
         Microsoft::WRL::ComPtr<ID3D11VertexShader> VertexShader;
         Microsoft::WRL::ComPtr<ID3D11PixelShader>  FragmentShader;
     };
@@ -74,23 +79,28 @@ public:
 
     void Clear(BufferBit bufferBitMask) override;
 
-    void BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
+    void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
     void EndFrame() override;
-    void DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount) override;
+    void Submit(const RenderCommandStream& commandStream) override;
     void DrawArrays(i32 count) override;
     void DrawElements(i32 count) override;
 
     BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) override;
     TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) override;
     ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+    bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
 
 private:
     void CreateDevice();
     void CreateSwapChain();
+    void CreateInputLayout(const std::vector<VertexAttributeDesc>& vertexLayout);
+
+    void SetPerDraw(const glm::mat4x4& objectToWorld);
 
 private:
     //-----------------------------------------------------------------------------
@@ -107,6 +117,9 @@ private:
     // Constant buffers
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_cbPerFrame;
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_cbPerDraw;
+    // NOTE(v.matushkin): Created from the layout of the first buffer, every other buffer must have the same vertex format
+    Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
+    std::vector<VertexAttributeDesc>          m_vertexLayout;
 
 
     f32 m_clearColor[4] = {0.098f, 0.439f, 0.439f, 1.000f};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <span>
+
+
+// NOTE(v.matushkin): Every visible draw gets a 64 bit key, from the most significant bits:
+//    Pipeline | Texture | Buffer | Depth
+//  Sorting by the key puts the draws that share a pipeline next to each other, then the ones that share
+//  a material texture, and so on, so the backend can skip the binds that didn't change.
+//  Handles are truncated to their field width, a collision only makes the order slightly worse,
+//  backends compare the real handles before skipping a bind.
+
+
+namespace snv::DrawSorting
+{
+
+inline constexpr ui32 k_PipelineBits = 8;
+inline constexpr ui32 k_TextureBits  = 20;
+inline constexpr ui32 k_BufferBits   = 20;
+inline constexpr ui32 k_DepthBits    = 16;
+
+static_assert(k_PipelineBits + k_TextureBits + k_BufferBits + k_DepthBits == 64);
+
+
+struct SortItem
+{
+    ui64 Key;
+    ui32 Index; // NOTE(v.matushkin): Whatever the caller wants to get back in the sorted order
+};
+
+
+// NOTE(v.matushkin): depth is the clip space w of the draw, smaller goes first, so opaque draws are front to back
+//  inside of the same state. Negative depth goes to the first bucket.
+[[nodiscard]] ui64 MakeSortKey(ShaderHandle pipeline, TextureHandle texture, BufferHandle buffer, f32 depth);
+
+// NOTE(v.matushkin): Stable LSD radix sort by Key, 8 bits per pass. Passes where every key has the same digit
+//  are skipped, which is most of the pipeline/texture bits on a typical scene.
+//  scratch is only used as a ping-pong buffer and must be the same size as items.
+//  Returns the sorted items, which is either items or scratch, depending on the number of passes.
+std::span<SortItem> RadixSort(std::span<SortItem> items, std::span<SortItem> scratch);
+
+} // namespace snv::DrawSorting
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <glm/ext/matrix_float4x4.hpp>
+
+#include <span>
+#include <vector>
+
+
+// NOTE(v.matushkin): Bounds are stored as center/extents in SoA form, so one SIMD register holds the same
+//  component of k_SimdWidth boxes and every frustum plane is tested against k_SimdWidth boxes at once.
+//  Arrays are always padded to k_SimdWidth, the padding lanes are never reported as visible.
+
+
+namespace snv::FrustumCulling
+{
+
+inline constexpr ui32 k_SimdWidth = 4;
+inline constexpr ui32 k_PlaneCount = 6;
+
+
+// NOTE(v.matushkin): Planes are not normalized, it doesn't matter for the inside/outside test
+struct Frustum
+{
+    f32 PlaneX[k_PlaneCount];
+    f32 PlaneY[k_PlaneCount];
+    f32 PlaneZ[k_PlaneCount];
+    f32 PlaneW[k_PlaneCount];
+};
+
+class CullingBounds
+{
+public:
+    // NOTE(v.matushkin): Keeps the capacity, so after the first frame there are no allocations
+    void Clear();
+    // NOTE(v.matushkin): transform must be affine, the result is the AABB of the transformed box
+    void Add(const AABB& aabb, const glm::mat4x4& transform);
+
+    [[nodiscard]] ui32 GetCount() const { return m_count; }
+
+private:
+    friend ui32 Cull(const Frustum& frustum, const CullingBounds& bounds, std::span<ui32> visibleIndices);
+
+    ui32             m_count = 0;
+
+    std::vector<f32> m_centerX;
+    std::vector<f32> m_centerY;
+    std::vector<f32> m_centerZ;
+    std::vector<f32> m_extentX;
+    std::vector<f32> m_extentY;
+    std::vector<f32> m_extentZ;
+};
+
+
+// NOTE(v.matushkin): Planes end up in the space the clipFromBounds matrix transforms from
+[[nodiscard]] Frustum ExtractFrustum(const glm::mat4x4& clipFromBounds);
+// NOTE(v.matushkin): Writes the indices (in Add() order) of the bounds that intersect the frustum to the front
+//  of visibleIndices and returns their count, visibleIndices must fit bounds.GetCount() indices
+ui32 Cull(const Frustum& frustum, const CullingBounds& bounds, std::span<ui32> visibleIndices);
+
+} // namespace snv::FrustumCulling
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/IRendererBackend.hpp>
+
+#include <glm/ext/matrix_float4x4.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace snv
+{
+
+// NOTE(v.matushkin): Backend that never touches a GPU, every call is just recorded.
+//  Used for headless runs (benchmarks, CI) where there is no window and no GPU.
+
+class NullBackend final : public IRendererBackend
+{
+    struct NullBuffer
+    {
+        ui64        IndexSize;
+        IndexFormat IndexDataFormat;
+        ui64        VertexSize;
+        ui32        VertexAttributeCount;
+    };
+
+    struct NullTexture
+    {
+        TextureDesc Desc;
+    };
+
+    struct NullShader
+    {
+        ui64 VertexSourceSize;
+        ui64 FragmentSourceSize;
+    };
+
+public:
+    enum class CommandType : ui8
+    {
+        BeginFrame,
+        EndFrame,
+        DrawIndexed,          // NOTE(v.matushkin): From the Submit() command stream, with the state that was bound
+        DrawIndexedInstanced, // NOTE(v.matushkin): ObjectToWorld is the one of the first instance
+        DrawArrays,
+        DrawElements,
+        Clear,
+    };
+
+    struct Command
+    {
+        CommandType   Type;
+        TextureHandle Texture;
+        BufferHandle  Buffer;
+        i32           IndexCount;
+        i32           VertexCount;
+        ui32          InstanceCount;
+        glm::mat4x4   ObjectToWorld;
+    };
+
+    struct Counters
+    {
+        ui64 BeginFrame;
+        ui64 EndFrame;
+        ui64 Submit;
+        ui64 SubmittedCommands;
+        ui64 DrawIndexed;
+        ui64 DrawIndexedInstanced;
+        ui64 Instances;
+        ui64 DrawArrays;
+        ui64 DrawElements;
+        ui64 Clear;
+        ui64 CreateBuffer;
+        ui64 CreateTexture;
+        ui64 CreateShader;
+        ui64 BufferBytes;
+        ui64 TextureBytes;
+    };
+
+public:
+    NullBackend();
+    ~NullBackend() override;
+
+    void EnableBlend() override;
+    void EnableDepthTest() override;
+
+    void SetBlendFunction(BlendFactor source, BlendFactor destination) override;
+    void SetClearColor(f32 r, f32 g, f32 b, f32 a) override;
+    void SetDepthFunction(DepthFunction depthFunction) override;
+    void SetViewport(i32 x, i32 y, i32 width, i32 height) override;
+
+    void Clear(BufferBit bufferBitMask) override;
+
+    void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
+    void EndFrame() override;
+    void Submit(const RenderCommandStream& commandStream) override;
+    void DrawArrays(i32 count) override;
+    void DrawElements(i32 count) override;
+
+    BufferHandle CreateBuffer(
+        std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
+        std::span<const std::byte>              vertexData,
+        const std::vector<VertexAttributeDesc>& vertexLayout
+    ) override;
+    TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) override;
+    ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+    bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+
+    [[nodiscard]] const Counters&             GetCounters()     const { return m_counters; }
+    // NOTE(v.matushkin): Commands of the last recorded frame, cleared on BeginFrame
+    [[nodiscard]] const std::vector<Command>& GetCommandList() const { return m_commandList; }
+
+private:
+    Counters             m_counters;
+    std::vector<Command> m_commandList;
+
+    glm::mat4x4          m_cameraView;
+    glm::mat4x4          m_cameraProjection;
+
+    std::unordered_map<BufferHandle,  NullBuffer>  m_buffers;
+    std::unordered_map<TextureHandle, NullTexture> m_textures;
+    std::unordered_map<ShaderHandle,  NullShader>  m_shaders;
+};
+
+} // namespace snv
@@ -3,10 +3,14 @@
 #include <Engine/Core/Core.hpp>
 #include <Engine/Renderer/IRendererBackend.hpp>
 #include <Engine/Renderer/OpenGL/GLBuffer.hpp>
+#include <Engine/Renderer/OpenGL/GLGpuProfiler.hpp>
 #include <Engine/Renderer/OpenGL/GLShader.hpp>
 #include <Engine/Renderer/OpenGL/GLTexture.hpp>
 
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 
 namespace snv
@@ -17,9 +21,18 @@ struct VertexAttributeDescriptor;
 
 class GLBackend final : public IRendererBackend
 {
+    // NOTE(v.matushkin): The GL context is current only on the main thread, so ReloadShader() just copies the sources
+    //  and the shader is compiled in the next BeginFrame()
+    struct PendingShaderReload
+    {
+        ShaderHandle Handle;
+        std::string  VertexSource;
+        std::string  FragmentSource;
+    };
+
 public:
     GLBackend();
-    ~GLBackend() override = default;
+    ~GLBackend() override;
 
     void EnableBlend() override;
     void EnableDepthTest() override;
@@ -31,24 +44,39 @@ public:
 
     void Clear(BufferBit bufferBitMask) override;
 
-    void BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
+    void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
     void EndFrame() override;
-    void DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount) override;
+    void Submit(const RenderCommandStream& commandStream) override;
     void DrawArrays(i32 count) override;
     void DrawElements(i32 count) override;
 
     BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) override;
     TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) override;
     ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+    bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+
+    [[nodiscard]] GpuFrameStats GetGpuFrameStats() const override { return m_gpuProfiler.GetFrameStats(); }
+
+private:
+    void ApplyShaderReloads();
 
 private:
     std::unordered_map<BufferHandle,  GLBuffer>  m_buffers;
     std::unordered_map<TextureHandle, GLTexture> m_textures;
     std::unordered_map<ShaderHandle,  GLShader>  m_shaders;
+
+    // NOTE(v.matushkin): SSBO with ObjectToWorld of every instance in the frame, refilled in Submit()
+    ui32 m_instanceBuffer;
+
+    std::mutex                       m_shaderReloadMutex;
+    std::vector<PendingShaderReload> m_pendingShaderReloads;
+
+    GLGpuProfiler                    m_gpuProfiler;
 };
 
 } // namespace snv
@@ -19,6 +19,7 @@ public:
 
     GLBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) noexcept;
@@ -30,6 +31,7 @@ public:
     GLBuffer& operator=(const GLBuffer& other) = delete;
 
     [[nodiscard]] BufferHandle GetHandle() const { return static_cast<BufferHandle>(m_vao); }
+    [[nodiscard]] ui32 GetIndexType() const { return m_indexType; }
 
     void Bind() const;
 
@@ -37,6 +39,7 @@ private:
     ui32 m_vao;
     ui32 m_vbo;
     ui32 m_ibo;
+    ui32 m_indexType; // NOTE(v.matushkin): GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
 };
 
 } // namespace snv
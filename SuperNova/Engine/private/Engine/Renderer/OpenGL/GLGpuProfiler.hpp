@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <span>
+
+
+// NOTE(v.matushkin): GPU timings with GL_TIME_ELAPSED queries, vertex/fragment invocations with the GL 4.6
+//  pipeline statistics queries. GL_TIME_ELAPSED queries can't nest, so the passes go one after another
+//  and the frame time is their sum. The queries are a ring of k_QueryFrames frames, a frame is read back
+//  when its slot comes around again, if the results aren't available by then they're skipped, never waited for.
+
+
+namespace snv
+{
+
+class GLGpuProfiler
+{
+    static const ui32 k_QueryFrames = 4;
+
+    enum PipelineStatistic : ui32
+    {
+        VertexInvocations,
+        FragmentInvocations,
+        Count
+    };
+
+public:
+    explicit GLGpuProfiler(std::span<const char* const> passNames);
+    ~GLGpuProfiler();
+
+    GLGpuProfiler(GLGpuProfiler&& other) = delete;
+    GLGpuProfiler& operator=(GLGpuProfiler&& other) = delete;
+
+    GLGpuProfiler(const GLGpuProfiler& other) = delete;
+    GLGpuProfiler& operator=(const GLGpuProfiler& other) = delete;
+
+    void BeginFrame();
+    void EndFrame();
+
+    // NOTE(v.matushkin): Only one pass can be active at a time
+    void BeginPass(ui32 passIndex);
+    void EndPass();
+
+    [[nodiscard]] const GpuFrameStats& GetFrameStats() const { return m_frameStats; }
+
+private:
+    void ReadFrameQueries(ui32 frameIndex);
+
+private:
+    ui32          m_passQueries[k_QueryFrames][k_MaxGpuPasses];
+    ui32          m_statisticQueries[k_QueryFrames][PipelineStatistic::Count];
+    bool          m_isPassRecorded[k_QueryFrames][k_MaxGpuPasses];
+    bool          m_isFrameRecorded[k_QueryFrames];
+
+    const char*   m_passNames[k_MaxGpuPasses];
+    ui32          m_passCount;
+
+    ui32          m_currentFrame;
+
+    GpuFrameStats m_frameStats;
+};
+
+} // namespace snv
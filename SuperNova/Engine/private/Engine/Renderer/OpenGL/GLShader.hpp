@@ -23,9 +23,10 @@ class GLShader
 {
 public:
     // NOTE(v.matushkin): Can I make this move only without default constructor?
-    // TODO(v.matushkin): Define destructor
     GLShader() noexcept;
+    // NOTE(v.matushkin): Sources must be null terminated
     GLShader(std::span<const char> vertexSource, std::span<const char> fragmentSource);
+    ~GLShader();
 
     GLShader(GLShader&& other) noexcept;
     GLShader& operator=(GLShader&& other) noexcept;
@@ -34,6 +35,8 @@ public:
     GLShader& operator=(const GLShader& other) = delete;
 
     [[nodiscard]] ShaderHandle GetHandle() const { return static_cast<ShaderHandle>(m_shaderProgramID); }
+    // NOTE(v.matushkin): Unlike the Check* methods works in every build, hot reload needs it to keep the old shader
+    [[nodiscard]] bool         IsLinked() const;
 
     void Bind() const;
 
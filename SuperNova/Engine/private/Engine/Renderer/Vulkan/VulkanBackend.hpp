@@ -2,11 +2,18 @@
 
 #include <Engine/Core/Core.hpp>
 #include <Engine/Renderer/IRendererBackend.hpp>
+#include <Engine/Renderer/Vulkan/VulkanGpuProfiler.hpp>
+#include <Engine/Renderer/Vulkan/VulkanMemoryAllocator.hpp>
+#include <Engine/Renderer/Vulkan/VulkanUploadQueue.hpp>
+#include <Engine/Utils/Hash.hpp>
 
 #include <glm/ext/matrix_float4x4.hpp>
 #include <vulkan/vulkan.h>
 
+#include <mutex>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 
 namespace snv
@@ -14,30 +21,74 @@ namespace snv
 
 class VulkanBackend final : public IRendererBackend
 {
-    static const ui32 k_BackBufferFrames      = 3;
-    static const ui32 k_MaxTextureDescriptors = 300;
-
+    // NOTE(v.matushkin): Upper bound of SwapchainDesc::FramesInFlight, per frame resources are sized by it.
+    //  Swapchain images are separate, the surface decides how many there are
+    static const ui32 k_MaxFramesInFlight     = 3;
+    static const ui32 k_MaxSwapchainImages    = 8;
+    // NOTE(v.matushkin): Size of the bindless texture array, clamped to maxDescriptorSetUpdateAfterBindSampledImages
+    static const ui32 k_MaxTextureDescriptors = 16384;
+    static const ui32 k_MaxDrawsPerFrame      = 4096;
+    // NOTE(v.matushkin): Size of the PerDraw buffer, every instance of an instanced draw takes one PerDraw
+    static const ui32 k_MaxInstancesPerFrame  = 65536;
+    // NOTE(v.matushkin): Submit() splits the direct draws into chunks that are recorded into secondary command buffers
+    //  in parallel, a chunk is never smaller than k_MinDrawsPerChunk. Secondary command buffer 0 is the geometry arena pass
+    static const ui32 k_MaxRecordingChunks    = 8;
+    static const ui32 k_MinDrawsPerChunk      = 256;
+    static const ui32 k_SecondaryCommandBufferCount = k_MaxRecordingChunks + 1;
+    // NOTE(v.matushkin): Indirect commands are grouped by the index type, UInt16 and UInt32
+    static const ui32 k_GeometryArenaIndexTypes     = 2;
+
+    static constexpr VkDeviceSize k_GeometryArenaVertexSize = 128 * 1024 * 1024;
+    static constexpr VkDeviceSize k_GeometryArenaIndexSize  = 64 * 1024 * 1024;
 
     struct VulkanBuffer
     {
-        VkBuffer Index;
-        VkBuffer Position;
-        VkBuffer Normal;
-        VkBuffer TexCoord0;
-
-        VkDeviceMemory IndexMemory;
-        VkDeviceMemory PositionMemory;
-        VkDeviceMemory NormalMemory;
-        VkDeviceMemory TexCoord0Memory;
+        VkBuffer    Index;
+        VkBuffer    Vertex;
+        VkIndexType IndexType;
+
+        VulkanAllocation IndexMemory;
+        VulkanAllocation VertexMemory;
+
+        // NOTE(v.matushkin): Every attribute has its own binding, they all point into the Vertex buffer
+        VkDeviceSize VertexOffsets[static_cast<ui8>(VertexAttribute::Count)];
+
+        // NOTE(v.matushkin): Index/Vertex are the arena buffers then, the memory is owned by the arena
+        bool         InGeometryArena;
+        i32          ArenaVertexOffset;
+        ui32         ArenaFirstIndex;
+
+        UploadSerial Upload;
+    };
+
+    // NOTE(v.matushkin): All the static meshes with an interleaved layout live in one vertex and one index buffer,
+    //  so they can be drawn with a vkCmdDrawIndexedIndirect per index type. Linear allocator, meshes are never freed
+    struct GeometryArena
+    {
+        VkBuffer         Vertex;
+        VkBuffer         Index;
+        VulkanAllocation VertexMemory;
+        VulkanAllocation IndexMemory;
+        VkDeviceSize     VertexHead;
+        VkDeviceSize     IndexHead;
+    };
+
+    struct DirectDraw
+    {
+        const VulkanBuffer* Buffer;
+        ui32                IndexCount;
+        ui32                InstanceCount;
+        ui32                PerDrawIndex; // NOTE(v.matushkin): Of the first instance
     };
 
     struct VulkanTexture
     {
-        VkImageView    View;
-        VkImage        Image;
-        VkDeviceMemory Memory;
+        VkImageView      View;
+        VkImage          Image;
+        VulkanAllocation Memory;
 
-        ui32 DescriptorSetIndex;
+        UploadSerial Upload;
+        ui32         DescriptorIndex; // NOTE(v.matushkin): Element of the bindless texture array
     };
 
     struct VulkanShader
@@ -46,6 +97,50 @@ class VulkanBackend final : public IRendererBackend
         VkShaderModule Fragment;
     };
 
+    // NOTE(v.matushkin): Everything a VkPipeline is created from, except the render pass and the pipeline layout
+    //  that are the same for every pipeline. It's hashed as raw bytes, so there must be no implicit padding
+    struct PipelineState
+    {
+        ui64          VertexLayoutHash;
+        ShaderHandle  Shader;
+        BlendFactor   SourceBlendFactor;
+        BlendFactor   DestinationBlendFactor;
+        DepthFunction DepthCompare;
+        bool          BlendEnable;
+        bool          DepthTestEnable;
+        ui8           _Padding[6];
+
+        bool operator==(const PipelineState& other) const = default;
+    };
+    static_assert(sizeof(PipelineState) == 32, "PipelineState must not have implicit padding");
+
+    // NOTE(v.matushkin): The hash only picks the bucket, the map compares the whole state, so a collision can't return
+    //  a pipeline of another state
+    struct PipelineStateHasher
+    {
+        size_t operator()(const PipelineState& pipelineState) const
+        {
+            return HashBytes(std::as_bytes(std::span(&pipelineState, 1)));
+        }
+    };
+
+    // NOTE(v.matushkin): Built by ReloadShader() on the watcher thread, swapped in by the next BeginFrame()
+    struct PendingShaderReload
+    {
+        ShaderHandle  Handle;
+        VulkanShader  Shader;
+        VkPipeline    Pipeline; // NOTE(v.matushkin): VK_NULL_HANDLE if the vertex layout wasn't known yet
+        PipelineState State;    // NOTE(v.matushkin): The Pipeline was created for
+    };
+
+    // NOTE(v.matushkin): Replaced objects that can still be used by the frames in flight
+    struct RetiredShader
+    {
+        VulkanShader            Shader;
+        std::vector<VkPipeline> Pipelines;
+        ui64                    FrameSerial; // NOTE(v.matushkin): Of the last frame that could use them
+    };
+
 
     // TODO(v.matushkin): PerFrame/PerDraw should be declared in some common header
     struct alignas(256) PerFrame
@@ -53,9 +148,13 @@ class VulkanBackend final : public IRendererBackend
         glm::mat4x4 _CameraView;
         glm::mat4x4 _CameraProjection;
     };
-    struct alignas(256) PerDraw
+    // NOTE(v.matushkin): Element of the PerDraw storage buffer array, must match the std430 layout of the struct,
+    //  draws find theirs with gl_InstanceIndex, firstInstance of every draw is its PerDraw index
+    struct PerDraw
     {
         glm::mat4x4 _ObjectToWorld;
+        ui32        _BaseColorMapIndex;
+        ui32        _Padding[3];
     };
 
 
@@ -71,7 +170,7 @@ class VulkanBackend final : public IRendererBackend
 
 
 public:
-    VulkanBackend();
+    explicit VulkanBackend(const SwapchainDesc& swapchainDesc);
     ~VulkanBackend() override;
 
     void EnableBlend() override;
@@ -84,41 +183,82 @@ public:
 
     void Clear(BufferBit bufferBitMask) override;
 
-    void BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
+    [[nodiscard]] ui32 GetFramesInFlight() const override { return m_framesInFlight; }
+    [[nodiscard]] ui32 WaitForFrameInFlight() override;
+
+    void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) override;
     void EndFrame() override;
-    void DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount) override;
+    void Submit(const RenderCommandStream& commandStream) override;
     void DrawArrays(i32 count) override;
     void DrawElements(i32 count) override;
 
     BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) override;
     TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) override;
     ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+    bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) override;
+
+    [[nodiscard]] GpuFrameStats GetGpuFrameStats() const override { return m_gpuProfiler.GetFrameStats(); }
 
 private:
     void CreateInstance();
     void CreateSurface();
     void CreateDevice();
-    void CreateSwapchain();
+    void CreateSwapchain(PresentMode preferredPresentMode);
     void CreateDepthBuffer();
     void CreateRenderPass();
     void CreateFramebuffers();
 
     void CreateUniformBuffers();
+    void CreateIndirectBuffers();
+    void CreateGeometryArena();
     void CreateTextureSampler(); // TODO(v.matushkin): This should be removed. Textures should have individual samplers
     void CreateDescriptorPool();
     void CreateDescriptorSetLayouts();
     void CreateDescriptorSets();
 
-    void CreatePipeline();
+    void CreatePipelineLayout();
+    void CreatePipelineCache();
+    void SavePipelineCache();
+    // NOTE(v.matushkin): Pipelines are created on asset load (CreateShader/CreateBuffer), by the time
+    //  of the first frame this is just a lookup
+    [[nodiscard]] VkPipeline GetOrCreatePipeline(ShaderHandle shaderHandle);
+    // NOTE(v.matushkin): Doesn't touch the members that change after the init, ReloadShader() calls it off the main thread
+    [[nodiscard]] VkPipeline CreatePipeline(const PipelineState& pipelineState, const VulkanShader& shader);
+    // NOTE(v.matushkin): Returns false if a stage failed to compile
+    [[nodiscard]] bool       CreateShaderModules(
+        std::span<const char> vertexSource,
+        std::span<const char> fragmentSource,
+        VulkanShader&         vulkanShader
+    );
+    void ApplyShaderReloads();
+    void DestroyRetiredShaders(bool destroyAll);
+    // NOTE(v.matushkin): Blocks until the GPU is done with the frame that was submitted with frameSerial
+    void WaitForFrame(ui64 frameSerial);
+
+    // NOTE(v.matushkin): Returns false if the mesh can't go to the arena, it gets its own buffers then
+    bool AllocateFromGeometryArena(
+        std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
+        std::span<const std::byte>              vertexData,
+        const std::vector<VertexAttributeDesc>& vertexLayout,
+        VulkanBuffer&                           vulkanBuffer
+    );
+
+    // NOTE(v.matushkin): Called from the recording workers, secondaryIndex owns its command pool
+    [[nodiscard]] VkCommandBuffer BeginSecondaryCommandBuffer(ui32 secondaryIndex);
+    void RecordGeometryArenaDraws(const ui32 (&indirectDrawCounts)[k_GeometryArenaIndexTypes]);
+    void RecordDirectDraws(ui32 secondaryIndex, ui32 chunkCount, std::span<const DirectDraw> directDraws);
 
     void CreateCommandPool();
     void FindMemoryTypeIndices();
     // NOTE(v.matushkin): Should be reworked, can't prerecord commandbuffer in the real world
     void CreateCommandBuffers();
+    void CreateSecondaryCommandBuffers();
     void CreateSyncronizationObjects();
 
 #ifdef SNV_GPU_API_DEBUG_ENABLED
@@ -149,58 +289,102 @@ private:
     VkDevice                 m_device;
     VkQueue                  m_graphicsQueue;
     ui32                     m_graphicsQueueFamily;
+    // NOTE(v.matushkin): pipelineStatisticsQuery and inheritedQueries are optional features
+    bool                     m_isPipelineStatisticsEnabled;
     //-- Surface
     VkSurfaceKHR             m_surface;
     VkSwapchainKHR           m_swapchain;
     VkExtent2D               m_swapchainExtent;
 
-    VkImageView              m_backBuffers[k_BackBufferFrames];
-    VkFramebuffer            m_framebuffers[k_BackBufferFrames];
+    VkImageView              m_backBuffers[k_MaxSwapchainImages];
+    VkFramebuffer            m_framebuffers[k_MaxSwapchainImages];
+    ui32                     m_swapchainImageCount;
 
     VkImage                  m_depthImage;
     VkImageView              m_depthImageView;
-    VkDeviceMemory           m_depthImageMemory;
+    VulkanAllocation         m_depthImageMemory;
 
-    ui32                     m_currentBackBufferIndex;
+    ui32                     m_currentBackBufferIndex; // NOTE(v.matushkin): Swapchain image, not the frame in flight
     //-- Pipeline
     // TODO(v.matushkin): Useless VkDescriptorSetLayout, VkPipelineLayout members? Why have them?
     //  They're only used to create VkPipeline. To reuse them?
     VkPipelineLayout         m_pipelineLayout;
     VkRenderPass             m_renderPass;
-    VkPipeline               m_graphicsPipeline;
+    VkPipeline               m_graphicsPipeline; // NOTE(v.matushkin): The one BeginFrame() picked for the current frame
+    VkPipelineCache          m_pipelineCache;
+    // NOTE(v.matushkin): Blend/depth state set through IRendererBackend, Shader and VertexLayoutHash are filled on lookup
+    PipelineState            m_pipelineState;
+    // NOTE(v.matushkin): The pipelines of a reloaded shader are found by the Shader of their PipelineState
+    std::unordered_map<PipelineState, VkPipeline, PipelineStateHasher> m_pipelines;
+    //-- Shader Hot Reload
+    // NOTE(v.matushkin): Guards m_pendingShaderReloads and m_reloadPipelineState, the state of the last frame
+    //  that ReloadShader() creates the new pipeline for
+    std::mutex               m_shaderReloadMutex;
+    std::vector<PendingShaderReload> m_pendingShaderReloads;
+    PipelineState            m_reloadPipelineState;
+    std::vector<RetiredShader> m_retiredShaders;
     //-- Command Buffers
     VkCommandPool            m_commandPool;
-    VkCommandBuffer          m_commandBuffers[k_BackBufferFrames];
+    VkCommandBuffer          m_commandBuffers[k_MaxFramesInFlight];
+    // NOTE(v.matushkin): A pool per chunk, so the workers never share a pool. A pool is reset as a whole
+    //  after the frame is waited, that is cheaper than resetting individual command buffers
+    VkCommandPool            m_secondaryCommandPools[k_MaxFramesInFlight][k_SecondaryCommandBufferCount];
+    VkCommandBuffer          m_secondaryCommandBuffers[k_MaxFramesInFlight][k_SecondaryCommandBufferCount];
+    std::vector<DirectDraw>  m_directDraws;
     //-- Syncronization Objects
-    VkSemaphore              m_semaphoreImageAvailable[k_BackBufferFrames];
-    VkSemaphore              m_semaphoreRenderFinished[k_BackBufferFrames];
-    VkFence                  m_fences[k_BackBufferFrames];
-    ui32                     m_currentFrame;
+    VkSemaphore              m_semaphoreImageAvailable[k_MaxFramesInFlight];
+    // NOTE(v.matushkin): Per swapchain image, the present of an image has to finish before the semaphore can be reused,
+    //  and that is only known once the same image is acquired again
+    VkSemaphore              m_semaphoreRenderFinished[k_MaxSwapchainImages];
+    // NOTE(v.matushkin): Every frame signals its serial, a frame in flight waits for the serial of the frame
+    //  that used its resources before
+    VkSemaphore              m_frameTimeline;
+    ui64                     m_frameSerial; // NOTE(v.matushkin): Of the last submitted frame
+    ui64                     m_frameSerials[k_MaxFramesInFlight];
+    ui32                     m_framesInFlight;
+    ui32                     m_currentFrame; // NOTE(v.matushkin): Frame in flight, [0, m_framesInFlight)
     //-- Descriptors
     VkDescriptorSetLayout    m_descriptorSetLayoutCamera;
-    VkDescriptorSetLayout    m_descriptorSetLayourMaterial;
+    VkDescriptorSetLayout    m_descriptorSetLayoutTextures;
 
     VkDescriptorPool         m_descriptorPool;
 
-    VkDescriptorSet          m_descriptorSets[k_BackBufferFrames];
-    VkDescriptorSet          m_descriptorSetMaterials[k_MaxTextureDescriptors];
+    VkDescriptorSet          m_descriptorSets[k_MaxFramesInFlight];
+    // NOTE(v.matushkin): One set for every texture, it's UPDATE_AFTER_BIND so textures can be added
+    //  while the previous frames that use it are still in flight
+    VkDescriptorSet          m_descriptorSetTextures;
+    ui32                     m_maxTextureDescriptors;
 
 #ifdef SNV_GPU_API_DEBUG_ENABLED
     VkDebugUtilsMessengerEXT m_debugMessenger;
 #endif
 
     VulkanMemoryTypeIndex    m_bufferMemoryTypeIndex;
+    VulkanMemoryAllocator    m_memoryAllocator;
+    VulkanUploadQueue        m_uploadQueue;
+    VulkanGpuProfiler        m_gpuProfiler;
 
     VkSampler                m_sampler;
 
-    VkBuffer                 m_ubPerFrame[k_BackBufferFrames];
-    VkBuffer                 m_ubPerDraw[k_BackBufferFrames];
-    VkDeviceMemory           m_ubPerFrameMemory[k_BackBufferFrames];
-    VkDeviceMemory           m_ubPerDrawMemory[k_BackBufferFrames];
+    VkBuffer                 m_ubPerFrame[k_MaxFramesInFlight];
+    VkBuffer                 m_sbPerDraw[k_MaxFramesInFlight];
+    // NOTE(v.matushkin): Persistently mapped through the allocator, the memory is HOST_COHERENT so there is no need to flush
+    VulkanAllocation         m_ubPerFrameMemory[k_MaxFramesInFlight];
+    VulkanAllocation         m_sbPerDrawMemory[k_MaxFramesInFlight];
+    ui32                     m_perDrawCount; // NOTE(v.matushkin): Linear allocator in the current m_sbPerDraw
+    // NOTE(v.matushkin): k_MaxDrawsPerFrame VkDrawIndexedIndirectCommand for every index type, written in Submit()
+    VkBuffer                 m_indirectBuffers[k_MaxFramesInFlight];
+    VulkanAllocation         m_indirectBufferMemory[k_MaxFramesInFlight];
+
+    GeometryArena            m_geometryArena;
 
 
     VkClearValue             m_clearValues[2]; // 0 - color, 1 - depth
 
+    // NOTE(v.matushkin): There is only one pipeline, its vertex input is built from the layout of the first buffer,
+    //  every other buffer must have the same vertex format
+    std::vector<VertexAttributeDesc> m_vertexLayout;
+
     std::unordered_map<BufferHandle,  VulkanBuffer>  m_buffers;
     std::unordered_map<TextureHandle, VulkanTexture> m_textures;
     std::unordered_map<ShaderHandle,  VulkanShader>  m_shaders;
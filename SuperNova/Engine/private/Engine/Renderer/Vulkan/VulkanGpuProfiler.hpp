@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <span>
+
+
+// NOTE(v.matushkin): GPU timings with timestamp queries, vertex/fragment invocations with a pipeline statistics query.
+//  Every frame in flight has its own range of queries. The range is read back when the frame slot comes around again,
+//  VulkanBackend has waited for the frame by then, so vkGetQueryPoolResults never blocks.
+//  Passes are fixed and named by the backend, a pass that wasn't written in a frame is just not reported.
+
+
+namespace snv
+{
+
+class VulkanGpuProfiler
+{
+    static const ui32 k_MaxFramesInFlight  = 3;
+    // NOTE(v.matushkin): Begin/End of the frame, then Begin/End of every pass
+    static const ui32 k_TimestampsPerFrame = 2 + 2 * k_MaxGpuPasses;
+
+    static constexpr VkQueryPipelineStatisticFlags k_PipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+                                                                        | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+public:
+    // NOTE(v.matushkin): pipelineStatisticsEnabled means the device was created with pipelineStatisticsQuery
+    //  and inheritedQueries, the query stays active while the secondary command buffers execute
+    void Init(
+        VkPhysicalDevice             physicalDevice,
+        VkDevice                     device,
+        ui32                         queueFamily,
+        ui32                         framesInFlight,
+        bool                         pipelineStatisticsEnabled,
+        std::span<const char* const> passNames
+    );
+    void Shutdown();
+
+    // NOTE(v.matushkin): The GPU must be done with the previous frame of this frame in flight.
+    //  Both are recorded into the primary command buffer outside of the render pass
+    void BeginFrame(VkCommandBuffer commandBuffer, ui32 frameIndex);
+    void EndFrame(VkCommandBuffer commandBuffer);
+
+    // NOTE(v.matushkin): Can be recorded into secondary command buffers on the recording workers,
+    //  Begin and End of a pass can go into different command buffers
+    void BeginPass(VkCommandBuffer commandBuffer, ui32 passIndex) const;
+    void EndPass(VkCommandBuffer commandBuffer, ui32 passIndex) const;
+
+    // NOTE(v.matushkin): For VkCommandBufferInheritanceInfo::pipelineStatistics of the secondary command buffers
+    [[nodiscard]] VkQueryPipelineStatisticFlags GetPipelineStatistics() const { return m_isPipelineStatisticsEnabled ? k_PipelineStatistics : 0; }
+    [[nodiscard]] const GpuFrameStats&          GetFrameStats() const { return m_frameStats; }
+
+private:
+    void ReadFrameQueries(ui32 frameIndex);
+    [[nodiscard]] f32 GetMilliseconds(ui64 beginTimestamp, ui64 endTimestamp) const;
+
+private:
+    VkDevice         m_device;
+
+    VkQueryPool      m_timestampPool;
+    VkQueryPool      m_pipelineStatisticsPool;
+    bool             m_isTimestampEnabled;
+    bool             m_isPipelineStatisticsEnabled;
+
+    f32              m_timestampPeriod; // NOTE(v.matushkin): Nanoseconds per timestamp tick
+    ui64             m_timestampMask;   // NOTE(v.matushkin): Of the timestampValidBits
+
+    const char*      m_passNames[k_MaxGpuPasses];
+    ui32             m_passCount;
+
+    bool             m_isFrameRecorded[k_MaxFramesInFlight]; // NOTE(v.matushkin): Has queries to read back
+    ui32             m_currentFrame;
+
+    GpuFrameStats    m_frameStats;
+};
+
+} // namespace snv
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+
+// NOTE(v.matushkin): Every resource used to get its own VkDeviceMemory, which for Sponza means thousands of allocations,
+//  and drivers only guarantee maxMemoryAllocationCount (4096 on a lot of them).
+//  Now memory is allocated in big blocks per memory type and resources are placed in aligned ranges of them.
+//  Buffers and images never share a block, so bufferImageGranularity doesn't have to be handled.
+//  Blocks of HOST_VISIBLE memory types are mapped once on creation, VulkanAllocation::MappedData points into them.
+
+
+namespace snv
+{
+
+enum class VulkanResourceKind : ui8
+{
+    Buffer, // NOTE(v.matushkin): And linear images
+    Image,  // NOTE(v.matushkin): Optimal tiling images
+
+    Count
+};
+
+
+struct VulkanAllocation
+{
+    VkDeviceMemory     Memory;
+    VkDeviceSize       Offset;
+    VkDeviceSize       Size;
+    void*              MappedData; // NOTE(v.matushkin): Already offset, nullptr if the memory type is not HOST_VISIBLE
+    ui32               MemoryTypeIndex;
+    ui32               BlockIndex;
+    VulkanResourceKind Kind;
+};
+
+struct VulkanMemoryStats
+{
+    ui32 BlockCount;
+    ui32 AllocationCount;
+    ui64 BytesReserved;    // NOTE(v.matushkin): Sum of the VkDeviceMemory block sizes
+    ui64 BytesUsed;        // NOTE(v.matushkin): Sum of the allocation sizes, alignment padding is counted as free
+    ui32 FreeRangeCount;
+    ui64 LargestFreeRange;
+    // NOTE(v.matushkin): 1 - sum(largest free range of a block) / (BytesReserved - BytesUsed),
+    //  0 means every block has all of its free memory in one range
+    f32  Fragmentation;
+};
+
+
+class VulkanMemoryAllocator
+{
+    static constexpr VkDeviceSize k_BlockSize = 64 * 1024 * 1024;
+
+    struct FreeRange
+    {
+        VkDeviceSize Offset;
+        VkDeviceSize Size;
+    };
+
+    struct MemoryBlock
+    {
+        VkDeviceMemory         Memory;
+        VkDeviceSize           Size;
+        VkDeviceSize           UsedSize;
+        void*                  MappedData;
+        ui32                   AllocationCount;
+        // NOTE(v.matushkin): Sorted by offset, adjacent ranges are always merged
+        std::vector<FreeRange> FreeRanges;
+    };
+
+public:
+    void Init(VkPhysicalDevice physicalDevice, VkDevice device);
+    void Shutdown();
+
+    // NOTE(v.matushkin): Allocates and binds the memory
+    [[nodiscard]] VulkanAllocation AllocateBuffer(VkBuffer buffer, ui32 memoryTypeIndex);
+    [[nodiscard]] VulkanAllocation AllocateImage(VkImage image, ui32 memoryTypeIndex);
+    void Free(const VulkanAllocation& allocation);
+
+    [[nodiscard]] VulkanMemoryStats GetStats() const;
+    void LogStats() const;
+
+private:
+    [[nodiscard]] VulkanAllocation Allocate(
+        const VkMemoryRequirements& vkMemoryRequirements,
+        ui32                        memoryTypeIndex,
+        VulkanResourceKind          resourceKind
+    );
+    [[nodiscard]] ui32 CreateBlock(std::vector<MemoryBlock>& blocks, VkDeviceSize blockSize, ui32 memoryTypeIndex);
+
+private:
+    VkDevice                         m_device;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties;
+    ui32                             m_maxAllocationCount;
+    ui32                             m_deviceAllocationCount;
+
+    std::vector<MemoryBlock>         m_blocks[VK_MAX_MEMORY_TYPES][static_cast<ui8>(VulkanResourceKind::Count)];
+};
+
+} // namespace snv
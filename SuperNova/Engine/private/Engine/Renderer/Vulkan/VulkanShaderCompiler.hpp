@@ -9,6 +9,9 @@
 namespace snv::VulkanShaderCompiler
 {
 
+// NOTE(v.matushkin): First word of every SPIR-V module, GLSL text can't start with it
+inline constexpr ui32 k_SpirvMagicNumber = 0x07230203;
+
 // Values corresponds to EShLanguage
 enum class ShaderType : ui32
 {
@@ -21,5 +24,8 @@ void Init();
 void Shutdown();
 
 std::vector<ui32> CompileShader(ShaderType shaderType, std::span<const char> shaderSource);
+// NOTE(v.matushkin): SPIRV-Tools performance passes, too slow for the runtime, used by the offline SuperNovaShaderCompiler.
+//  Returns the input as is if the optimizer failed.
+std::vector<ui32> OptimizeShader(std::span<const ui32> spirvBytecode);
 
 } // namespace snv::VulkanShaderCompiler
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+#include <Engine/Renderer/Vulkan/VulkanMemoryAllocator.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <span>
+#include <vector>
+
+
+// NOTE(v.matushkin): CreateBuffer/CreateTexture used to record a command buffer, submit it and vkQueueWaitIdle
+//  for every resource. Now the data is copied into a persistently mapped staging ring, the copies are recorded into
+//  the current batch, and the batch is submitted when it gets big enough or at the beginning of the frame.
+//  Every batch signals a timeline semaphore with its serial, a resource is usable once its serial has retired.
+//  Everything goes to the graphics queue, so there are no queue family ownership transfers to worry about.
+
+
+namespace snv
+{
+
+// NOTE(v.matushkin): Serial 0 is always retired, can be used for resources that don't need an upload
+using UploadSerial = ui64;
+
+
+struct VulkanUploadStats
+{
+    ui32 Submissions;
+    ui32 Uploads;
+    ui64 BytesUploaded;
+    ui32 RingStalls; // NOTE(v.matushkin): How many times the CPU had to wait for the GPU to free the staging ring
+};
+
+
+class VulkanUploadQueue
+{
+    static constexpr VkDeviceSize k_StagingRingSize = 64 * 1024 * 1024;
+    // NOTE(v.matushkin): Submit the batch once it has this much data, so the GPU can start working during loading
+    static constexpr VkDeviceSize k_BatchSubmitSize = 16 * 1024 * 1024;
+    // NOTE(v.matushkin): Must be a multiple of every texel size and 4, see VkBufferImageCopy::bufferOffset
+    static constexpr VkDeviceSize k_StagingAlignment = 16;
+    static const ui32             k_MaxBatches       = 8;
+
+    struct Batch
+    {
+        VkCommandBuffer               CommandBuffer;
+        UploadSerial                  Serial;
+        ui64                          RingHead; // NOTE(v.matushkin): Ring tail moves here when the batch retires
+        bool                          HasBufferCopies;
+        // NOTE(v.matushkin): For the data that doesn't fit in the ring
+        std::vector<VkBuffer>         DedicatedBuffers;
+        std::vector<VulkanAllocation> DedicatedMemory;
+    };
+
+    struct StagingRange
+    {
+        VkBuffer     Buffer;
+        VkDeviceSize Offset;
+    };
+
+public:
+    void Init(
+        VkDevice               device,
+        VkQueue                queue,
+        ui32                   queueFamily,
+        VulkanMemoryAllocator* memoryAllocator,
+        ui32                   stagingMemoryTypeIndex
+    );
+    // NOTE(v.matushkin): Waits for all the batches
+    void Shutdown();
+
+    // NOTE(v.matushkin): Data is copied right away, the returned serial is the batch that will do the GPU copy
+    [[nodiscard]] UploadSerial UploadBuffer(VkBuffer buffer, VkDeviceSize bufferOffset, std::span<const std::byte> data);
+    // NOTE(v.matushkin): textureData holds all the mips, the image ends up in SHADER_READ_ONLY_OPTIMAL layout
+    [[nodiscard]] UploadSerial UploadTexture(VkImage image, const TextureDesc& textureDesc, const ui8* textureData);
+
+    // NOTE(v.matushkin): Submits the current batch if it has anything in it
+    void Submit();
+    // NOTE(v.matushkin): Polls the timeline semaphore and releases the staging memory of the finished batches
+    void Retire();
+
+    [[nodiscard]] bool IsRetired(UploadSerial serial) const { return serial <= m_retiredSerial; }
+    [[nodiscard]] const VulkanUploadStats& GetStats() const { return m_stats; }
+
+private:
+    [[nodiscard]] Batch& GetRecordingBatch();
+    [[nodiscard]] StagingRange Stage(const void* data, VkDeviceSize size);
+    void SubmitIfFull();
+    void WaitOldestBatch();
+
+private:
+    VkDevice               m_device;
+    VkQueue                m_queue;
+    VulkanMemoryAllocator* m_memoryAllocator;
+    ui32                   m_stagingMemoryTypeIndex;
+
+    VkCommandPool          m_commandPool;
+    VkSemaphore            m_timelineSemaphore;
+
+    VkBuffer               m_stagingRing;
+    VulkanAllocation       m_stagingRingMemory;
+    // NOTE(v.matushkin): Monotonic byte positions, (position % k_StagingRingSize) is the offset in the ring
+    ui64                   m_ringHead;
+    ui64                   m_ringTail;
+
+    // NOTE(v.matushkin): FIFO, m_batches[m_firstBatch] is the oldest in flight, the recording one goes after the last
+    Batch                  m_batches[k_MaxBatches];
+    ui32                   m_firstBatch;
+    ui32                   m_batchesInFlight;
+    bool                   m_isRecording;
+    VkDeviceSize           m_recordingBatchSize;
+
+    UploadSerial           m_submittedSerial;
+    UploadSerial           m_retiredSerial;
+
+    VulkanUploadStats      m_stats;
+};
+
+} // namespace snv
@@ -11,6 +11,7 @@ namespace snv
 class Model;
 class Texture;
 class Shader;
+class ShaderWatcher;
 
 using ModelPtr   = std::shared_ptr<Model>;
 using TexturePtr = std::shared_ptr<Texture>;
@@ -27,18 +28,29 @@ class AssetDatabase
 
 public:
     static void Init(std::string assetDirectory);
+    static void Shutdown();
+
+    // NOTE(v.matushkin): Only the shaders loaded after this call are watched
+    static void EnableShaderHotReload();
 
     template<class T>
     [[nodiscard]] static std::shared_ptr<T> LoadAsset(const std::string& assetPath);
 
 private:
-    [[nodiscard]] static Model   LoadModel(const std::string& modelName);
-    [[nodiscard]] static Texture LoadTexture(const std::string& texturePath);
-    [[nodiscard]] static Shader  LoadShader(const std::string& shaderName);
+    [[nodiscard]] static Model      LoadModel(const std::string& modelName);
+    // NOTE(v.matushkin): texturePath is relative to the models directory, like the material textures of a model.
+    //  Returns the black texture if the source can't be read
+    [[nodiscard]] static TexturePtr LoadTexture(const std::string& texturePath);
+    [[nodiscard]] static Shader     LoadShader(const std::string& shaderName);
+
+    // NOTE(v.matushkin): Without the stage suffix and the extension
+    [[nodiscard]] static std::string GetShaderPath(const std::string& shaderName);
+    [[nodiscard]] static const char* GetShaderExtension();
 
 private:
     static inline std::string m_assetDir;
     static inline std::string m_modelDir;
+    static inline std::string m_cacheDir;
     static inline std::string m_glShaderDir;
     static inline std::string m_vkShaderDir;
     static inline std::string m_dxShaderDir;
@@ -46,6 +58,8 @@ private:
     static inline Models    m_models;
     static inline Textures  m_textures;
     static inline ShaderPtr m_theOneAndOnlyForNow;
+
+    static inline ShaderWatcher* m_shaderWatcher = nullptr;
 };
 
 } // namespace snv
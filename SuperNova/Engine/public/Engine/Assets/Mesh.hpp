@@ -3,7 +3,8 @@
 #include <Engine/Core/Core.hpp>
 #include <Engine/Renderer/RenderTypes.hpp>
 
-#include <memory>
+#include <cstddef>
+#include <span>
 #include <vector>
 
 
@@ -13,10 +14,15 @@ namespace snv
 class Mesh
 {
 public:
+    // NOTE(v.matushkin): The data is only used to create the GPU buffer, Mesh doesn't keep it,
+    //  so it can point straight into a memory mapped file
     Mesh(
-        i32 indexCount, std::unique_ptr<ui32[]>&& indexData,
-        i32 vertexCount, std::unique_ptr<ui8[]>&& vertexData,
-        const std::vector<VertexAttributeDesc>& vertexLayout
+        std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
+        i32                                     vertexCount,
+        std::span<const std::byte>              vertexData,
+        const std::vector<VertexAttributeDesc>& vertexLayout,
+        const AABB&                             bounds
     );
 
     Mesh(Mesh&& other) noexcept;
@@ -27,16 +33,15 @@ public:
 
     [[nodiscard]] i32 GetIndexCount()  const { return m_indexCount; }
     [[nodiscard]] i32 GetVertexCount() const { return m_vertexCount; }
+    [[nodiscard]] const AABB&  GetBounds() const { return m_bounds; }
     [[nodiscard]] BufferHandle GetHandle() const { return m_bufferHandle; }
 
 private:
-    std::unique_ptr<ui32[]> m_indexData;
-    std::unique_ptr<ui8[]>  m_vertexData;
+    i32          m_indexCount;
+    i32          m_vertexCount;
+    AABB         m_bounds;
 
-    i32                     m_indexCount;
-    i32                     m_vertexCount;
-
-    BufferHandle            m_bufferHandle;
+    BufferHandle m_bufferHandle;
 };
 
 } // namespace snv
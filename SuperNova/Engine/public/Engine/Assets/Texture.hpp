@@ -3,6 +3,7 @@
 #include <Engine/Renderer/RenderTypes.hpp>
 
 #include <memory>
+#include <span>
 
 
 namespace snv
@@ -11,7 +12,9 @@ namespace snv
 class Texture
 {
 public:
-    Texture(const TextureDesc& textureDesc, std::unique_ptr<ui8[]>&& textureData);
+    // NOTE(v.matushkin): The data is only used to create the GPU texture, Texture doesn't keep it,
+    //  so it can point straight into a memory mapped file
+    Texture(const TextureDesc& textureDesc, std::span<const ui8> textureData);
 
     Texture(Texture&& other) noexcept;
     Texture& operator=(Texture&& other) noexcept;
@@ -26,9 +29,7 @@ public:
     [[nodiscard]] static std::shared_ptr<Texture> GetNormalTexture();
 
 private:
-    std::unique_ptr<ui8[]> m_textureData;
-
-    TextureHandle          m_textureHandle;
+    TextureHandle m_textureHandle;
 };
 
 } // namespace snv
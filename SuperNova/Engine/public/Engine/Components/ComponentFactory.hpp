@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Engine/Components/Component.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
 
 #include <entt/entity/registry.hpp>
 #include <entt/entity/view.hpp>
@@ -26,6 +27,8 @@ public:
     template<Component T, typename... Args>
     static T& AddComponent(const entt::entity entity, GameObject* gameObject, Args&&... args)
     {
+        MEMORY_TAG_SCOPE(MemoryTag::ECS);
+
         return m_registry.emplace<T>(entity, gameObject, std::forward<Args>(args)...);
     }
 
@@ -17,8 +17,9 @@ class MeshRenderer final : public BaseComponent
 public:
     MeshRenderer(GameObject* gameObject, std::shared_ptr<Material> material, std::shared_ptr<Mesh> mesh);
 
-    [[nodiscard]] std::shared_ptr<Material> GetMaterial() const { return m_material; }
-    [[nodiscard]] std::shared_ptr<Mesh>     GetMesh()     const { return m_mesh; }
+    // NOTE(v.matushkin): By reference, the Renderer calls them for every object every frame
+    [[nodiscard]] const std::shared_ptr<Material>& GetMaterial() const { return m_material; }
+    [[nodiscard]] const std::shared_ptr<Mesh>&     GetMesh()     const { return m_mesh; }
 
 private:
     std::shared_ptr<Material> m_material;
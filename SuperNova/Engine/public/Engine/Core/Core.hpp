@@ -24,4 +24,6 @@ using f64 = double;
     #define SNV_LOGGING_ENABLED
     #define SNV_ASSERTS_ENABLED
     #define SNV_GPU_API_DEBUG_ENABLED
+    #define SNV_PROFILING_ENABLED
+    #define SNV_MEMORY_TRACKING_ENABLED
 #endif // SNV_ENABLE_DEBUG
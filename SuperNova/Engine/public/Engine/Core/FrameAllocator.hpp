@@ -0,0 +1,126 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+
+// NOTE(v.matushkin): Bump allocation for the data that only lives for a frame. Allocate() is a single atomic add,
+//  so any thread can allocate from the same arena, nothing is freed individually, the whole arena is reset at once.
+//  FrameAllocator has an arena for every frame in flight, the memory of a frame stays valid until the same
+//  frame in flight comes around again and its fence has signaled, so it can be handed to the GPU side of the frame too.
+//  When an arena runs out, the allocations go to the heap until the next Reset(), which grows the arena
+//  to fit the whole frame, so a steady state frame never touches the heap.
+
+
+namespace snv
+{
+
+class LinearArena
+{
+public:
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+
+    LinearArena(LinearArena&& other) = delete;
+    LinearArena& operator=(LinearArena&& other) = delete;
+
+    LinearArena(const LinearArena& other) = delete;
+    LinearArena& operator=(const LinearArena& other) = delete;
+
+    // NOTE(v.matushkin): Thread safe, alignment must be a power of 2
+    [[nodiscard]] void* Allocate(size_t size, size_t alignment);
+    // NOTE(v.matushkin): Not thread safe, nothing may allocate from the arena or use its memory anymore
+    void Reset();
+
+    [[nodiscard]] size_t GetCapacity() const { return m_capacity; }
+    // NOTE(v.matushkin): Including the alignment padding and the overflowed allocations
+    [[nodiscard]] size_t GetUsedBytes() const { return m_offset.load(std::memory_order_relaxed); }
+
+private:
+    [[nodiscard]] void* AllocateOverflow(size_t size, size_t alignment);
+
+private:
+    std::byte*          m_memory;
+    size_t              m_capacity;
+    std::atomic<size_t> m_offset;
+
+    std::mutex          m_overflowMutex;
+    std::vector<void*>  m_overflowBlocks;
+};
+
+
+class FrameAllocator
+{
+public:
+    static void Init(ui32 framesInFlight, size_t arenaCapacity);
+    static void Shutdown();
+
+    // NOTE(v.matushkin): Resets the arena of frameIndex and makes it current, the caller makes sure that nothing
+    //  uses the memory of that frame anymore, i.e. its fence has signaled
+    static void BeginFrame(ui32 frameIndex);
+
+    [[nodiscard]] static LinearArena& GetArena() { return *s_currentArena; }
+
+    [[nodiscard]] static void* Allocate(size_t size, size_t alignment) { return s_currentArena->Allocate(size, alignment); }
+
+    // NOTE(v.matushkin): Uninitialized, so only for trivial types
+    template<typename T>
+    [[nodiscard]] static std::span<T> AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Frame memory is never destructed");
+        return std::span(static_cast<T*>(Allocate(count * sizeof(T), alignof(T))), count);
+    }
+
+private:
+    static inline std::vector<std::unique_ptr<LinearArena>> s_arenas;
+    static inline LinearArena*                              s_currentArena = nullptr;
+};
+
+
+// NOTE(v.matushkin): STL adapter, deallocate() does nothing, the memory goes back with LinearArena::Reset().
+//  Containers must not outlive the arena reset, for FrameAllocator::GetArena() it's the end of the frame.
+//  A growing container leaves its old buffers in the arena, reserve() when the size is known.
+template<typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    // NOTE(v.matushkin): Not explicit, so a container can be constructed straight from the arena
+    ArenaAllocator(LinearArena& arena) noexcept
+        : m_arena(&arena)
+    {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : m_arena(other.m_arena)
+    {}
+
+    [[nodiscard]] T* allocate(size_t count)
+    {
+        return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* memory, size_t count) noexcept
+    {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_arena == other.m_arena; }
+
+private:
+    template<typename U>
+    friend class ArenaAllocator;
+
+    LinearArena* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace snv
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// NOTE(v.matushkin): Work stealing job system. Every thread has its own deque of jobs, it pushes and pops
+//  its jobs at the bottom and, when it runs out of them, steals from the top of the others.
+//  The thread that called Init() is thread 0 and runs jobs too while it Wait()s, the workers are the rest.
+//  Jobs are allocated from a per thread ring, the callable is stored inside of the Job, so nothing
+//  is allocated after Init(). A job is finished when it and all of its children are finished,
+//  so waiting for a parent waits for the whole tree.
+//  Jobs can only be created from the thread 0 and from the jobs themselves.
+
+
+namespace snv
+{
+
+class JobSystem;
+
+
+class Job
+{
+    static const ui32 k_DataSize = 104;
+
+    using Function = void (*)(Job& job);
+
+private:
+    friend class JobSystem;
+
+    alignas(16) std::byte m_data[k_DataSize]; // NOTE(v.matushkin): The callable
+    Function              m_function;
+    Job*                  m_parent;
+    std::atomic<ui32>     m_unfinishedJobs;   // NOTE(v.matushkin): 1 for itself + the unfinished children
+};
+static_assert(sizeof(Job) == 128, "Keep the Job 2 cache lines");
+
+
+class JobSystem
+{
+    // NOTE(v.matushkin): ParallelFor() splits the range into at most this many jobs per thread,
+    //  so there is something to steal when the work isn't even
+    static const ui32 k_ParallelForJobsPerThread = 4;
+
+public:
+    // NOTE(v.matushkin): workerCount == 0 means one worker per hardware thread, except for the calling one
+    static void Init(ui32 workerCount = 0);
+    // NOTE(v.matushkin): Every job must be finished
+    static void Shutdown();
+
+    // NOTE(v.matushkin): Workers + the thread 0
+    [[nodiscard]] static ui32 GetThreadCount();
+
+    // NOTE(v.matushkin): func() is called once with no arguments, its captures must fit in the Job.
+    //  The job doesn't start until it's Run()
+    template<typename Func>
+    [[nodiscard]] static Job* CreateJob(Func&& func)
+    {
+        return EmplaceJob(nullptr, std::forward<Func>(func));
+    }
+    // NOTE(v.matushkin): The parent isn't finished until the child is, the child must be created
+    //  before the parent has finished
+    template<typename Func>
+    [[nodiscard]] static Job* CreateChildJob(Job* parent, Func&& func)
+    {
+        return EmplaceJob(parent, std::forward<Func>(func));
+    }
+
+    static void Run(Job* job);
+    // NOTE(v.matushkin): Runs other jobs until this one and its children are finished
+    static void Wait(const Job* job);
+    [[nodiscard]] static bool IsFinished(const Job* job);
+
+    // NOTE(v.matushkin): Calls func(i) for every i in [0, count) on any thread, blocks until all of them are done
+    template<typename Func>
+    static void ParallelFor(ui32 count, Func&& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        const auto jobCount  = std::min(count, GetThreadCount() * k_ParallelForJobsPerThread);
+        const auto batchSize = (count + jobCount - 1) / jobCount;
+
+        const auto rootJob = CreateJob([] {});
+        for (ui32 begin = 0; begin < count; begin += batchSize)
+        {
+            const auto end = std::min(begin + batchSize, count);
+            Run(CreateChildJob(rootJob, [&func, begin, end] {
+                for (auto i = begin; i < end; ++i)
+                {
+                    func(i);
+                }
+            }));
+        }
+        Run(rootJob);
+        Wait(rootJob);
+    }
+
+private:
+    template<typename Func>
+    [[nodiscard]] static Job* EmplaceJob(Job* parent, Func&& func)
+    {
+        using Callable = std::decay_t<Func>;
+        static_assert(sizeof(Callable) <= Job::k_DataSize, "Job captures are too big, capture a pointer to them instead");
+        static_assert(alignof(Callable) <= alignof(Job), "Job captures are overaligned");
+
+        auto job = AllocateJob(parent);
+        new (job->m_data) Callable(std::forward<Func>(func));
+        job->m_function = [](Job& job) {
+            auto& callable = *std::launder(reinterpret_cast<Callable*>(job.m_data));
+            callable();
+            callable.~Callable();
+        };
+
+        return job;
+    }
+
+    [[nodiscard]] static Job* AllocateJob(Job* parent);
+    static void               Execute(Job& job);
+    // NOTE(v.matushkin): Finishes the parents that were only waiting for this job too
+    static void               Finish(Job* job);
+
+    static void WorkerLoop(ui32 threadIndex);
+};
+
+} // namespace snv
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <cstddef>
+
+
+// NOTE(v.matushkin): CPU heap accounting. With SNV_MEMORY_TRACKING_ENABLED the global operator new/delete go through
+//  MemoryTracker::Allocate()/Free(), every allocation is attributed to the tag of the innermost MEMORY_TAG_SCOPE()
+//  of the allocating thread. The tag and the size are stored in a header in front of the block, so it's freed
+//  from the right tag on any thread, the aligned forms of operator new are tracked too. Allocations that bypass
+//  operator new (malloc, drivers, third party allocators) are not seen, unless the library can be pointed
+//  at MemoryTracker::Allocate().
+//  Without SNV_MEMORY_TRACKING_ENABLED nothing is replaced and all the stats are 0.
+
+
+namespace snv
+{
+
+enum class MemoryTag : ui8
+{
+    Untagged,
+    Assets,    // NOTE(v.matushkin): Asset objects and the AssetDatabase itself
+    Renderer,  // NOTE(v.matushkin): Renderer frontend and backends, except the GPU memory
+    ECS,       // NOTE(v.matushkin): Entities and components
+    Transient, // NOTE(v.matushkin): Short lived data, import buffers, per frame scratch memory
+
+    Count
+};
+
+enum class HeapAllocationGuardMode : ui8
+{
+    Count,  // NOTE(v.matushkin): Only count the allocations
+    Assert, // NOTE(v.matushkin): Assert on the first allocation of the thread that created the guard
+};
+
+
+struct MemoryTagStats
+{
+    ui64 CurrentBytes;
+    ui64 PeakBytes;
+    ui64 CurrentAllocations;
+    ui64 TotalAllocations;
+};
+
+
+class MemoryTracker
+{
+public:
+    // NOTE(v.matushkin): malloc/realloc/free that are accounted to the current tag, for the C libraries
+    //  that take custom allocation functions. Memory from them must only be freed with Free()
+    [[nodiscard]] static void* Allocate(size_t size);
+    [[nodiscard]] static void* Reallocate(void* memory, size_t size);
+    static void                Free(void* memory);
+
+    [[nodiscard]] static MemoryTag GetCurrentTag();
+    static void                    SetCurrentTag(MemoryTag tag);
+
+    [[nodiscard]] static MemoryTagStats GetTagStats(MemoryTag tag);
+    [[nodiscard]] static const char*    GetTagName(MemoryTag tag);
+    static void                         LogTagStats();
+
+    // NOTE(v.matushkin): Allocations of all threads since the start
+    [[nodiscard]] static ui64 GetHeapAllocationCount();
+
+    static void SetHeapAllocationGuardMode(HeapAllocationGuardMode guardMode);
+
+private:
+    friend class HeapAllocationGuard;
+
+    static bool BeginHeapAllocationGuard();
+    static void EndHeapAllocationGuard(bool wasAllocationForbidden);
+};
+
+
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(MemoryTag tag)
+        : m_previousTag(MemoryTracker::GetCurrentTag())
+    {
+        MemoryTracker::SetCurrentTag(tag);
+    }
+    ~MemoryTagScope() { MemoryTracker::SetCurrentTag(m_previousTag); }
+
+    MemoryTagScope(MemoryTagScope&& other) = delete;
+    MemoryTagScope& operator=(MemoryTagScope&& other) = delete;
+
+    MemoryTagScope(const MemoryTagScope& other) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope& other) = delete;
+
+private:
+    MemoryTag m_previousTag;
+};
+
+
+// NOTE(v.matushkin): Marks a scope that should not allocate, like a steady state frame.
+//  Counts the allocations of all threads while it's alive, other threads that are not part of the frame
+//  (asset loading, shader hot reload) are counted too. Guards can nest.
+class HeapAllocationGuard
+{
+public:
+    HeapAllocationGuard()
+        : m_startAllocationCount(MemoryTracker::GetHeapAllocationCount())
+        , m_wasAllocationForbidden(MemoryTracker::BeginHeapAllocationGuard())
+    {}
+    ~HeapAllocationGuard() { MemoryTracker::EndHeapAllocationGuard(m_wasAllocationForbidden); }
+
+    HeapAllocationGuard(HeapAllocationGuard&& other) = delete;
+    HeapAllocationGuard& operator=(HeapAllocationGuard&& other) = delete;
+
+    HeapAllocationGuard(const HeapAllocationGuard& other) = delete;
+    HeapAllocationGuard& operator=(const HeapAllocationGuard& other) = delete;
+
+    [[nodiscard]] ui64 GetAllocationCount() const { return MemoryTracker::GetHeapAllocationCount() - m_startAllocationCount; }
+
+private:
+    ui64 m_startAllocationCount;
+    bool m_wasAllocationForbidden;
+};
+
+} // namespace snv
+
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+    #define SNV_MEMORY_CONCAT_IMPL(a, b) a##b
+    #define SNV_MEMORY_CONCAT(a, b)      SNV_MEMORY_CONCAT_IMPL(a, b)
+
+    #define MEMORY_TAG_SCOPE(tag) ::snv::MemoryTagScope SNV_MEMORY_CONCAT(memoryTagScope, __LINE__)(tag)
+#else
+    #define MEMORY_TAG_SCOPE(tag)
+#endif
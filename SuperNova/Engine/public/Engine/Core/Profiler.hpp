@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <string>
+
+
+// NOTE(v.matushkin): CPU profiling zones. Every thread records the begin/end events of its zones into its own
+//  ring buffer, so recording is lock-free and never allocates after the first zone of a thread.
+//  Nothing is aggregated while running, a capture window is dumped in the Chrome trace format
+//  (chrome://tracing, ui.perfetto.dev) with Profiler::BeginCapture()/EndCapture().
+//  Zone and thread names are not copied, they must be string literals.
+
+
+namespace snv
+{
+
+class Profiler
+{
+public:
+    static void BeginZone(const char* zoneName);
+    static void EndZone();
+    static void SetThreadName(const char* threadName);
+
+    static void BeginCapture();
+    [[nodiscard]] static bool IsCapturing();
+    // NOTE(v.matushkin): Writes the zones since BeginCapture(), the ones that were pushed out of the ring buffers are lost.
+    //  Zones that are still open are closed at the end of the capture. Returns false if the file can't be written
+    static bool EndCapture(const std::string& filePath);
+};
+
+
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* zoneName) { Profiler::BeginZone(zoneName); }
+    ~ProfileZone() { Profiler::EndZone(); }
+
+    ProfileZone(ProfileZone&& other) = delete;
+    ProfileZone& operator=(ProfileZone&& other) = delete;
+
+    ProfileZone(const ProfileZone& other) = delete;
+    ProfileZone& operator=(const ProfileZone& other) = delete;
+};
+
+} // namespace snv
+
+
+#ifdef SNV_PROFILING_ENABLED
+    #define SNV_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define SNV_PROFILE_CONCAT(a, b)      SNV_PROFILE_CONCAT_IMPL(a, b)
+
+    #define PROFILE_ZONE(zoneName)     ::snv::ProfileZone SNV_PROFILE_CONCAT(profileZone, __LINE__)(zoneName)
+    #define PROFILE_THREAD(threadName) ::snv::Profiler::SetThreadName(threadName)
+#else
+    #define PROFILE_ZONE(zoneName)
+    #define PROFILE_THREAD(threadName)
+#endif
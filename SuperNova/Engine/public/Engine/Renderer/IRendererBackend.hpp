@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderCommandStream.hpp>
 #include <Engine/Renderer/RenderTypes.hpp>
 
 #include <glm/ext/matrix_float4x4.hpp>
@@ -27,21 +28,35 @@ public:
 
     virtual void Clear(BufferBit bufferBitMask) = 0;
 
+    [[nodiscard]] virtual ui32 GetFramesInFlight() const { return 1; }
+    // NOTE(v.matushkin): Waits until the GPU is done with the frame in flight that the next BeginFrame() records
+    //  and returns its index, the per frame resources of that index are free after it.
+    //  Backends that don't keep frames in flight on their own are always done with the previous frame
+    [[nodiscard]] virtual ui32 WaitForFrameInFlight() { return 0; }
+
     // TODO(v.matushkin): Remove, temporary method
-    virtual void BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) = 0;
+    virtual void BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection) = 0;
     virtual void EndFrame() = 0;
-    // NOTE(v.matushkin): Questionable method
-    virtual void DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount) = 0;
+    // NOTE(v.matushkin): Executes the commands between BeginFrame and EndFrame, the bind state doesn't carry over
+    //  from the previous Submit
+    virtual void Submit(const RenderCommandStream& commandStream) = 0;
     virtual void DrawArrays(i32 count) = 0;
     virtual void DrawElements(i32 count) = 0;
 
     virtual BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     ) = 0;
     virtual TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData) = 0;
     virtual ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource) = 0;
+    // NOTE(v.matushkin): Called from the shader watcher thread, the new shader replaces the old one in the next BeginFrame,
+    //  the handle stays the same. Returns false if the old shader is kept
+    virtual bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource) = 0;
+
+    // NOTE(v.matushkin): See GpuFrameStats, backends without GPU queries don't override it
+    [[nodiscard]] virtual GpuFrameStats GetGpuFrameStats() const { return {}; }
 };
 
 } // namespace snv
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Core.hpp>
+#include <Engine/Renderer/RenderTypes.hpp>
+
+#include <glm/ext/matrix_float4x4.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+
+// NOTE(v.matushkin): The frontend writes a frame worth of commands into a linear buffer and the backend consumes it
+//  in one IRendererBackend::Submit() call, instead of a virtual call per draw.
+//  Commands are POD packets, every packet starts with its RenderCommandType and is aligned to k_CommandAlignment.
+//  Binds only go into the stream when the state actually changes, backends execute them as they are.
+//  The stream keeps its capacity on Clear(), so after the first frame recording doesn't allocate.
+//  Per instance data of DrawIndexedInstanced is not in the packets, it goes to a separate array of the stream,
+//  so backends can upload all of it in one go.
+
+
+namespace snv
+{
+
+enum class RenderCommandType : ui8
+{
+    BindBuffer,
+    BindTexture,
+    SetObjectToWorld, // NOTE(v.matushkin): PerDraw constants of the following draws
+    DrawIndexed,
+    DrawIndexedInstanced,
+};
+
+
+struct BindBufferCommand
+{
+    static constexpr auto k_Type = RenderCommandType::BindBuffer;
+
+    RenderCommandType Type;
+    BufferHandle      Buffer;
+};
+
+struct BindTextureCommand
+{
+    static constexpr auto k_Type = RenderCommandType::BindTexture;
+
+    RenderCommandType Type;
+    TextureHandle     Texture;
+};
+
+struct SetObjectToWorldCommand
+{
+    static constexpr auto k_Type = RenderCommandType::SetObjectToWorld;
+
+    RenderCommandType Type;
+    glm::mat4x4       ObjectToWorld;
+};
+
+struct DrawIndexedCommand
+{
+    static constexpr auto k_Type = RenderCommandType::DrawIndexed;
+
+    RenderCommandType Type;
+    i32               IndexCount;
+};
+
+// NOTE(v.matushkin): SetObjectToWorld doesn't apply to it, every instance has its own ObjectToWorld
+struct DrawIndexedInstancedCommand
+{
+    static constexpr auto k_Type = RenderCommandType::DrawIndexedInstanced;
+
+    RenderCommandType Type;
+    i32               IndexCount;
+    ui32              InstanceCount;
+    ui32              FirstInstance; // NOTE(v.matushkin): In RenderCommandStream::GetInstanceData()
+};
+
+
+class RenderCommandStream
+{
+public:
+    static constexpr ui32 k_CommandAlignment = 16;
+
+    void Clear()
+    {
+        m_data.clear();
+        m_instanceData.clear();
+        m_commandCount = 0;
+    }
+
+    template<typename TCommand>
+    void Push(const TCommand& command)
+    {
+        static_assert(std::is_trivially_copyable_v<TCommand>, "Render commands must be POD");
+        static_assert(alignof(TCommand) <= k_CommandAlignment);
+
+        const auto offset = m_data.size();
+        m_data.resize(offset + AlignCommandSize(sizeof(TCommand)));
+        std::memcpy(m_data.data() + offset, &command, sizeof(TCommand));
+        m_commandCount++;
+    }
+
+    void BindBuffer(BufferHandle buffer)
+    {
+        Push(BindBufferCommand{.Type = BindBufferCommand::k_Type, .Buffer = buffer});
+    }
+    void BindTexture(TextureHandle texture)
+    {
+        Push(BindTextureCommand{.Type = BindTextureCommand::k_Type, .Texture = texture});
+    }
+    void SetObjectToWorld(const glm::mat4x4& objectToWorld)
+    {
+        Push(SetObjectToWorldCommand{.Type = SetObjectToWorldCommand::k_Type, .ObjectToWorld = objectToWorld});
+    }
+    void DrawIndexed(i32 indexCount)
+    {
+        Push(DrawIndexedCommand{.Type = DrawIndexedCommand::k_Type, .IndexCount = indexCount});
+    }
+    // NOTE(v.matushkin): Returns ObjectToWorld of every instance for the caller to fill,
+    //  the span is only valid until the next DrawIndexedInstanced()
+    [[nodiscard]] std::span<glm::mat4x4> DrawIndexedInstanced(i32 indexCount, ui32 instanceCount)
+    {
+        const auto firstInstance = static_cast<ui32>(m_instanceData.size());
+        m_instanceData.resize(firstInstance + instanceCount);
+
+        Push(DrawIndexedInstancedCommand{
+            .Type          = DrawIndexedInstancedCommand::k_Type,
+            .IndexCount    = indexCount,
+            .InstanceCount = instanceCount,
+            .FirstInstance = firstInstance,
+        });
+
+        return std::span(m_instanceData).subspan(firstInstance, instanceCount);
+    }
+
+    [[nodiscard]] std::span<const std::byte>   GetData()         const { return m_data; }
+    [[nodiscard]] std::span<const glm::mat4x4> GetInstanceData() const { return m_instanceData; }
+    [[nodiscard]] ui32                         GetCommandCount() const { return m_commandCount; }
+
+    [[nodiscard]] static constexpr size_t AlignCommandSize(size_t size)
+    {
+        return (size + k_CommandAlignment - 1) & ~size_t(k_CommandAlignment - 1);
+    }
+
+private:
+    // TODO(v.matushkin): std::vector<std::byte> relies on operator new alignment being at least k_CommandAlignment
+    std::vector<std::byte>   m_data;
+    std::vector<glm::mat4x4> m_instanceData;
+    ui32                     m_commandCount = 0;
+};
+
+
+// NOTE(v.matushkin): Usage:
+//  for (RenderCommandReader reader(stream); reader.IsEnd() == false;)
+//  {
+//      switch (reader.GetType())
+//      {
+//      case RenderCommandType::BindBuffer:
+//          const auto& command = reader.Read<BindBufferCommand>();
+//  ...
+class RenderCommandReader
+{
+public:
+    explicit RenderCommandReader(const RenderCommandStream& stream)
+        : m_data(stream.GetData())
+        , m_offset(0)
+    {}
+    // NOTE(v.matushkin): Reads [beginOffset, endOffset) part of the stream, offsets must be the ones from GetOffset()
+    RenderCommandReader(const RenderCommandStream& stream, size_t beginOffset, size_t endOffset)
+        : m_data(stream.GetData().first(endOffset))
+        , m_offset(beginOffset)
+    {}
+
+    [[nodiscard]] bool              IsEnd()     const { return m_offset >= m_data.size(); }
+    [[nodiscard]] RenderCommandType GetType()   const { return static_cast<RenderCommandType>(m_data[m_offset]); }
+    // NOTE(v.matushkin): Offset of the next command
+    [[nodiscard]] size_t            GetOffset() const { return m_offset; }
+
+    template<typename TCommand>
+    [[nodiscard]] const TCommand& Read()
+    {
+        SNV_ASSERT(GetType() == TCommand::k_Type, "Render command type mismatch");
+
+        const auto command = reinterpret_cast<const TCommand*>(m_data.data() + m_offset);
+        m_offset          += RenderCommandStream::AlignCommandSize(sizeof(TCommand));
+        return *command;
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    size_t                     m_offset;
+};
+
+} // namespace snv
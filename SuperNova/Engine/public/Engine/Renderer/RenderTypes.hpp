@@ -2,6 +2,8 @@
 
 #include <Engine/Core/Core.hpp>
 
+#include <glm/ext/vector_float3.hpp>
+
 
 namespace snv
 {
@@ -10,6 +12,7 @@ enum class GraphicsApi : ui8
 {
     OpenGL,
     Vulkan,
+    Null,       // NOTE(v.matushkin): Headless, records calls without touching a GPU
 #ifdef SNV_PLATFORM_WINDOWS
     DirectX11,
     DirectX12
@@ -17,6 +20,21 @@ enum class GraphicsApi : ui8
 };
 
 
+enum class PresentMode : ui8
+{
+    Fifo,      // NOTE(v.matushkin): VSync, the only one that is always supported
+    Mailbox,   // NOTE(v.matushkin): VSync without blocking, the latest finished frame replaces the queued one
+    Immediate, // NOTE(v.matushkin): No VSync, can tear
+};
+
+// NOTE(v.matushkin): Latency vs throughput knobs, only VulkanBackend uses it for now
+struct SwapchainDesc
+{
+    PresentMode PreferredPresentMode; // NOTE(v.matushkin): Falls back to Fifo if the surface doesn't support it
+    ui32        FramesInFlight;       // NOTE(v.matushkin): How many frames the CPU can record ahead of the GPU, 1 is the lowest latency
+};
+
+
 enum class BlendFactor : ui32
 {
     One,
@@ -54,11 +72,19 @@ enum class TextureHandle : ui32 { InvalidHandle = k_InvalidHandle };
 enum class ShaderHandle  : ui32 { InvalidHandle = k_InvalidHandle };
 
 
+enum class IndexFormat : ui8
+{
+    UInt16,
+    UInt32
+};
+
 enum class VertexAttribute : ui8
 {
     Position,
     Normal,
-    TexCoord0
+    TexCoord0,
+
+    Count
 };
 
 enum class VertexAttributeFormat : ui8
@@ -74,12 +100,19 @@ enum class VertexAttributeFormat : ui8
     Float64
 };
 
+// NOTE(v.matushkin): Offset is where the attribute of the first vertex is in the vertex data,
+//  Stride is the distance between the attributes of two consecutive vertices.
+//  Planar streams have Offset at the start of the stream and Stride == attribute size,
+//  interleaved vertices have Offset inside the vertex and Stride == vertex size.
+//  Normalized integer formats are read as [-1, 1]/[0, 1] floats in the shader.
 struct VertexAttributeDesc
 {
     VertexAttribute       Attribute;
     VertexAttributeFormat Format;
     ui8                   Dimension;
+    bool                  Normalized;
     ui32                  Offset;
+    ui32                  Stride;
 };
 
 enum class TextureFormat : ui8
@@ -109,12 +142,144 @@ enum class TextureWrapMode : ui8
     Repeat
 };
 
+// NOTE(v.matushkin): Texture data passed to CreateTexture is a tightly packed mip chain,
+//  from the mip 0 to the mip MipCount - 1, without any row padding
 struct TextureDesc
 {
     ui32            Width;
     ui32            Height;
+    ui32            MipCount;
     TextureFormat   Format;
     TextureWrapMode WrapMode;
 };
 
+
+[[nodiscard]] constexpr ui32 GetTextureFormatSize(TextureFormat textureFormat)
+{
+    constexpr ui32 textureFormatSize[] = {
+        1, // TextureFormat::R8
+        2, // TextureFormat::R16
+        2, // TextureFormat::R16F
+        4, // TextureFormat::R32F
+        2, // TextureFormat::RG8
+        4, // TextureFormat::RG16
+        4, // TextureFormat::RGBA8
+        8, // TextureFormat::RGBA16F
+        2, // TextureFormat::DEPTH16
+        4, // TextureFormat::DEPTH32
+        4, // TextureFormat::DEPTH32F
+    };
+    return textureFormatSize[static_cast<ui8>(textureFormat)];
+}
+
+[[nodiscard]] constexpr ui32 GetIndexFormatSize(IndexFormat indexFormat)
+{
+    return indexFormat == IndexFormat::UInt16 ? sizeof(ui16) : sizeof(ui32);
+}
+
+[[nodiscard]] constexpr ui32 GetVertexAttributeFormatSize(VertexAttributeFormat vertexAttributeFormat)
+{
+    constexpr ui32 vertexAttributeFormatSize[] = {
+        1, // VertexAttributeFormat::Int8
+        2, // VertexAttributeFormat::Int16
+        4, // VertexAttributeFormat::Int32
+        1, // VertexAttributeFormat::UInt8
+        2, // VertexAttributeFormat::UInt16
+        4, // VertexAttributeFormat::UInt32
+        2, // VertexAttributeFormat::Float16
+        4, // VertexAttributeFormat::Float32
+        8, // VertexAttributeFormat::Float64
+    };
+    return vertexAttributeFormatSize[static_cast<ui8>(vertexAttributeFormat)];
+}
+
+[[nodiscard]] constexpr ui32 GetVertexAttributeSize(const VertexAttributeDesc& vertexAttributeDesc)
+{
+    return GetVertexAttributeFormatSize(vertexAttributeDesc.Format) * vertexAttributeDesc.Dimension;
+}
+
+// NOTE(v.matushkin): Offset is not compared, it's per mesh for planar layouts and doesn't change how vertices are fetched
+[[nodiscard]] constexpr bool IsSameVertexFormat(const VertexAttributeDesc& lhs, const VertexAttributeDesc& rhs)
+{
+    return lhs.Attribute == rhs.Attribute
+        && lhs.Format == rhs.Format
+        && lhs.Dimension == rhs.Dimension
+        && lhs.Normalized == rhs.Normalized
+        && lhs.Stride == rhs.Stride;
+}
+
+
+[[nodiscard]] constexpr ui32 GetMipDimension(ui32 dimension, ui32 mip)
+{
+    const ui32 mipDimension = dimension >> mip;
+    return mipDimension > 0 ? mipDimension : 1;
+}
+
+[[nodiscard]] constexpr ui32 GetFullMipCount(ui32 width, ui32 height)
+{
+    ui32 mipCount = 1;
+    for (ui32 maxDimension = width > height ? width : height; maxDimension > 1; maxDimension >>= 1)
+    {
+        mipCount++;
+    }
+    return mipCount;
+}
+
+[[nodiscard]] constexpr ui64 GetMipSize(const TextureDesc& textureDesc, ui32 mip)
+{
+    return ui64(GetMipDimension(textureDesc.Width, mip)) * GetMipDimension(textureDesc.Height, mip)
+           * GetTextureFormatSize(textureDesc.Format);
+}
+
+[[nodiscard]] constexpr ui64 GetTextureSize(const TextureDesc& textureDesc)
+{
+    ui64 textureSize = 0;
+    for (ui32 mip = 0; mip < textureDesc.MipCount; ++mip)
+    {
+        textureSize += GetMipSize(textureDesc, mip);
+    }
+    return textureSize;
+}
+
+
+// NOTE(v.matushkin): Object space bounds, computed at import time
+struct AABB
+{
+    glm::vec3 Min;
+    glm::vec3 Max;
+};
+
+
+// NOTE(v.matushkin): Filled by the Renderer frontend, so it's the same for every backend
+struct RenderFrameStats
+{
+    ui32 DrawCalls;
+    ui32 CulledObjects;
+    ui64 Triangles;
+    ui32 StateChanges;     // NOTE(v.matushkin): Pipeline, texture and buffer binds that the sorted draws actually needed
+    ui32 InstancedObjects; // NOTE(v.matushkin): Objects that were batched into instanced draws
+    ui32 HeapAllocations;  // NOTE(v.matushkin): Of all threads during RenderFrame(), always 0 without SNV_MEMORY_TRACKING_ENABLED
+};
+
+
+constexpr ui32 k_MaxGpuPasses = 4;
+
+struct GpuPassStats
+{
+    const char* Name; // NOTE(v.matushkin): Static string of the backend
+    f32         Milliseconds;
+};
+
+// NOTE(v.matushkin): Measured by the backend with GPU queries. They're read back a few frames later, so the CPU
+//  never waits for them, these are the stats of the latest frame the GPU has finished, not of the last RenderFrame().
+//  Everything is 0 if the backend doesn't support the queries
+struct GpuFrameStats
+{
+    f32          FrameMilliseconds;
+    ui64         VertexInvocations;
+    ui64         FragmentInvocations;
+    GpuPassStats Passes[k_MaxGpuPasses];
+    ui32         PassCount;
+};
+
 } // namespace snv
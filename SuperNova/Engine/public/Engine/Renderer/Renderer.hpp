@@ -17,7 +17,7 @@ class IRendererBackend;
 class Renderer
 {
 public:
-    static void Init(GraphicsApi graphicsApi);
+    static void Init(GraphicsApi graphicsApi, const SwapchainDesc& swapchainDesc);
     static void Shutdown();
 
     static void EnableBlend();
@@ -34,18 +34,27 @@ public:
     static void Clear(BufferBit bufferBitMask);
 
     static void RenderFrame(const glm::mat4x4& localToWorld);
+    // NOTE(v.matushkin): Stats of the last RenderFrame() call
+    [[nodiscard]] static const RenderFrameStats& GetFrameStats() { return s_frameStats; }
+    // NOTE(v.matushkin): GPU timings of the latest frame the GPU has finished, a few frames behind GetFrameStats()
+    [[nodiscard]] static GpuFrameStats GetGpuFrameStats();
 
     static BufferHandle CreateBuffer(
         std::span<const std::byte>              indexData,
+        IndexFormat                             indexFormat,
         std::span<const std::byte>              vertexData,
         const std::vector<VertexAttributeDesc>& vertexLayout
     );
     static TextureHandle CreateTexture(const TextureDesc& textureDesc, const ui8* textureData);
     static ShaderHandle  CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource);
+    // NOTE(v.matushkin): Thread safe, see IRendererBackend::ReloadShader()
+    static bool          ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource);
 
 private:
     static inline GraphicsApi       s_graphicsApi;
     static inline IRendererBackend* s_rendererBackend;
+
+    static inline RenderFrameStats  s_frameStats;
 };
 
 } // namespace snv
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+
+namespace snv
+{
+
+inline constexpr ui64 k_HashSeed = 14695981039346656037ull; // FNV-1a 64 offset basis
+
+// NOTE(v.matushkin): FNV-1a that eats 8 bytes per step instead of 1.
+//  Not a standard FNV anymore, but good enough to detect changed files and it's ~8x faster.
+//  Results depend on the endianness, don't store them anywhere they can be shared between platforms.
+[[nodiscard]] inline ui64 HashBytes(std::span<const std::byte> bytes, ui64 seed = k_HashSeed)
+{
+    constexpr ui64 fnvPrime = 1099511628211ull;
+
+    ui64       hash      = seed;
+    const auto wordCount = bytes.size() / sizeof(ui64);
+    const auto data      = bytes.data();
+
+    for (size_t i = 0; i < wordCount; ++i)
+    {
+        ui64 word;
+        std::memcpy(&word, data + i * sizeof(ui64), sizeof(ui64));
+        hash ^= word;
+        hash *= fnvPrime;
+    }
+    for (size_t i = wordCount * sizeof(ui64); i < bytes.size(); ++i)
+    {
+        hash ^= static_cast<ui64>(data[i]);
+        hash *= fnvPrime;
+    }
+
+    return hash;
+}
+
+} // namespace snv
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Engine/Core/Core.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+
+namespace snv
+{
+
+// NOTE(v.matushkin): Read-only memory mapped file, the mapping lives as long as the object does.
+//  Moving doesn't change the mapping address, so spans into GetData() stay valid after the move.
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    [[nodiscard]] bool                       IsValid() const { return m_data != nullptr; }
+    [[nodiscard]] std::span<const std::byte> GetData() const { return {m_data, m_size}; }
+
+private:
+    void Close();
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t           m_size = 0;
+#ifdef SNV_PLATFORM_WINDOWS
+    void*            m_fileHandle    = nullptr;
+    void*            m_mappingHandle = nullptr;
+#endif
+};
+
+} // namespace snv
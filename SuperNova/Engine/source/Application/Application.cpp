@@ -1,6 +1,9 @@
 #include <Engine/Application/Application.hpp>
 
 #include <Engine/Application/Window.hpp>
+#include <Engine/Core/JobSystem.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
+#include <Engine/Core/Profiler.hpp>
 #include <Engine/Input/Keyboard.hpp>
 #include <Engine/Input/Mouse.hpp>
 #include <Engine/Renderer/Renderer.hpp>
@@ -11,9 +14,30 @@ const ui32 k_WindowHeight = 800;
 // TODO(v.matushkin): Remove k_GraphicsApi duplication in Engine.cpp
 const snv::GraphicsApi k_GraphicsApi = snv::GraphicsApi::Vulkan;
 
+#ifdef SNV_PROFILING_ENABLED
+// NOTE(v.matushkin): F9 captures the next k_ProfileCaptureFrames frames into k_ProfileCapturePath
+const ui32  k_ProfileCaptureFrames = 300;
+const char* k_ProfileCapturePath   = "profile_capture.json";
+
+ui32 g_ProfileCapturedFrames = 0;
+#endif
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+// NOTE(v.matushkin): HeapAllocationGuardMode::Assert breaks on the first heap allocation inside of a RenderFrame().
+//  It's set after the warmup frames, the first frames still create pipelines and grow the frame arenas
+const snv::HeapAllocationGuardMode k_HeapAllocationGuardMode         = snv::HeapAllocationGuardMode::Count;
+const ui32                         k_HeapAllocationGuardWarmupFrames = 10;
+
+ui32 g_FrameCount = 0;
+// NOTE(v.matushkin): F10 logs the memory stats of every MemoryTag, once per press
+bool g_IsMemoryStatsKeyDown = false;
+#endif
+
 
 void ProcessInput()
 {
+    PROFILE_ZONE("ProcessInput");
+
     snv::Window::PollEvents();
 
     if (snv::Input::Keyboard::IsKeyPressed(snv::Input::KeyboardKey::Escape))
@@ -22,6 +46,41 @@ void ProcessInput()
     }
 }
 
+#ifdef SNV_PROFILING_ENABLED
+void ProcessProfileCapture()
+{
+    if (snv::Profiler::IsCapturing())
+    {
+        if (++g_ProfileCapturedFrames == k_ProfileCaptureFrames)
+        {
+            snv::Profiler::EndCapture(k_ProfileCapturePath);
+        }
+    }
+    else if (snv::Input::Keyboard::IsKeyPressed(snv::Input::KeyboardKey::F9))
+    {
+        g_ProfileCapturedFrames = 0;
+        snv::Profiler::BeginCapture();
+    }
+}
+#endif
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+void ProcessMemoryStats()
+{
+    if (++g_FrameCount == k_HeapAllocationGuardWarmupFrames)
+    {
+        snv::MemoryTracker::SetHeapAllocationGuardMode(k_HeapAllocationGuardMode);
+    }
+
+    const auto isMemoryStatsKeyDown = snv::Input::Keyboard::IsKeyPressed(snv::Input::KeyboardKey::F10);
+    if (isMemoryStatsKeyDown && g_IsMemoryStatsKeyDown == false)
+    {
+        snv::MemoryTracker::LogTagStats();
+    }
+    g_IsMemoryStatsKeyDown = isMemoryStatsKeyDown;
+}
+#endif
+
 
 namespace snv
 {
@@ -33,6 +92,8 @@ Application::Application()
     Window::SetMouseButtonCallback(Input::Mouse::ButtonCallback);
     Window::SetMousePositionCallback(Input::Mouse::PositionCallback);
     Window::SetMouseWheelCallback(Input::Mouse::WheelCallback);
+
+    JobSystem::Init();
 }
 
 Application::~Application()
@@ -43,6 +104,7 @@ Application::~Application()
         delete layer;
     }
 
+    JobSystem::Shutdown();
     Window::Shutdown();
 }
 
@@ -55,12 +117,24 @@ void Application::AddLayer(IApplicationLayer* layer)
 
 void Application::Run()
 {
+    PROFILE_THREAD("Main");
+
     while (Window::IsShouldBeClosed() == false)
     {
+#ifdef SNV_PROFILING_ENABLED
+        // NOTE(v.matushkin): Outside of the frame zone, so the captured frames are whole
+        ProcessProfileCapture();
+#endif
+        PROFILE_ZONE("Application::Frame");
+
         ProcessInput();
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+        ProcessMemoryStats();
+#endif
 
         for (auto layer : m_layers)
         {
+            PROFILE_ZONE("IApplicationLayer::OnUpdate");
             layer->OnUpdate();
         }
     }
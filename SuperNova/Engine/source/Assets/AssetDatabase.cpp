@@ -1,18 +1,29 @@
 #include <Engine/Assets/AssetDatabase.hpp>
 
+#include <Engine/Assets/MeshCache.hpp>
+#include <Engine/Assets/MeshOptimizer.hpp>
 #include <Engine/Assets/Model.hpp>
 #include <Engine/Assets/Mesh.hpp>
 #include <Engine/Assets/Material.hpp>
 #include <Engine/Assets/Texture.hpp>
 #include <Engine/Assets/Shader.hpp>
+#include <Engine/Assets/ShaderCache.hpp>
+#include <Engine/Assets/ShaderWatcher.hpp>
+#include <Engine/Assets/TextureCache.hpp>
 #include <Engine/Components/MeshRenderer.hpp>
 #include <Engine/Core/Assert.hpp>
+#include <Engine/Core/JobSystem.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
+#include <Engine/Core/Profiler.hpp>
 #include <Engine/Entity/GameObject.hpp>
 #include <Engine/Renderer/Renderer.hpp>
+#include <Engine/Utils/Hash.hpp>
+#include <Engine/Utils/MappedFile.hpp>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <glm/gtc/packing.hpp>
 
 // NOTE(v.matushkin): Put stb in a normal conan package? not this fucking trash that I get rn
 #ifdef SNV_ENABLE_DEBUG
@@ -20,11 +31,18 @@
 #else
     #define STBI_NO_FAILURE_STRINGS
 #endif
+// NOTE(v.matushkin): So the decoded images show up in the memory stats
+#define STBI_MALLOC(size)              ::snv::MemoryTracker::Allocate(size)
+#define STBI_REALLOC(memory, size)     ::snv::MemoryTracker::Reallocate(memory, size)
+#define STBI_FREE(memory)              ::snv::MemoryTracker::Free(memory)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 
 
 namespace AssimpConstants
@@ -39,10 +57,6 @@ namespace AssimpConstants
     static constexpr i32 NormalDimension = 3;
     static constexpr i32 NormalTypeSize = sizeof(f32);
     static constexpr i32 NormalSize = NormalDimension * NormalTypeSize;
-    // TexCoord0
-    static constexpr i32 TexCoord0Dimension = 3;
-    static constexpr i32 TexCoord0TypeSize = sizeof(f32);
-    static constexpr i32 TexCoord0Size = TexCoord0Dimension * TexCoord0TypeSize;
 
 #define MEMBER_SIZEOF(type, member) sizeof(((type *)0)->member)
     static_assert(MEMBER_SIZEOF(aiVector3D, x) == PositionTypeSize);
@@ -60,7 +74,7 @@ namespace AssimpConstants
 aiString GetAssimpMaterialTexturePath(const aiMaterial* material, aiTextureType textureType)
 {
     aiString texturePath;
-    auto error = material->GetTexture(aiTextureType::aiTextureType_DIFFUSE, 0, &texturePath);
+    auto error = material->GetTexture(textureType, 0, &texturePath);
     SNV_ASSERT(error == aiReturn::aiReturn_SUCCESS, error == aiReturn_FAILURE ? "aiReturn_FAILURE" : "aiReturn_OUTOFMEMORY");
 
     return texturePath;
@@ -70,7 +84,67 @@ aiString GetAssimpMaterialTexturePath(const aiMaterial* material, aiTextureType
 namespace snv
 {
 
-std::vector<std::shared_ptr<Material>> GetAssimpMaterials(const aiScene* scene, ShaderPtr shader);
+// NOTE(v.matushkin): Should be per asset import settings at some point, for now they are the same for every model.
+//  They are hashed together with the source file, so changing them invalidates the mesh cache.
+struct MeshImportSettings
+{
+    // NOTE(v.matushkin): SNORM16 normals and Float16 uvs, 36 -> 24 bytes per vertex.
+    //  Octahedral normals would fit in 4 bytes, but need decoding in every vertex shader.
+    bool PackAttributes;
+    // NOTE(v.matushkin): One stream with the whole vertex, instead of a stream per attribute
+    bool InterleaveAttributes;
+    // NOTE(v.matushkin): Reorder triangles for the post-transform cache and overdraw, and vertices for the fetch
+    bool OptimizeMesh;
+    // NOTE(v.matushkin): UInt16 indices for the meshes that have less than 65536 vertices
+    bool Allow16BitIndices;
+};
+
+constexpr MeshImportSettings k_MeshImportSettings = {
+    .PackAttributes       = true,
+    .InterleaveAttributes = true,
+    .OptimizeMesh         = true,
+    .Allow16BitIndices    = true,
+};
+
+
+// NOTE(v.matushkin): CPU side results of the import, GPU resources are created from them on the calling thread
+struct MeshImportData
+{
+    i32                              IndexCount;
+    ui32                             IndexDataSize;
+    std::unique_ptr<ui8[]>           IndexData;
+    IndexFormat                      IndexDataFormat;
+    i32                              VertexCount;
+    ui32                             VertexDataSize;
+    std::unique_ptr<ui8[]>           VertexData;
+    std::vector<VertexAttributeDesc> VertexLayout;
+    AABB                             Bounds;
+    ui32                             MaterialIndex;
+    // NOTE(v.matushkin): Vertex cache simulation, see MeshOptimizer::CountTransformedVertices
+    ui32                             TransformedVerticesBefore;
+    ui32                             TransformedVerticesAfter;
+};
+
+
+std::vector<std::shared_ptr<Material>> CreateMaterials(
+    std::span<const MeshCache::MaterialRecord> materialRecords,
+    const std::string&                         textureDir,
+    ShaderPtr                                  shader
+);
+void                                   ImportAssimpModel(
+    const std::string&                      modelPath,
+    std::vector<MeshCache::MaterialRecord>& materials,
+    std::vector<MeshImportData>&            importedMeshes
+);
+MeshCache::MaterialRecord              ConvertAssimpMaterial(const aiMaterial* assimpMaterial);
+MeshImportData                         ConvertAssimpMesh(const aiMesh* assimpMesh);
+TextureCache::CookedTexture            ImportTexture(
+    const std::string& texturePath,
+    const std::string& sourcePath,
+    const std::string& cachePath
+);
+ui64                                   HashFile(const std::string& filePath);
+std::string                            ReadShaderSource(const std::string& sourcePath);
 
 
 void AssetDatabase::Init(std::string assetDirectory)
@@ -78,6 +152,7 @@ void AssetDatabase::Init(std::string assetDirectory)
     // NOTE(v.matushkin): Assuming that assetDirectory ends with '/'
     m_assetDir = std::move(assetDirectory);
     m_modelDir = m_assetDir + "models/";
+    m_cacheDir = m_assetDir + "cache/";
 
     const std::string shaderDir = m_assetDir + "shaders/";
 
@@ -86,6 +161,32 @@ void AssetDatabase::Init(std::string assetDirectory)
     m_dxShaderDir = shaderDir + "dx/";
 }
 
+void AssetDatabase::Shutdown()
+{
+    // NOTE(v.matushkin): Must be called before Renderer::Shutdown(), the watcher may be reloading a shader
+    delete m_shaderWatcher;
+    m_shaderWatcher = nullptr;
+}
+
+void AssetDatabase::EnableShaderHotReload()
+{
+    SNV_ASSERT(m_shaderWatcher == nullptr, "Shader hot reload is already enabled");
+
+    // NOTE(v.matushkin): Called on the watcher thread, the backend compiles the shader there too if it can
+    m_shaderWatcher = new ShaderWatcher([](ShaderHandle shaderHandle, const std::string& shaderName) {
+        const auto shaderPath     = GetShaderPath(shaderName);
+        const auto vertexSource   = ReadShaderSource(shaderPath + "_vs" + GetShaderExtension());
+        const auto fragmentSource = ReadShaderSource(shaderPath + "_fs" + GetShaderExtension());
+
+        if (vertexSource.empty() || fragmentSource.empty())
+        {
+            return;
+        }
+
+        (void) Renderer::ReloadShader(shaderHandle, vertexSource, fragmentSource);
+    });
+}
+
 
 // TODO(v.matushkin): Heterogeneous lookup for string_view assetPath?
 // TODO(v.matushkin): I think assets shouldn't have *::LoadAsset() method,
@@ -93,6 +194,8 @@ void AssetDatabase::Init(std::string assetDirectory)
 template<>
 ModelPtr AssetDatabase::LoadAsset(const std::string& assetPath)
 {
+    MEMORY_TAG_SCOPE(MemoryTag::Assets);
+
     auto assetIt = m_models.find(assetPath);
     if (assetIt == m_models.end())
     {
@@ -105,10 +208,12 @@ ModelPtr AssetDatabase::LoadAsset(const std::string& assetPath)
 template<>
 TexturePtr AssetDatabase::LoadAsset(const std::string& assetPath)
 {
+    MEMORY_TAG_SCOPE(MemoryTag::Assets);
+
     auto assetIt = m_textures.find(assetPath);
     if (assetIt == m_textures.end())
     {
-        assetIt = m_textures.emplace(assetPath, std::make_shared<Texture>(LoadTexture(assetPath))).first;
+        assetIt = m_textures.emplace(assetPath, LoadTexture(assetPath)).first;
     }
 
     return assetIt->second;
@@ -117,9 +222,21 @@ TexturePtr AssetDatabase::LoadAsset(const std::string& assetPath)
 template<>
 ShaderPtr AssetDatabase::LoadAsset(const std::string& assetPath)
 {
+    MEMORY_TAG_SCOPE(MemoryTag::Assets);
+
     if (m_theOneAndOnlyForNow == nullptr)
     {
         m_theOneAndOnlyForNow = std::make_shared<Shader>(LoadShader(assetPath));
+
+        if (m_shaderWatcher != nullptr)
+        {
+            const auto        shaderPath    = GetShaderPath(assetPath);
+            const std::string sourcePaths[] = {
+                shaderPath + "_vs" + GetShaderExtension(),
+                shaderPath + "_fs" + GetShaderExtension(),
+            };
+            m_shaderWatcher->Watch(m_theOneAndOnlyForNow->GetHandle(), assetPath, sourcePaths);
+        }
     }
 
     return m_theOneAndOnlyForNow;
@@ -128,14 +245,246 @@ ShaderPtr AssetDatabase::LoadAsset(const std::string& assetPath)
 
 Model AssetDatabase::LoadModel(const std::string& modelName)
 {
-    const auto modelPath = m_modelDir + modelName;
+    PROFILE_ZONE("AssetDatabase::LoadModel");
+
+    const auto modelPath  = m_modelDir + modelName;
+    const auto cachePath  = m_cacheDir + modelName + MeshCache::k_FileExtension;
+    const auto sourceHash = HashBytes(std::as_bytes(std::span(&k_MeshImportSettings, 1)), HashFile(modelPath));
+
+    //- Get the cooked model, import and cook it if there is no valid cache
+    MeshCache::CookedModel      cookedModel;
+    // NOTE(v.matushkin): Owns the mesh data when the model was imported, cookedModel.Meshes points into it
+    std::vector<MeshImportData> importedMeshes;
+
+    if (MeshCache::Read(cachePath, sourceHash, cookedModel))
+    {
+        LOG_INFO("Model: {}, loaded from the cache", modelName);
+    }
+    else
+    {
+        ImportAssimpModel(modelPath, cookedModel.Materials, importedMeshes);
+
+        cookedModel.Meshes.reserve(importedMeshes.size());
+        for (const auto& importedMesh : importedMeshes)
+        {
+            cookedModel.Meshes.push_back(MeshCache::MeshRecord{
+                .IndexData       = std::as_bytes(std::span(importedMesh.IndexData.get(), importedMesh.IndexDataSize)),
+                .IndexDataFormat = importedMesh.IndexDataFormat,
+                .VertexData      = std::as_bytes(std::span(importedMesh.VertexData.get(), importedMesh.VertexDataSize)),
+                .VertexCount     = importedMesh.VertexCount,
+                .VertexLayout    = importedMesh.VertexLayout,
+                .Bounds          = importedMesh.Bounds,
+                .MaterialIndex   = importedMesh.MaterialIndex,
+            });
+        }
+
+        if (MeshCache::Write(cachePath, sourceHash, cookedModel.Materials, cookedModel.Meshes) == false)
+        {
+            LOG_WARN("Model: {}, failed to write the cache", modelName);
+        }
+    }
+
+    //- Decode textures on the worker threads
+    // NOTE(v.matushkin): Only CPU side work here, no Renderer calls are allowed from the workers
+    // NOTE(v.matushkin): Material texture paths are relative to the model, texture assets are relative to m_modelDir
+    const auto textureDir = std::filesystem::path(modelName).remove_filename().generic_string();
+
+    std::vector<std::string> texturePaths;
+    for (const auto& materialRecord : cookedModel.Materials)
+    {
+        for (const auto& materialTexturePath : {materialRecord.BaseColorMapPath, materialRecord.NormalMapPath})
+        {
+            const auto texturePath = textureDir + materialTexturePath;
+            if (materialTexturePath.empty() == false
+                && m_textures.contains(texturePath) == false
+                && std::find(texturePaths.begin(), texturePaths.end(), texturePath) == texturePaths.end())
+            {
+                texturePaths.push_back(texturePath);
+            }
+        }
+    }
+
+    const auto                               numTextures = static_cast<ui32>(texturePaths.size());
+    std::vector<TextureCache::CookedTexture> cookedTextures(numTextures);
+
+    stbi_set_flip_vertically_on_load(true); // NOTE(v.matushkin): Global, so it has to be set before the workers start
+
+    JobSystem::ParallelFor(numTextures, [&cookedTextures, &texturePaths](ui32 i) {
+        MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+        const auto& texturePath = texturePaths[i];
+        cookedTextures[i]       = ImportTexture(
+            texturePath,
+            m_modelDir + texturePath,
+            m_cacheDir + texturePath + TextureCache::k_FileExtension
+        );
+    });
+
+    //- Create GPU resources on the calling thread
+    for (ui32 i = 0; i < numTextures; ++i)
+    {
+        const auto& cookedTexture = cookedTextures[i];
+        m_textures.emplace(
+            texturePaths[i],
+            cookedTexture.Data.empty()
+            ? Texture::GetBlackTexture()
+            : std::make_shared<Texture>(cookedTexture.Desc, cookedTexture.Data)
+        );
+    }
+
+    // NOTE(v.matushkin): All the textures are in m_textures already, so this is just a cache lookup
+    const auto materials = CreateMaterials(cookedModel.Materials, textureDir, m_theOneAndOnlyForNow);
+
+    std::vector<GameObject> modelGameObjects;
+    modelGameObjects.reserve(cookedModel.Meshes.size());
+
+    for (const auto& meshRecord : cookedModel.Meshes)
+    {
+        auto mesh = std::make_shared<Mesh>(
+            meshRecord.IndexData,
+            meshRecord.IndexDataFormat,
+            meshRecord.VertexCount,
+            meshRecord.VertexData,
+            meshRecord.VertexLayout,
+            meshRecord.Bounds
+        );
+
+        GameObject gameObject;
+        gameObject.AddComponent<MeshRenderer>(materials[meshRecord.MaterialIndex], mesh);
+
+        modelGameObjects.emplace_back(gameObject);
+    }
+
+    return Model(std::move(modelGameObjects));
+}
+
+TexturePtr AssetDatabase::LoadTexture(const std::string& texturePath)
+{
+    PROFILE_ZONE("AssetDatabase::LoadTexture");
+    MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+    stbi_set_flip_vertically_on_load(true); // TODO(v.matushkin): Set only once
+
+    const auto cookedTexture = ImportTexture(
+        texturePath,
+        m_modelDir + texturePath,
+        m_cacheDir + texturePath + TextureCache::k_FileExtension
+    );
+
+    if (cookedTexture.Data.empty())
+    {
+        return Texture::GetBlackTexture();
+    }
+
+    return std::make_shared<Texture>(cookedTexture.Desc, cookedTexture.Data);
+}
+
+// TODO(v.matushkin): Improve this shit with passes/loading(don't know what did I mean by that)
+//  Thats why there should be only one shader language I guess
+//  Or at least there should some static AppSettings class or something, so there is no need to access Renderer
+Shader AssetDatabase::LoadShader(const std::string& shaderName)
+{
+    PROFILE_ZONE("AssetDatabase::LoadShader");
+
+    const auto graphicsApi = Renderer::GetGraphicsApi();
+    const auto shaderPath  = GetShaderPath(shaderName);
+
+    const auto vertexSource   = ReadShaderSource(shaderPath + "_vs" + GetShaderExtension());
+    const auto fragmentSource = ReadShaderSource(shaderPath + "_fs" + GetShaderExtension());
+
+    std::span<const char> vertexStage(vertexSource);
+    std::span<const char> fragmentStage(fragmentSource);
+
+    // NOTE(v.matushkin): Use the SPIR-V precompiled by SuperNovaShaderCompiler if it's up to date with the source,
+    //  VulkanBackend tells SPIR-V from GLSL by the magic number
+    ShaderCache::CookedShader cookedVertex;
+    ShaderCache::CookedShader cookedFragment;
+    if (graphicsApi == GraphicsApi::Vulkan)
+    {
+        const auto vertexCachePath   = shaderPath + "_vs" + ShaderCache::k_FileExtension;
+        const auto fragmentCachePath = shaderPath + "_fs" + ShaderCache::k_FileExtension;
+
+        if (ShaderCache::Read(vertexCachePath, HashBytes(std::as_bytes(vertexStage)), cookedVertex))
+        {
+            vertexStage = std::span(reinterpret_cast<const char*>(cookedVertex.Bytecode.data()), cookedVertex.Bytecode.size());
+        }
+        if (ShaderCache::Read(fragmentCachePath, HashBytes(std::as_bytes(fragmentStage)), cookedFragment))
+        {
+            fragmentStage = std::span(reinterpret_cast<const char*>(cookedFragment.Bytecode.data()), cookedFragment.Bytecode.size());
+        }
+    }
+
+    return Shader(vertexStage, fragmentStage);
+}
+
+std::string AssetDatabase::GetShaderPath(const std::string& shaderName)
+{
+    const auto graphicsApi = Renderer::GetGraphicsApi();
+
+    if (graphicsApi == GraphicsApi::DirectX11 || graphicsApi == GraphicsApi::DirectX12)
+    {
+        return m_dxShaderDir + shaderName;
+    }
+
+    return (graphicsApi == GraphicsApi::OpenGL ? m_glShaderDir : m_vkShaderDir) + shaderName;
+}
+
+const char* AssetDatabase::GetShaderExtension()
+{
+    const auto graphicsApi = Renderer::GetGraphicsApi();
+    return graphicsApi == GraphicsApi::DirectX11 || graphicsApi == GraphicsApi::DirectX12 ? ".hlsl" : ".glsl";
+}
+
+
+std::vector<std::shared_ptr<Material>> CreateMaterials(
+    std::span<const MeshCache::MaterialRecord> materialRecords,
+    const std::string&                         textureDir,
+    ShaderPtr                                  shader
+)
+{
+    std::vector<std::shared_ptr<Material>> materials;
+    materials.reserve(materialRecords.size());
+
+    for (const auto& materialRecord : materialRecords)
+    {
+        auto material = std::make_shared<Material>(shader);
+        material->SetName(materialRecord.Name);
+
+        material->SetBaseColorMap(
+            materialRecord.BaseColorMapPath.empty()
+            ? Texture::GetBlackTexture()
+            : AssetDatabase::LoadAsset<Texture>(textureDir + materialRecord.BaseColorMapPath)
+        );
+        material->SetNormalMap(
+            materialRecord.NormalMapPath.empty()
+            ? Texture::GetNormalTexture()
+            : AssetDatabase::LoadAsset<Texture>(textureDir + materialRecord.NormalMapPath)
+        );
+
+        materials.emplace_back(material);
+    }
+
+    return materials;
+}
+
+
+void ImportAssimpModel(
+    const std::string&                      modelPath,
+    std::vector<MeshCache::MaterialRecord>& materials,
+    std::vector<MeshImportData>&            importedMeshes
+)
+{
+    PROFILE_ZONE("ImportAssimpModel");
+    MEMORY_TAG_SCOPE(MemoryTag::Transient);
 
     Assimp::Importer assimpImporter;
     // TODO(v.matushkin): Learn more about aiPostProcessSteps
+    // NOTE(v.matushkin): Bump MeshCache k_Version if this flags are changed
     const aiScene* scene = assimpImporter.ReadFile(
         modelPath,
         aiPostProcessSteps::aiProcess_Triangulate
         | aiPostProcessSteps::aiProcess_GenNormals
+        | aiPostProcessSteps::aiProcess_JoinIdenticalVertices // NOTE(v.matushkin): Without it there is nothing to cache
         // | aiPostProcessSteps::aiProcess_FlipUVs          // Instead of stbi_set_flip_vertically_on_load(true); ?
         // | aiPostProcessSteps::aiProcess_FlipWindingOrder // Default is counter clockwise
     );
@@ -150,248 +499,370 @@ Model AssetDatabase::LoadModel(const std::string& modelName)
         SNV_ASSERT(false, "REMOVE THIS SOMEHOW");
     }
 
-    const auto materials = GetAssimpMaterials(scene, m_theOneAndOnlyForNow);
+    SNV_ASSERT(scene->HasMaterials(), "LOL");
+
+    materials.reserve(scene->mNumMaterials);
+    for (ui32 i = 0; i < scene->mNumMaterials; ++i)
+    {
+        materials.push_back(ConvertAssimpMaterial(scene->mMaterials[i]));
+    }
 
-    std::vector<GameObject> modelGameObjects;
+    //- Convert meshes on the worker threads
+    const auto numMeshes = scene->mNumMeshes;
+    importedMeshes.resize(numMeshes);
 
-    for (ui32 i = 0; i < scene->mNumMeshes; ++i)
+    JobSystem::ParallelFor(numMeshes, [&importedMeshes, scene](ui32 i) {
+        MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+        importedMeshes[i] = ConvertAssimpMesh(scene->mMeshes[i]);
+    });
+
+    LOG_INFO("Model: {}, imported {} meshes on {} threads", modelPath, numMeshes, JobSystem::GetThreadCount());
+
+    ui64 triangleCount             = 0;
+    ui64 transformedVerticesBefore = 0;
+    ui64 transformedVerticesAfter  = 0;
+    ui32 meshesWith16BitIndices    = 0;
+    for (const auto& importedMesh : importedMeshes)
+    {
+        triangleCount             += importedMesh.IndexCount / 3;
+        transformedVerticesBefore += importedMesh.TransformedVerticesBefore;
+        transformedVerticesAfter  += importedMesh.TransformedVerticesAfter;
+        meshesWith16BitIndices    += importedMesh.IndexDataFormat == IndexFormat::UInt16 ? 1 : 0;
+    }
+    if (triangleCount != 0)
     {
-        const auto assimpMesh = scene->mMeshes[i];
+        LOG_INFO(
+            "Model: {}, ACMR {:.3f} -> {:.3f} (FIFO {}), {} of {} meshes have 16 bit indices",
+            modelPath,
+            f64(transformedVerticesBefore) / f64(triangleCount),
+            f64(transformedVerticesAfter) / f64(triangleCount),
+            MeshOptimizer::k_FifoCacheSize,
+            meshesWith16BitIndices,
+            numMeshes
+        );
+    }
+}
 
-        SNV_ASSERT(assimpMesh->HasFaces(), "LOL");
-        SNV_ASSERT(assimpMesh->HasPositions(), "LOL");
-        SNV_ASSERT(assimpMesh->HasNormals(), "LOL");
+MeshCache::MaterialRecord ConvertAssimpMaterial(const aiMaterial* assimpMaterial)
+{
+    MeshCache::MaterialRecord materialRecord = {
+        .Name = assimpMaterial->GetName().C_Str(),
+    };
 
-        const auto numVertices     = assimpMesh->mNumVertices;
-        const auto numFaces        = assimpMesh->mNumFaces;
-        // TODO(v.matushkin): Makes assumption that we have 3 indices per face, which should be fine with aiProcess_Triangulate
-        //  but seems like there is some shit with lines and points
-        const auto indexBufferSize = numFaces * 3;
-        auto       indexData       = std::make_unique<ui32[]>(indexBufferSize);
-        auto       indexDataPtr    = indexData.get();
+    // Get Material BaseColorMap
+    const auto diffuseTexturesCount = assimpMaterial->GetTextureCount(aiTextureType::aiTextureType_DIFFUSE);
+    if (diffuseTexturesCount > 0)
+    {
+        materialRecord.BaseColorMapPath = GetAssimpMaterialTexturePath(assimpMaterial, aiTextureType::aiTextureType_DIFFUSE).C_Str();
 
-        i32 indexCount = 0;
-        for (ui32 i = 0; i < numFaces; ++i)
+        if (diffuseTexturesCount != 1)
         {
-            const auto& face = assimpMesh->mFaces[i];
-            for (ui32 j = 0; j < face.mNumIndices; ++j)
-            {
-                indexDataPtr[indexCount++] = face.mIndices[j];
-            }
+            LOG_WARN("Material: {}, has {} BaseColor textures", materialRecord.Name, diffuseTexturesCount);
         }
+    }
+    else
+    {
+        LOG_WARN("Material: {}, has 0 baseColor textures, using default Black texture", materialRecord.Name);
+    }
+    // Get Material NormalMap
+    const auto normalTexturesCount = assimpMaterial->GetTextureCount(aiTextureType::aiTextureType_NORMALS);
+    if (normalTexturesCount > 0)
+    {
+        materialRecord.NormalMapPath = GetAssimpMaterialTexturePath(assimpMaterial, aiTextureType::aiTextureType_NORMALS).C_Str();
 
-        std::vector<VertexAttributeDesc> vertexLayout;
-        ui32 vertexBufferSize = 0;
-
-        // Vertex Positions Layout
+        if (normalTexturesCount != 1)
         {
-            VertexAttributeDesc positionAttributeDesc = {
-                .Attribute = VertexAttribute::Position,
-                .Format    = VertexAttributeFormat::Float32,
-                .Dimension = AssimpConstants::PositionDimension,
-                .Offset    = vertexBufferSize,
-            };
-            vertexLayout.push_back(positionAttributeDesc);
-
-            vertexBufferSize += numVertices * AssimpConstants::PositionSize;
+            LOG_WARN("Material: {}, has {} Normal textures", materialRecord.Name, normalTexturesCount);
         }
-        // Vertex Normals Layout
-        {
-            VertexAttributeDesc normalAttributeDesc = {
-                .Attribute = VertexAttribute::Normal,
-                .Format    = VertexAttributeFormat::Float32,
-                .Dimension = AssimpConstants::NormalDimension,
-                .Offset    = vertexBufferSize,
-            };
-            vertexLayout.push_back(normalAttributeDesc);
+    }
+    else
+    {
+        LOG_WARN("Material: {}, has 0 normal textures, using default Normal texture", materialRecord.Name);
+    }
 
-            vertexBufferSize += numVertices * AssimpConstants::NormalSize;
-        }
-        // Vertex TexCoord0 Layout
-        // TODO(v.matushkin): Texture coords copying should be reworked
-        //   There is no need for Float32 uv(as far as I know)
-        if (assimpMesh->HasTextureCoords(0))
+    return materialRecord;
+}
+
+// NOTE(v.matushkin): Called from the worker threads, must not touch the Renderer or AssetDatabase
+MeshImportData ConvertAssimpMesh(const aiMesh* assimpMesh)
+{
+    PROFILE_ZONE("ConvertAssimpMesh");
+
+    SNV_ASSERT(assimpMesh->HasFaces(), "LOL");
+    SNV_ASSERT(assimpMesh->HasPositions(), "LOL");
+    SNV_ASSERT(assimpMesh->HasNormals(), "LOL");
+
+    const auto numFaces = assimpMesh->mNumFaces;
+    // NOTE(v.matushkin): Allocated for UInt32, UInt16 indices are narrowed in place
+    auto       indexData    = std::make_unique<ui8[]>(numFaces * 3 * sizeof(ui32));
+    const auto indexDataPtr = reinterpret_cast<ui32*>(indexData.get());
+
+    // NOTE(v.matushkin): aiProcess_Triangulate still leaves lines and points, they are skipped,
+    //  it's a triangle list and the optimizer works on triangles
+    ui32 indexCount = 0;
+    for (ui32 i = 0; i < numFaces; ++i)
+    {
+        const auto& face = assimpMesh->mFaces[i];
+        if (face.mNumIndices == 3)
         {
-            VertexAttributeDesc texCoord0AttributeDesc = {
-                .Attribute = VertexAttribute::TexCoord0,
-                .Format    = VertexAttributeFormat::Float32,
-                .Dimension = AssimpConstants::TexCoord0Dimension,
-                .Offset    = vertexBufferSize,
-            };
-            vertexLayout.push_back(texCoord0AttributeDesc);
+            indexDataPtr[indexCount++] = face.mIndices[0];
+            indexDataPtr[indexCount++] = face.mIndices[1];
+            indexDataPtr[indexCount++] = face.mIndices[2];
+        }
+    }
+    const auto indices = std::span(indexDataPtr, indexCount);
+
+    //- Optimize
+    // NOTE(v.matushkin): vertexOrder[i] is the assimp vertex that becomes the vertex i
+    ui32              numVertices = assimpMesh->mNumVertices;
+    std::vector<ui32> vertexOrder;
+
+    const auto transformedVerticesBefore = MeshOptimizer::CountTransformedVertices(indices, numVertices);
 
-            vertexBufferSize += numVertices * AssimpConstants::TexCoord0Size;
+    if (k_MeshImportSettings.OptimizeMesh)
+    {
+        MeshOptimizer::OptimizeVertexCache(indices, numVertices);
+        MeshOptimizer::OptimizeOverdraw(indices, &assimpMesh->mVertices[0].x, sizeof(aiVector3D));
+        numVertices = MeshOptimizer::OptimizeVertexFetch(indices, numVertices, vertexOrder);
+    }
+    else
+    {
+        vertexOrder.resize(numVertices);
+        for (ui32 i = 0; i < numVertices; ++i)
+        {
+            vertexOrder[i] = i;
         }
+    }
 
-        // TODO: What type should I use?
-        auto vertexData    = std::make_unique<ui8[]>(vertexBufferSize);
-        auto vertexDataPtr = vertexData.get();
+    const auto transformedVerticesAfter = MeshOptimizer::CountTransformedVertices(indices, numVertices);
+
+    auto indexFormat = IndexFormat::UInt32;
+    if (k_MeshImportSettings.Allow16BitIndices && numVertices <= std::numeric_limits<ui16>::max() + 1u)
+    {
+        indexFormat = IndexFormat::UInt16;
 
-        // Get Vertex Positions
+        // NOTE(v.matushkin): Writes never get ahead of reads, so it's fine to do in place
+        for (ui32 i = 0; i < indexCount; ++i)
         {
-            const auto bytesToCopy = numVertices * AssimpConstants::PositionSize;
-            std::memcpy(vertexDataPtr, assimpMesh->mVertices, bytesToCopy);
-            vertexDataPtr += bytesToCopy;
+            const auto index16 = static_cast<ui16>(indexDataPtr[i]);
+            std::memcpy(indexData.get() + i * sizeof(ui16), &index16, sizeof(ui16));
         }
-        // Get Vertex Normals
+    }
+
+    AABB bounds = {
+        .Min = glm::vec3(std::numeric_limits<f32>::max()),
+        .Max = glm::vec3(std::numeric_limits<f32>::lowest()),
+    };
+    for (const auto assimpVertex : vertexOrder)
+    {
+        const auto& position = assimpMesh->mVertices[assimpVertex];
+        bounds.Min.x = std::min(bounds.Min.x, position.x);
+        bounds.Min.y = std::min(bounds.Min.y, position.y);
+        bounds.Min.z = std::min(bounds.Min.z, position.z);
+        bounds.Max.x = std::max(bounds.Max.x, position.x);
+        bounds.Max.y = std::max(bounds.Max.y, position.y);
+        bounds.Max.z = std::max(bounds.Max.z, position.z);
+    }
+
+    //- Vertex Layout
+    // NOTE(v.matushkin): TexCoord0 is always there, zeros if the mesh doesn't have it,
+    //  so every mesh has the same vertex format and backends can build one pipeline for all of them
+    const auto isPacked = k_MeshImportSettings.PackAttributes;
+
+    std::vector<VertexAttributeDesc> vertexLayout = {
+        VertexAttributeDesc{
+            .Attribute  = VertexAttribute::Position,
+            .Format     = VertexAttributeFormat::Float32,
+            .Dimension  = AssimpConstants::PositionDimension,
+            .Normalized = false,
+        },
+        // NOTE(v.matushkin): 4 components for the packed normal, there are no 3 component 16 bit formats in DXGI
+        VertexAttributeDesc{
+            .Attribute  = VertexAttribute::Normal,
+            .Format     = isPacked ? VertexAttributeFormat::Int16 : VertexAttributeFormat::Float32,
+            .Dimension  = ui8(isPacked ? 4 : AssimpConstants::NormalDimension),
+            .Normalized = isPacked,
+        },
+        VertexAttributeDesc{
+            .Attribute  = VertexAttribute::TexCoord0,
+            .Format     = isPacked ? VertexAttributeFormat::Float16 : VertexAttributeFormat::Float32,
+            .Dimension  = 2,
+            .Normalized = false,
+        },
+    };
+
+    ui32 vertexSize = 0;
+    for (const auto& vertexAttribute : vertexLayout)
+    {
+        vertexSize += GetVertexAttributeSize(vertexAttribute);
+    }
+
+    ui32 attributeOffset = 0;
+    for (auto& vertexAttribute : vertexLayout)
+    {
+        const auto attributeSize = GetVertexAttributeSize(vertexAttribute);
+
+        vertexAttribute.Offset = attributeOffset;
+        if (k_MeshImportSettings.InterleaveAttributes)
         {
-            const auto bytesToCopy = numVertices * AssimpConstants::NormalSize;
-            std::memcpy(vertexDataPtr, assimpMesh->mNormals, bytesToCopy);
-            vertexDataPtr += bytesToCopy;
+            vertexAttribute.Stride  = vertexSize;
+            attributeOffset        += attributeSize;
         }
-        // Get Vertex TexCoord0
-        if (assimpMesh->HasTextureCoords(0))
+        else
         {
-            const auto bytesToCopy = numVertices * AssimpConstants::TexCoord0Size;
-            std::memcpy(vertexDataPtr, assimpMesh->mTextureCoords[0], bytesToCopy);
-            vertexDataPtr += bytesToCopy;
+            vertexAttribute.Stride  = attributeSize;
+            attributeOffset        += attributeSize * numVertices;
         }
+    }
 
-        auto mesh = std::make_shared<Mesh>(indexCount, std::move(indexData), numVertices, std::move(vertexData), vertexLayout);
+    //- Vertex Data
+    const auto& positionDesc  = vertexLayout[0];
+    const auto& normalDesc    = vertexLayout[1];
+    const auto& texCoord0Desc = vertexLayout[2];
+    const auto  hasTexCoord0  = assimpMesh->HasTextureCoords(0);
 
-        GameObject gameObject;
-        gameObject.AddComponent<MeshRenderer>(materials[assimpMesh->mMaterialIndex], mesh);
+    const ui32 vertexBufferSize = vertexSize * numVertices;
+    auto       vertexData       = std::make_unique<ui8[]>(vertexBufferSize);
+    auto       vertexDataPtr    = vertexData.get();
 
-        modelGameObjects.emplace_back(gameObject);
+    for (ui32 i = 0; i < numVertices; ++i)
+    {
+        const auto  assimpVertex = vertexOrder[i];
+        const auto& position     = assimpMesh->mVertices[assimpVertex];
+        const auto& normal       = assimpMesh->mNormals[assimpVertex];
+        const auto  texCoord0    = hasTexCoord0 ? assimpMesh->mTextureCoords[0][assimpVertex] : aiVector3D(0.0f);
+
+        auto positionPtr  = vertexDataPtr + positionDesc.Offset + i * positionDesc.Stride;
+        auto normalPtr    = vertexDataPtr + normalDesc.Offset + i * normalDesc.Stride;
+        auto texCoord0Ptr = vertexDataPtr + texCoord0Desc.Offset + i * texCoord0Desc.Stride;
+
+        std::memcpy(positionPtr, &position, AssimpConstants::PositionSize);
+
+        if (isPacked)
+        {
+            const ui16 packedNormal[]    = {glm::packSnorm1x16(normal.x), glm::packSnorm1x16(normal.y), glm::packSnorm1x16(normal.z), 0};
+            const ui16 packedTexCoord0[] = {glm::packHalf1x16(texCoord0.x), glm::packHalf1x16(texCoord0.y)};
+            std::memcpy(normalPtr, packedNormal, sizeof(packedNormal));
+            std::memcpy(texCoord0Ptr, packedTexCoord0, sizeof(packedTexCoord0));
+        }
+        else
+        {
+            const f32 texCoord0Data[] = {texCoord0.x, texCoord0.y};
+            std::memcpy(normalPtr, &normal, AssimpConstants::NormalSize);
+            std::memcpy(texCoord0Ptr, texCoord0Data, sizeof(texCoord0Data));
+        }
     }
 
-    return Model(std::move(modelGameObjects));
+    return MeshImportData{
+        .IndexCount                = static_cast<i32>(indexCount),
+        .IndexDataSize             = indexCount * GetIndexFormatSize(indexFormat),
+        .IndexData                 = std::move(indexData),
+        .IndexDataFormat           = indexFormat,
+        .VertexCount               = static_cast<i32>(numVertices),
+        .VertexDataSize            = vertexBufferSize,
+        .VertexData                = std::move(vertexData),
+        .VertexLayout              = std::move(vertexLayout),
+        .Bounds                    = bounds,
+        .MaterialIndex             = assimpMesh->mMaterialIndex,
+        .TransformedVerticesBefore = transformedVerticesBefore,
+        .TransformedVerticesAfter  = transformedVerticesAfter,
+    };
 }
 
-Texture AssetDatabase::LoadTexture(const std::string& texturePath)
+// NOTE(v.matushkin): Called from the worker threads, stbi_set_flip_vertically_on_load() must be set before.
+//  Returns a CookedTexture with empty Data if the source can't be read, the caller falls back to the black texture
+TextureCache::CookedTexture ImportTexture(const std::string& texturePath, const std::string& sourcePath, const std::string& cachePath)
 {
-    stbi_set_flip_vertically_on_load(true); // TODO(v.matushkin): Set only once
+    PROFILE_ZONE("ImportTexture");
+
+    TextureCache::CookedTexture cookedTexture;
+
+    // NOTE(v.matushkin): The same mapping is hashed and decoded, so the cache always matches what was imported
+    const MappedFile sourceFile(sourcePath);
+    if (sourceFile.IsValid() == false)
+    {
+        LOG_ERROR("Texture: {}, can't open the source {}", texturePath, sourcePath);
+        return cookedTexture;
+    }
+
+    const auto sourceData = sourceFile.GetData();
+    const auto sourceHash = HashBytes(sourceData);
+
+    if (TextureCache::Read(cachePath, sourceHash, cookedTexture))
+    {
+        return cookedTexture;
+    }
 
-    // TODO(v.matushkin): Asset class shouldn't handle path adjusting
-    std::string fullPath = "../../assets/models/Sponza/" + texturePath;
+    const auto stbSourceData = reinterpret_cast<const stbi_uc*>(sourceData.data());
+    const auto stbSourceSize = static_cast<i32>(sourceData.size());
 
     i32 width, height, numComponents;
-    // TODO(v.matushkin): Check for errors
-    stbi_info(fullPath.c_str(), &width, &height, &numComponents);
+    if (stbi_info_from_memory(stbSourceData, stbSourceSize, &width, &height, &numComponents) == 0)
+    {
+        LOG_ERROR("Texture: {}, can't decode {}: {}", texturePath, sourcePath, stbi_failure_reason());
+        return cookedTexture;
+    }
     // TODO(v.matushkin): TextureGraphicsFormat selection need to be more robust
     // TODO(v.matushkin): Make SNV_ASSERT take formatting arguments, so here texturePath can be logged
     SNV_ASSERT(numComponents == 3 || numComponents == 4, "Right now only Textures with 3 or 4 channels are supported");
     const i32 desiredComponents = numComponents == 3 ? 4 : numComponents;
 
-    ui8* stbImageData = stbi_load(fullPath.c_str(), &width, &height, &numComponents, desiredComponents);
+    ui8* stbImageData = stbi_load_from_memory(stbSourceData, stbSourceSize, &width, &height, &numComponents, desiredComponents);
     SNV_ASSERT(stbImageData != nullptr, stbi_failure_reason());
 
-    // NOTE(v.matushkin): Not sure about this dances with memory
-    const auto textureSize = width * height * desiredComponents;
-    auto       textureData = std::make_unique<ui8[]>(textureSize);
-    std::memcpy(textureData.get(), stbImageData, textureSize);
-    stbi_image_free(stbImageData);
-
     // TODO(v.matushkin): Load Sponza textures as R8G8B8A8_SRGB ?
     // NOTE(v.matushkin): TextureWrapMode::Repeat by default?
-    TextureDesc textureDesc = {
+    cookedTexture.Desc = {
         .Width    = static_cast<ui32>(width),
         .Height   = static_cast<ui32>(height),
+        .MipCount = GetFullMipCount(width, height),
         .Format   = TextureFormat::RGBA8,
-        .WrapMode = TextureWrapMode::Repeat
+        .WrapMode = TextureWrapMode::Repeat,
     };
 
-    return Texture(textureDesc, std::move(textureData));
-}
-
-// TODO(v.matushkin): Improve this shit with passes/loading(don't know what did I mean by that)
-//  Thats why there should be only one shader language I guess
-//  Or at least there should some static AppSettings class or something, so there is no need to access Renderer
-Shader AssetDatabase::LoadShader(const std::string& shaderName)
-{
-    const auto graphicsApi = Renderer::GetGraphicsApi();
+    // NOTE(v.matushkin): stb allocates only the mip 0, so it has to be copied into the full mip chain anyway
+    const auto textureSize = GetTextureSize(cookedTexture.Desc);
+    cookedTexture.OwnedData = std::make_unique<ui8[]>(textureSize);
+    std::memcpy(cookedTexture.OwnedData.get(), stbImageData, GetMipSize(cookedTexture.Desc, 0));
+    stbi_image_free(stbImageData);
 
-    std::string shaderPath;
-    std::string shaderExtension;
-    if (graphicsApi == GraphicsApi::DirectX11 || graphicsApi == GraphicsApi::DirectX12)
-    {
-        shaderExtension = ".hlsl";
-        shaderPath      = m_dxShaderDir;
-    }
-    else
-    {
-        shaderExtension = ".glsl";
-        shaderPath      = graphicsApi == GraphicsApi::OpenGL ? m_glShaderDir : m_vkShaderDir;
-    }
-    shaderPath += shaderName;
+    const std::span<ui8> textureData(cookedTexture.OwnedData.get(), textureSize);
+    TextureCache::GenerateMipChain(cookedTexture.Desc, textureData);
+    cookedTexture.Data = textureData;
 
-    // Get Vertex Shader
-    const std::string vertexPath(shaderPath + "_vs" + shaderExtension);
-    const auto        vertexSize   = std::filesystem::file_size(vertexPath);
-    auto              vertexSource = std::make_unique<char[]>(vertexSize + 1);
-    {
-        std::ifstream vertexFile(vertexPath, std::ios::binary | std::ios::in);
-        vertexFile.read(vertexSource.get(), vertexSize);
-    }
-    // Get Fragment Shader
-    const std::string fragmentPath(shaderPath + "_fs" + shaderExtension);
-    const auto        fragmentSize   = std::filesystem::file_size(fragmentPath);
-    auto              fragmentSource = std::make_unique<char[]>(fragmentSize + 1);
+    if (TextureCache::Write(cachePath, sourceHash, cookedTexture.Desc, cookedTexture.Data) == false)
     {
-        std::ifstream fragmentFile(fragmentPath, std::ios::binary | std::ios::in);
-        fragmentFile.read(fragmentSource.get(), fragmentSize);
+        LOG_WARN("Texture: {}, failed to write the cache", texturePath);
     }
 
-    return Shader(
-        std::span(vertexSource.get(), vertexSize),
-        std::span(fragmentSource.get(), fragmentSize)
-    );
+    return cookedTexture;
 }
 
-
-std::vector<std::shared_ptr<Material>> GetAssimpMaterials(const aiScene* scene, ShaderPtr shader)
+ui64 HashFile(const std::string& filePath)
 {
-    SNV_ASSERT(scene->HasMaterials(), "LOL");
-
-    std::vector<std::shared_ptr<Material>> materials;
-    const auto numMaterials = scene->mNumMaterials;
+    const MappedFile file(filePath);
+    return file.IsValid() ? HashBytes(file.GetData()) : 0;
+}
 
-    for (ui32 i = 0; i < numMaterials; ++i)
+// NOTE(v.matushkin): std::string keeps the source null terminated, glslang and glShaderSource want that
+std::string ReadShaderSource(const std::string& sourcePath)
+{
+    std::error_code errorCode;
+    const auto      sourceSize = std::filesystem::file_size(sourcePath, errorCode);
+    if (errorCode)
     {
-        const auto assimpMaterial     = scene->mMaterials[i];
-        const auto assimpMaterialName = assimpMaterial->GetName().C_Str();
-        auto       material           = std::make_shared<Material>(shader);
-        material->SetName(assimpMaterialName);
-
-        // Get Material BaseColorMap
-        const auto diffuseTexturesCount = assimpMaterial->GetTextureCount(aiTextureType::aiTextureType_DIFFUSE);
-        if (diffuseTexturesCount > 0)
-        {
-            const auto texturePath = GetAssimpMaterialTexturePath(assimpMaterial, aiTextureType::aiTextureType_DIFFUSE);
-            material->SetBaseColorMap(AssetDatabase::LoadAsset<Texture>(texturePath.C_Str()));
-
-            if (diffuseTexturesCount != 1)
-            {
-                LOG_WARN("Material: {}, has {} BaseColor textures", assimpMaterialName, diffuseTexturesCount);
-            }
-        }
-        else
-        {
-            LOG_WARN("Material: {}, has 0 baseColor textures, using default Black texture", assimpMaterialName);
-            material->SetBaseColorMap(Texture::GetBlackTexture());
-        }
-        // Get Material NormalMap
-        const auto normalTexturesCount = assimpMaterial->GetTextureCount(aiTextureType::aiTextureType_NORMALS);
-        if (normalTexturesCount > 0)
-        {
-            const auto texturePath = GetAssimpMaterialTexturePath(assimpMaterial, aiTextureType::aiTextureType_NORMALS);
-            material->SetNormalMap(AssetDatabase::LoadAsset<Texture>(texturePath.C_Str()));
-
-            if (normalTexturesCount != 1)
-            {
-                LOG_WARN("Material: {}, has {} Normal textures", assimpMaterialName, diffuseTexturesCount);
-            }
-        }
-        else
-        {
-            LOG_WARN("Material: {}, has 0 normal textures, using default Normal texture", assimpMaterialName);
-            material->SetNormalMap(Texture::GetNormalTexture());
-        }
+        LOG_ERROR("Can't read {}, error: {}", sourcePath, errorCode.message());
+        return {};
+    }
 
-        materials.emplace_back(material);
+    std::string source(sourceSize, '\0');
+    {
+        std::ifstream sourceFile(sourcePath, std::ios::binary | std::ios::in);
+        sourceFile.read(source.data(), sourceSize);
     }
 
-    return materials;
+    return source;
 }
 
 } // namespace snv
@@ -1,7 +1,6 @@
 #include <Engine/Assets/Mesh.hpp>
 #include <Engine/Renderer/Renderer.hpp>
 
-#include <span>
 #include <utility>
 
 
@@ -9,42 +8,31 @@ namespace snv
 {
 
 Mesh::Mesh(
-    i32 indexCount, std::unique_ptr<ui32[]>&& indexData,
-    i32 vertexCount, std::unique_ptr<ui8[]>&& vertexData,
-    const std::vector<VertexAttributeDesc>& vertexLayout
+    std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
+    i32                                     vertexCount,
+    std::span<const std::byte>              vertexData,
+    const std::vector<VertexAttributeDesc>& vertexLayout,
+    const AABB&                             bounds
 )
-    : m_indexData(std::move(indexData))
-    , m_vertexData(std::move(vertexData))
-    , m_indexCount(indexCount)
+    : m_indexCount(static_cast<i32>(indexData.size_bytes() / GetIndexFormatSize(indexFormat)))
     , m_vertexCount(vertexCount)
-{
-    i32 vertexDataElements = 0;
-    for (const auto& vertexAttribute : vertexLayout)
-    {
-        vertexDataElements += vertexCount * (vertexAttribute.Dimension * sizeof(f32));
-    }
-
-    m_bufferHandle = Renderer::CreateBuffer(
-        std::as_bytes(std::span(m_indexData.get(), m_indexCount)),
-        std::as_bytes(std::span(m_vertexData.get(), vertexDataElements)),
-        vertexLayout
-    );
-}
+    , m_bounds(bounds)
+    , m_bufferHandle(Renderer::CreateBuffer(indexData, indexFormat, vertexData, vertexLayout))
+{}
 
 Mesh::Mesh(Mesh&& other) noexcept
-    : m_indexData(std::exchange(other.m_indexData, nullptr))
-    , m_vertexData(std::exchange(other.m_vertexData, nullptr))
-    , m_indexCount(std::exchange(other.m_indexCount, -1))
+    : m_indexCount(std::exchange(other.m_indexCount, -1))
     , m_vertexCount(std::exchange(other.m_vertexCount, -1))
+    , m_bounds(other.m_bounds)
     , m_bufferHandle(std::exchange(other.m_bufferHandle, BufferHandle::InvalidHandle))
 {}
 
 Mesh& Mesh::operator=(Mesh&& other) noexcept
 {
-    m_indexData  = std::exchange(other.m_indexData, nullptr);
-    m_vertexData = std::exchange(other.m_vertexData, nullptr);
-    m_indexCount  = std::exchange(other.m_indexCount, -1);
-    m_vertexCount = std::exchange(other.m_vertexCount, -1);
+    m_indexCount   = std::exchange(other.m_indexCount, -1);
+    m_vertexCount  = std::exchange(other.m_vertexCount, -1);
+    m_bounds       = other.m_bounds;
     m_bufferHandle = std::exchange(other.m_bufferHandle, BufferHandle::InvalidHandle);
 
     return *this;
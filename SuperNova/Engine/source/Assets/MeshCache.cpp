@@ -0,0 +1,391 @@
+#include <Engine/Assets/MeshCache.hpp>
+
+#include <Engine/Core/Log.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+
+namespace
+{
+
+constexpr ui32 k_Magic               = 0x4D564E53; // 'SNVM'
+constexpr ui32 k_Version             = 5;
+constexpr ui32 k_MaxVertexAttributes = 8;
+constexpr ui64 k_DataAlignment       = 16;
+
+
+struct FileHeader
+{
+    ui32 Magic;
+    ui32 Version;
+    ui64 SourceHash;
+    ui32 MaterialCount;
+    ui32 MeshCount;
+    ui64 StringTableOffset;
+    ui64 StringTableSize;
+};
+
+struct FileString
+{
+    ui32 Offset;
+    ui32 Size;
+};
+
+struct FileMaterial
+{
+    FileString Name;
+    FileString BaseColorMapPath;
+    FileString NormalMapPath;
+};
+
+// NOTE(v.matushkin): Not using VertexAttributeDesc directly, its padding bytes would end up in the file
+struct FileVertexAttribute
+{
+    ui8  Attribute;
+    ui8  Format;
+    ui8  Dimension;
+    ui8  Normalized;
+    ui32 Offset;
+    ui32 Stride;
+};
+
+struct FileMesh
+{
+    ui32                MaterialIndex;
+    i32                 VertexCount;
+    ui32                IndexCount;
+    ui32                IndexFormat;
+    ui32                VertexAttributeCount;
+    ui32                _Padding;
+    FileVertexAttribute VertexLayout[k_MaxVertexAttributes];
+    ui64                IndexDataOffset;
+    ui64                VertexDataOffset;
+    ui64                VertexDataSize;
+    f32                 BoundsMin[3];
+    f32                 BoundsMax[3];
+};
+
+
+ui64 AlignUp(ui64 value, ui64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool IsInFile(ui64 offset, ui64 size, ui64 fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+// NOTE(v.matushkin): The backends index their format tables with these, so a bad enum must never get out of Read().
+//  Covers both layouts, interleaved attributes have Offset < Stride, planar ones start their stream at Offset
+bool IsValidVertexAttribute(const FileVertexAttribute& fileAttribute, i32 vertexCount, ui64 vertexDataSize)
+{
+    if (fileAttribute.Attribute >= static_cast<ui8>(snv::VertexAttribute::Count)
+        || fileAttribute.Format > static_cast<ui8>(snv::VertexAttributeFormat::Float64)
+        || fileAttribute.Dimension < 1
+        || fileAttribute.Dimension > 4)
+    {
+        return false;
+    }
+
+    const auto attributeSize = ui64(snv::GetVertexAttributeFormatSize(static_cast<snv::VertexAttributeFormat>(fileAttribute.Format)))
+                             * fileAttribute.Dimension;
+    if (attributeSize > fileAttribute.Stride)
+    {
+        return false;
+    }
+    if (vertexCount == 0)
+    {
+        return true;
+    }
+
+    // NOTE(v.matushkin): The attribute of the last vertex has to end inside of the vertex data
+    const auto lastAttributeOffset = ui64(fileAttribute.Offset) + ui64(vertexCount - 1) * fileAttribute.Stride;
+    return IsInFile(lastAttributeOffset, attributeSize, vertexDataSize);
+}
+
+} // namespace
+
+
+namespace snv::MeshCache
+{
+
+bool Read(const std::string& cachePath, ui64 sourceHash, CookedModel& cookedModel)
+{
+    MappedFile cacheFile(cachePath);
+    if (cacheFile.IsValid() == false)
+    {
+        return false;
+    }
+
+    const auto fileData = cacheFile.GetData();
+    const auto fileSize = fileData.size();
+    const auto fileBase = fileData.data();
+
+    if (fileSize < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, fileBase, sizeof(FileHeader));
+
+    if (header.Magic != k_Magic || header.Version != k_Version)
+    {
+        LOG_INFO("MeshCache: {} has an old format, it will be recooked", cachePath);
+        return false;
+    }
+    if (header.SourceHash != sourceHash)
+    {
+        LOG_INFO("MeshCache: {} is stale, it will be recooked", cachePath);
+        return false;
+    }
+
+    const ui64 materialsOffset = sizeof(FileHeader);
+    const ui64 meshesOffset    = materialsOffset + ui64(header.MaterialCount) * sizeof(FileMaterial);
+    if (IsInFile(materialsOffset, ui64(header.MaterialCount) * sizeof(FileMaterial), fileSize) == false
+        || IsInFile(meshesOffset, ui64(header.MeshCount) * sizeof(FileMesh), fileSize) == false
+        || IsInFile(header.StringTableOffset, header.StringTableSize, fileSize) == false)
+    {
+        LOG_WARN("MeshCache: {} is corrupted, it will be recooked", cachePath);
+        return false;
+    }
+
+    const auto stringTable = reinterpret_cast<const char*>(fileBase + header.StringTableOffset);
+    bool       isCorrupted = false;
+    const auto getString   = [&](FileString fileString) -> std::string {
+        if (IsInFile(fileString.Offset, fileString.Size, header.StringTableSize) == false)
+        {
+            isCorrupted = true;
+            return {};
+        }
+        return std::string(stringTable + fileString.Offset, fileString.Size);
+    };
+
+    std::vector<MaterialRecord> materials(header.MaterialCount);
+    for (ui32 i = 0; i < header.MaterialCount; ++i)
+    {
+        FileMaterial fileMaterial;
+        std::memcpy(&fileMaterial, fileBase + materialsOffset + i * sizeof(FileMaterial), sizeof(FileMaterial));
+
+        materials[i] = MaterialRecord{
+            .Name             = getString(fileMaterial.Name),
+            .BaseColorMapPath = getString(fileMaterial.BaseColorMapPath),
+            .NormalMapPath    = getString(fileMaterial.NormalMapPath),
+        };
+    }
+
+    std::vector<MeshRecord> meshes(header.MeshCount);
+    for (ui32 i = 0; i < header.MeshCount; ++i)
+    {
+        FileMesh fileMesh;
+        std::memcpy(&fileMesh, fileBase + meshesOffset + i * sizeof(FileMesh), sizeof(FileMesh));
+
+        const auto indexFormat = static_cast<IndexFormat>(fileMesh.IndexFormat);
+
+        if (fileMesh.MaterialIndex >= header.MaterialCount
+            || fileMesh.VertexCount < 0
+            || fileMesh.VertexAttributeCount > k_MaxVertexAttributes
+            || fileMesh.IndexFormat > static_cast<ui32>(IndexFormat::UInt32)
+            || IsInFile(fileMesh.IndexDataOffset, ui64(fileMesh.IndexCount) * GetIndexFormatSize(indexFormat), fileSize) == false
+            || IsInFile(fileMesh.VertexDataOffset, fileMesh.VertexDataSize, fileSize) == false)
+        {
+            isCorrupted = true;
+            break;
+        }
+
+        auto& mesh = meshes[i];
+        mesh.IndexData       = fileData.subspan(fileMesh.IndexDataOffset, ui64(fileMesh.IndexCount) * GetIndexFormatSize(indexFormat));
+        mesh.IndexDataFormat = indexFormat;
+        mesh.VertexData      = fileData.subspan(fileMesh.VertexDataOffset, fileMesh.VertexDataSize);
+        mesh.VertexCount     = fileMesh.VertexCount;
+        mesh.Bounds          = AABB{
+            .Min = glm::vec3(fileMesh.BoundsMin[0], fileMesh.BoundsMin[1], fileMesh.BoundsMin[2]),
+            .Max = glm::vec3(fileMesh.BoundsMax[0], fileMesh.BoundsMax[1], fileMesh.BoundsMax[2]),
+        };
+        mesh.MaterialIndex   = fileMesh.MaterialIndex;
+
+        mesh.VertexLayout.reserve(fileMesh.VertexAttributeCount);
+        for (ui32 j = 0; j < fileMesh.VertexAttributeCount; ++j)
+        {
+            const auto& fileAttribute = fileMesh.VertexLayout[j];
+            if (IsValidVertexAttribute(fileAttribute, fileMesh.VertexCount, fileMesh.VertexDataSize) == false)
+            {
+                isCorrupted = true;
+                break;
+            }
+
+            mesh.VertexLayout.push_back(VertexAttributeDesc{
+                .Attribute  = static_cast<VertexAttribute>(fileAttribute.Attribute),
+                .Format     = static_cast<VertexAttributeFormat>(fileAttribute.Format),
+                .Dimension  = fileAttribute.Dimension,
+                .Normalized = fileAttribute.Normalized != 0,
+                .Offset     = fileAttribute.Offset,
+                .Stride     = fileAttribute.Stride,
+            });
+        }
+        if (isCorrupted)
+        {
+            break;
+        }
+    }
+
+    if (isCorrupted)
+    {
+        LOG_WARN("MeshCache: {} is corrupted, it will be recooked", cachePath);
+        return false;
+    }
+
+    cookedModel.File      = std::move(cacheFile);
+    cookedModel.Materials = std::move(materials);
+    cookedModel.Meshes    = std::move(meshes);
+
+    return true;
+}
+
+bool Write(
+    const std::string&              cachePath,
+    ui64                            sourceHash,
+    std::span<const MaterialRecord> materials,
+    std::span<const MeshRecord>     meshes
+)
+{
+    //- Layout
+    std::string               stringTable;
+    std::vector<FileMaterial> fileMaterials;
+
+    const auto addString = [&stringTable](const std::string& string) -> FileString {
+        const FileString fileString = {
+            .Offset = static_cast<ui32>(stringTable.size()),
+            .Size   = static_cast<ui32>(string.size()),
+        };
+        stringTable += string;
+        return fileString;
+    };
+
+    fileMaterials.reserve(materials.size());
+    for (const auto& material : materials)
+    {
+        fileMaterials.push_back(FileMaterial{
+            .Name             = addString(material.Name),
+            .BaseColorMapPath = addString(material.BaseColorMapPath),
+            .NormalMapPath    = addString(material.NormalMapPath),
+        });
+    }
+
+    const ui64 stringTableOffset = sizeof(FileHeader) + materials.size() * sizeof(FileMaterial) + meshes.size() * sizeof(FileMesh);
+    ui64       dataOffset        = AlignUp(stringTableOffset + stringTable.size(), k_DataAlignment);
+
+    std::vector<FileMesh> fileMeshes(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto& mesh     = meshes[i];
+        auto&       fileMesh = fileMeshes[i];
+
+        if (mesh.VertexLayout.size() > k_MaxVertexAttributes)
+        {
+            LOG_ERROR("MeshCache: mesh has {} vertex attributes, max is {}", mesh.VertexLayout.size(), k_MaxVertexAttributes);
+            return false;
+        }
+
+        fileMesh = FileMesh{
+            .MaterialIndex        = mesh.MaterialIndex,
+            .VertexCount          = mesh.VertexCount,
+            .IndexCount           = static_cast<ui32>(mesh.IndexData.size_bytes() / GetIndexFormatSize(mesh.IndexDataFormat)),
+            .IndexFormat          = static_cast<ui32>(mesh.IndexDataFormat),
+            .VertexAttributeCount = static_cast<ui32>(mesh.VertexLayout.size()),
+            ._Padding             = 0,
+            .VertexLayout         = {},
+            .IndexDataOffset      = dataOffset,
+            .VertexDataOffset     = AlignUp(dataOffset + mesh.IndexData.size_bytes(), k_DataAlignment),
+            .VertexDataSize       = mesh.VertexData.size_bytes(),
+            .BoundsMin            = {mesh.Bounds.Min.x, mesh.Bounds.Min.y, mesh.Bounds.Min.z},
+            .BoundsMax            = {mesh.Bounds.Max.x, mesh.Bounds.Max.y, mesh.Bounds.Max.z},
+        };
+        for (size_t j = 0; j < mesh.VertexLayout.size(); ++j)
+        {
+            const auto& vertexAttribute = mesh.VertexLayout[j];
+            fileMesh.VertexLayout[j] = FileVertexAttribute{
+                .Attribute  = static_cast<ui8>(vertexAttribute.Attribute),
+                .Format     = static_cast<ui8>(vertexAttribute.Format),
+                .Dimension  = vertexAttribute.Dimension,
+                .Normalized = static_cast<ui8>(vertexAttribute.Normalized),
+                .Offset     = vertexAttribute.Offset,
+                .Stride     = vertexAttribute.Stride,
+            };
+        }
+
+        dataOffset = AlignUp(fileMesh.VertexDataOffset + fileMesh.VertexDataSize, k_DataAlignment);
+    }
+
+    const FileHeader header = {
+        .Magic             = k_Magic,
+        .Version           = k_Version,
+        .SourceHash        = sourceHash,
+        .MaterialCount     = static_cast<ui32>(materials.size()),
+        .MeshCount         = static_cast<ui32>(meshes.size()),
+        .StringTableOffset = stringTableOffset,
+        .StringTableSize   = stringTable.size(),
+    };
+
+    //- Write
+    // NOTE(v.matushkin): Write into a temporary file first, so a crash can't leave a half written cache
+    const std::filesystem::path cacheFilePath(cachePath);
+    const std::filesystem::path tempFilePath(cachePath + ".tmp");
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(cacheFilePath.parent_path(), errorCode);
+
+    {
+        std::ofstream cacheFile(tempFilePath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (cacheFile.is_open() == false)
+        {
+            LOG_WARN("MeshCache: can't open {} for writing", tempFilePath.string());
+            return false;
+        }
+
+        const auto writePadding = [&cacheFile](ui64 alignedOffset) {
+            static constexpr char zeros[k_DataAlignment] = {};
+            const auto currentOffset = static_cast<ui64>(cacheFile.tellp());
+            cacheFile.write(zeros, alignedOffset - currentOffset);
+        };
+
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        cacheFile.write(reinterpret_cast<const char*>(fileMaterials.data()), fileMaterials.size() * sizeof(FileMaterial));
+        cacheFile.write(reinterpret_cast<const char*>(fileMeshes.data()), fileMeshes.size() * sizeof(FileMesh));
+        cacheFile.write(stringTable.data(), stringTable.size());
+
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            const auto& mesh     = meshes[i];
+            const auto& fileMesh = fileMeshes[i];
+
+            writePadding(fileMesh.IndexDataOffset);
+            cacheFile.write(reinterpret_cast<const char*>(mesh.IndexData.data()), mesh.IndexData.size_bytes());
+            writePadding(fileMesh.VertexDataOffset);
+            cacheFile.write(reinterpret_cast<const char*>(mesh.VertexData.data()), mesh.VertexData.size_bytes());
+        }
+
+        if (cacheFile.good() == false)
+        {
+            LOG_WARN("MeshCache: failed to write {}", tempFilePath.string());
+            cacheFile.close();
+            std::filesystem::remove(tempFilePath, errorCode);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, cacheFilePath, errorCode);
+    if (errorCode)
+    {
+        LOG_WARN("MeshCache: failed to rename {} to {}, error: {}", tempFilePath.string(), cachePath, errorCode.message());
+        std::filesystem::remove(tempFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace snv::MeshCache
@@ -0,0 +1,391 @@
+#include <Engine/Assets/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace
+{
+
+constexpr ui32 k_InvalidIndex = std::numeric_limits<ui32>::max();
+
+//- Forsyth scoring, values are from the original article
+// NOTE(v.matushkin): Simulated LRU cache, bigger than the FIFO in k_FifoCacheSize, it's only used for the scoring
+constexpr ui32 k_ScoringCacheSize   = 32;
+constexpr f32  k_CacheDecayPower    = 1.5f;
+constexpr f32  k_LastTriangleScore  = 0.75f;
+constexpr f32  k_ValenceBoostScale  = 2.0f;
+constexpr f32  k_ValenceBoostPower  = 0.5f;
+
+
+f32 ComputeVertexScore(i32 cachePosition, ui32 remainingTriangles)
+{
+    if (remainingTriangles == 0)
+    {
+        return -1.0f;
+    }
+
+    f32 score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // NOTE(v.matushkin): Vertices of the last triangle get a fixed score, so the next triangle doesn't just reuse them
+        if (cachePosition < 3)
+        {
+            score = k_LastTriangleScore;
+        }
+        else
+        {
+            const auto scaler = 1.0f / (k_ScoringCacheSize - 3);
+            score             = std::pow(1.0f - (cachePosition - 3) * scaler, k_CacheDecayPower);
+        }
+    }
+
+    // NOTE(v.matushkin): Boost vertices with few triangles left, so they are finished and don't leave lone triangles behind
+    score += k_ValenceBoostScale * std::pow(static_cast<f32>(remainingTriangles), -k_ValenceBoostPower);
+
+    return score;
+}
+
+
+struct Cluster
+{
+    ui32 FirstTriangle;
+    ui32 TriangleCount;
+    f32  SortKey;
+};
+
+} // namespace
+
+
+namespace snv::MeshOptimizer
+{
+
+ui32 CountTransformedVertices(std::span<const ui32> indices, ui32 vertexCount)
+{
+    // NOTE(v.matushkin): A vertex is in the FIFO if it was pushed less than k_FifoCacheSize pushes ago
+    std::vector<ui32> pushTimestamps(vertexCount, 0);
+    ui32              timestamp           = k_FifoCacheSize + 1;
+    ui32              transformedVertices = 0;
+
+    for (const auto index : indices)
+    {
+        if (timestamp - pushTimestamps[index] > k_FifoCacheSize)
+        {
+            pushTimestamps[index] = timestamp++;
+            transformedVertices++;
+        }
+    }
+
+    return transformedVertices;
+}
+
+
+void OptimizeVertexCache(std::span<ui32> indices, ui32 vertexCount)
+{
+    const auto triangleCount = static_cast<ui32>(indices.size() / 3);
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    //- Vertex -> triangles adjacency, remainingTriangles[v] is how many of them are not emitted yet
+    std::vector<ui32> remainingTriangles(vertexCount, 0);
+    for (const auto index : indices)
+    {
+        remainingTriangles[index]++;
+    }
+
+    std::vector<ui32> adjacencyOffsets(vertexCount);
+    for (ui32 vertex = 0, offset = 0; vertex < vertexCount; ++vertex)
+    {
+        adjacencyOffsets[vertex]  = offset;
+        offset                   += remainingTriangles[vertex];
+    }
+
+    std::vector<ui32> adjacency(indices.size());
+    {
+        std::vector<ui32> adjacencyCounts(vertexCount, 0);
+        for (ui32 i = 0; i < indices.size(); ++i)
+        {
+            const auto vertex = indices[i];
+            adjacency[adjacencyOffsets[vertex] + adjacencyCounts[vertex]++] = i / 3;
+        }
+    }
+
+    std::vector<f32> vertexScores(vertexCount);
+    for (ui32 vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        vertexScores[vertex] = ComputeVertexScore(-1, remainingTriangles[vertex]);
+    }
+    std::vector<i32>  cachePositions(vertexCount, -1);
+    std::vector<bool> isEmitted(triangleCount, false);
+    std::vector<ui32> optimizedIndices(indices.size());
+
+    // NOTE(v.matushkin): +3 for the vertices of the emitted triangle, before the cache is trimmed
+    ui32 cache[k_ScoringCacheSize + 3];
+    ui32 cacheSize = 0;
+
+    ui32 bestTriangle = k_InvalidIndex;
+    ui32 scanCursor   = 0;
+
+    for (ui32 emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        //- Nothing in the cache has triangles left, take the next not emitted one in the original order
+        if (bestTriangle == k_InvalidIndex)
+        {
+            while (isEmitted[scanCursor])
+            {
+                scanCursor++;
+            }
+            bestTriangle = scanCursor;
+        }
+
+        //- Emit the triangle
+        const auto triangle         = bestTriangle;
+        const auto triangleVertices = indices.data() + triangle * 3;
+        isEmitted[triangle]         = true;
+
+        ui32 newCache[k_ScoringCacheSize + 3];
+        ui32 newCacheSize = 0;
+
+        for (ui32 i = 0; i < 3; ++i)
+        {
+            const auto vertex = triangleVertices[i];
+            optimizedIndices[emittedCount * 3 + i] = vertex;
+
+            // NOTE(v.matushkin): Swap remove from the adjacency, the list only has the remaining triangles
+            auto       vertexTriangles     = adjacency.data() + adjacencyOffsets[vertex];
+            const auto vertexTriangleCount = remainingTriangles[vertex];
+            for (ui32 j = 0; j < vertexTriangleCount; ++j)
+            {
+                if (vertexTriangles[j] == triangle)
+                {
+                    vertexTriangles[j] = vertexTriangles[vertexTriangleCount - 1];
+                    break;
+                }
+            }
+            remainingTriangles[vertex]--;
+
+            // NOTE(v.matushkin): Degenerate triangles can have the same vertex twice
+            if (std::find(newCache, newCache + newCacheSize, vertex) == newCache + newCacheSize)
+            {
+                newCache[newCacheSize++] = vertex;
+            }
+        }
+
+        //- Update the cache, triangle vertices go to the front
+        for (ui32 i = 0; i < cacheSize; ++i)
+        {
+            const auto vertex = cache[i];
+            if (vertex != triangleVertices[0] && vertex != triangleVertices[1] && vertex != triangleVertices[2])
+            {
+                newCache[newCacheSize++] = vertex;
+            }
+        }
+        for (ui32 i = k_ScoringCacheSize; i < newCacheSize; ++i)
+        {
+            const auto vertex      = newCache[i];
+            cachePositions[vertex] = -1;
+            vertexScores[vertex]   = ComputeVertexScore(-1, remainingTriangles[vertex]);
+        }
+
+        cacheSize = std::min(newCacheSize, k_ScoringCacheSize);
+        std::memcpy(cache, newCache, cacheSize * sizeof(ui32));
+
+        for (ui32 i = 0; i < cacheSize; ++i)
+        {
+            const auto vertex      = cache[i];
+            cachePositions[vertex] = static_cast<i32>(i);
+            vertexScores[vertex]   = ComputeVertexScore(static_cast<i32>(i), remainingTriangles[vertex]);
+        }
+
+        //- Pick the best triangle that uses the cached vertices
+        bestTriangle = k_InvalidIndex;
+        f32 bestScore = 0.0f;
+
+        for (ui32 i = 0; i < cacheSize; ++i)
+        {
+            const auto vertex          = cache[i];
+            const auto vertexTriangles = adjacency.data() + adjacencyOffsets[vertex];
+
+            for (ui32 j = 0; j < remainingTriangles[vertex]; ++j)
+            {
+                const auto candidate         = vertexTriangles[j];
+                const auto candidateVertices = indices.data() + candidate * 3;
+                const auto score             = vertexScores[candidateVertices[0]]
+                                             + vertexScores[candidateVertices[1]]
+                                             + vertexScores[candidateVertices[2]];
+                if (score > bestScore)
+                {
+                    bestScore    = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    std::copy(optimizedIndices.begin(), optimizedIndices.end(), indices.begin());
+}
+
+
+void OptimizeOverdraw(std::span<ui32> indices, const f32* positions, ui32 positionStride)
+{
+    const auto triangleCount = static_cast<ui32>(indices.size() / 3);
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    const auto getPosition = [positions, positionStride](ui32 vertex) {
+        return reinterpret_cast<const f32*>(reinterpret_cast<const ui8*>(positions) + ui64(vertex) * positionStride);
+    };
+
+    //- Split into clusters at the triangles that miss the cache on every vertex,
+    //   moving the clusters around doesn't make the cache any worse there
+    ui32 vertexCount = 0;
+    for (const auto index : indices)
+    {
+        vertexCount = std::max(vertexCount, index + 1);
+    }
+
+    std::vector<Cluster> clusters;
+    {
+        std::vector<ui32> pushTimestamps(vertexCount, 0);
+        ui32              timestamp = k_FifoCacheSize + 1;
+
+        for (ui32 triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            ui32 misses = 0;
+            for (ui32 i = 0; i < 3; ++i)
+            {
+                const auto vertex = indices[triangle * 3 + i];
+                if (timestamp - pushTimestamps[vertex] > k_FifoCacheSize)
+                {
+                    pushTimestamps[vertex] = timestamp++;
+                    misses++;
+                }
+            }
+
+            if (triangle == 0 || misses == 3)
+            {
+                clusters.push_back(Cluster{.FirstTriangle = triangle, .TriangleCount = 0, .SortKey = 0.0f});
+            }
+            clusters.back().TriangleCount++;
+        }
+    }
+
+    if (clusters.size() == 1)
+    {
+        return;
+    }
+
+    //- Area weighted centroids and normals
+    f32 meshCentroid[3] = {};
+    f32 meshArea        = 0.0f;
+
+    std::vector<f32> clusterData(clusters.size() * 4); // NOTE(v.matushkin): Centroid xyz * area, area
+    std::vector<f32> clusterNormals(clusters.size() * 3);
+
+    for (ui32 c = 0; c < clusters.size(); ++c)
+    {
+        const auto& cluster = clusters[c];
+
+        for (ui32 triangle = cluster.FirstTriangle; triangle < cluster.FirstTriangle + cluster.TriangleCount; ++triangle)
+        {
+            const auto p0 = getPosition(indices[triangle * 3 + 0]);
+            const auto p1 = getPosition(indices[triangle * 3 + 1]);
+            const auto p2 = getPosition(indices[triangle * 3 + 2]);
+
+            const f32 e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            const f32 e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            // NOTE(v.matushkin): Not normalized, its length is twice the triangle area
+            const f32 normal[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0],
+            };
+            const auto area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            for (ui32 i = 0; i < 3; ++i)
+            {
+                const auto centroid = (p0[i] + p1[i] + p2[i]) / 3.0f;
+                clusterData[c * 4 + i]    += centroid * area;
+                clusterNormals[c * 3 + i] += normal[i];
+                meshCentroid[i]           += centroid * area;
+            }
+            clusterData[c * 4 + 3] += area;
+            meshArea               += area;
+        }
+    }
+
+    if (meshArea > 0.0f)
+    {
+        for (auto& component : meshCentroid)
+        {
+            component /= meshArea;
+        }
+    }
+
+    //- Clusters that face away from the mesh center are more likely to occlude the rest, draw them first
+    for (ui32 c = 0; c < clusters.size(); ++c)
+    {
+        const auto clusterArea = clusterData[c * 4 + 3];
+        if (clusterArea == 0.0f)
+        {
+            continue;
+        }
+
+        const auto normal       = clusterNormals.data() + c * 3;
+        const auto normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (normalLength == 0.0f)
+        {
+            continue;
+        }
+
+        f32 sortKey = 0.0f;
+        for (ui32 i = 0; i < 3; ++i)
+        {
+            sortKey += (clusterData[c * 4 + i] / clusterArea - meshCentroid[i]) * normal[i] / normalLength;
+        }
+        clusters[c].SortKey = sortKey;
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& lhs, const Cluster& rhs) {
+        return lhs.SortKey > rhs.SortKey;
+    });
+
+    std::vector<ui32> sortedIndices;
+    sortedIndices.reserve(indices.size());
+    for (const auto& cluster : clusters)
+    {
+        const auto first = indices.begin() + cluster.FirstTriangle * 3;
+        sortedIndices.insert(sortedIndices.end(), first, first + cluster.TriangleCount * 3);
+    }
+
+    std::copy(sortedIndices.begin(), sortedIndices.end(), indices.begin());
+}
+
+
+ui32 OptimizeVertexFetch(std::span<ui32> indices, ui32 vertexCount, std::vector<ui32>& vertexOrder)
+{
+    std::vector<ui32> remap(vertexCount, k_InvalidIndex);
+
+    vertexOrder.clear();
+    vertexOrder.reserve(vertexCount);
+
+    for (auto& index : indices)
+    {
+        if (remap[index] == k_InvalidIndex)
+        {
+            remap[index] = static_cast<ui32>(vertexOrder.size());
+            vertexOrder.push_back(index);
+        }
+        index = remap[index];
+    }
+
+    return static_cast<ui32>(vertexOrder.size());
+}
+
+} // namespace snv::MeshOptimizer
@@ -0,0 +1,130 @@
+#include <Engine/Assets/ShaderCache.hpp>
+
+#include <Engine/Core/Log.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+
+namespace
+{
+
+constexpr ui32 k_Magic         = 0x53564E53; // 'SNVS'
+constexpr ui32 k_Version       = 1;
+constexpr ui64 k_DataAlignment = 16;
+constexpr ui32 k_SpirvMagic    = 0x07230203;
+
+
+struct FileHeader
+{
+    ui32 Magic;
+    ui32 Version;
+    ui64 SourceHash;
+    ui64 DataOffset;
+    ui64 DataSize;
+};
+
+} // namespace
+
+
+namespace snv::ShaderCache
+{
+
+bool Read(const std::string& cachePath, ui64 sourceHash, CookedShader& cookedShader)
+{
+    MappedFile cacheFile(cachePath);
+    if (cacheFile.IsValid() == false)
+    {
+        return false;
+    }
+
+    const auto fileData = cacheFile.GetData();
+    const auto fileSize = fileData.size();
+
+    if (fileSize < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+
+    if (header.Magic != k_Magic || header.Version != k_Version || header.SourceHash != sourceHash)
+    {
+        LOG_INFO("ShaderCache: {} is stale, the shader will be compiled at runtime", cachePath);
+        return false;
+    }
+
+    ui32 spirvMagic = 0;
+    if (header.DataOffset <= fileSize
+        && header.DataSize <= fileSize - header.DataOffset
+        && header.DataSize >= sizeof(ui32)
+        && header.DataSize % sizeof(ui32) == 0)
+    {
+        std::memcpy(&spirvMagic, fileData.data() + header.DataOffset, sizeof(ui32));
+    }
+
+    if (spirvMagic != k_SpirvMagic)
+    {
+        LOG_WARN("ShaderCache: {} is corrupted, the shader will be compiled at runtime", cachePath);
+        return false;
+    }
+
+    cookedShader.Bytecode = fileData.subspan(header.DataOffset, header.DataSize);
+    cookedShader.File     = std::move(cacheFile);
+
+    return true;
+}
+
+bool Write(const std::string& cachePath, ui64 sourceHash, std::span<const ui32> spirvBytecode)
+{
+    const FileHeader header = {
+        .Magic      = k_Magic,
+        .Version    = k_Version,
+        .SourceHash = sourceHash,
+        .DataOffset = (sizeof(FileHeader) + k_DataAlignment - 1) & ~(k_DataAlignment - 1),
+        .DataSize   = spirvBytecode.size_bytes(),
+    };
+
+    // NOTE(v.matushkin): Write into a temporary file first, so a crash can't leave a half written cache
+    const std::filesystem::path cacheFilePath(cachePath);
+    const std::filesystem::path tempFilePath(cachePath + ".tmp");
+
+    std::error_code errorCode;
+
+    {
+        std::ofstream cacheFile(tempFilePath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (cacheFile.is_open() == false)
+        {
+            LOG_WARN("ShaderCache: can't open {} for writing", tempFilePath.string());
+            return false;
+        }
+
+        static constexpr char zeros[k_DataAlignment] = {};
+
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        cacheFile.write(zeros, header.DataOffset - sizeof(FileHeader));
+        cacheFile.write(reinterpret_cast<const char*>(spirvBytecode.data()), spirvBytecode.size_bytes());
+
+        if (cacheFile.good() == false)
+        {
+            LOG_WARN("ShaderCache: failed to write {}", tempFilePath.string());
+            cacheFile.close();
+            std::filesystem::remove(tempFilePath, errorCode);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, cacheFilePath, errorCode);
+    if (errorCode)
+    {
+        LOG_WARN("ShaderCache: failed to rename {} to {}, error: {}", tempFilePath.string(), cachePath, errorCode.message());
+        std::filesystem::remove(tempFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace snv::ShaderCache
@@ -0,0 +1,117 @@
+#include <Engine/Assets/ShaderWatcher.hpp>
+
+#include <Engine/Core/Log.hpp>
+#include <Engine/Core/Profiler.hpp>
+
+#include <utility>
+
+
+namespace snv
+{
+
+ShaderWatcher::ShaderWatcher(OnShaderChanged onShaderChanged)
+    : m_onShaderChanged(std::move(onShaderChanged))
+    , m_isStopping(false)
+    , m_thread(&ShaderWatcher::WatcherLoop, this)
+{}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_stop.notify_one();
+
+    m_thread.join();
+}
+
+
+void ShaderWatcher::Watch(ShaderHandle shaderHandle, std::string shaderName, std::span<const std::string> filePaths)
+{
+    WatchedShader watchedShader = {
+        .Handle    = shaderHandle,
+        .Name      = std::move(shaderName),
+        .Files     = {},
+        .IsChanged = false,
+    };
+
+    for (const auto& filePath : filePaths)
+    {
+        std::filesystem::file_time_type writeTime;
+        if (GetWriteTime(filePath, writeTime) == false)
+        {
+            LOG_WARN("ShaderWatcher: can't access {}, it won't be watched", filePath);
+            continue;
+        }
+
+        watchedShader.Files.push_back(WatchedFile{.Path = filePath, .WriteTime = writeTime});
+    }
+
+    std::scoped_lock lock(m_mutex);
+    m_shaders.push_back(std::move(watchedShader));
+}
+
+
+void ShaderWatcher::WatcherLoop()
+{
+    PROFILE_THREAD("ShaderWatcher");
+
+    std::vector<std::pair<ShaderHandle, std::string>> changedShaders;
+
+    std::unique_lock lock(m_mutex);
+    while (m_stop.wait_for(lock, k_PollInterval, [this] { return m_isStopping; }) == false)
+    {
+        changedShaders.clear();
+
+        for (auto& shader : m_shaders)
+        {
+            bool isChanged = false;
+            for (auto& file : shader.Files)
+            {
+                std::filesystem::file_time_type writeTime;
+                if (GetWriteTime(file.Path, writeTime) && writeTime != file.WriteTime)
+                {
+                    file.WriteTime = writeTime;
+                    isChanged      = true;
+                }
+            }
+
+            // NOTE(v.matushkin): Wait for one poll without changes, so a half written file isn't compiled
+            if (isChanged)
+            {
+                shader.IsChanged = true;
+            }
+            else if (shader.IsChanged)
+            {
+                shader.IsChanged = false;
+                changedShaders.emplace_back(shader.Handle, shader.Name);
+            }
+        }
+
+        if (changedShaders.empty())
+        {
+            continue;
+        }
+
+        // NOTE(v.matushkin): The callback compiles the shader, Watch() shouldn't wait for that
+        lock.unlock();
+        for (const auto& [shaderHandle, shaderName] : changedShaders)
+        {
+            PROFILE_ZONE("ShaderWatcher::OnShaderChanged");
+            LOG_INFO("ShaderWatcher: {} changed, reloading", shaderName);
+            m_onShaderChanged(shaderHandle, shaderName);
+        }
+        lock.lock();
+    }
+}
+
+bool ShaderWatcher::GetWriteTime(const std::string& filePath, std::filesystem::file_time_type& writeTime)
+{
+    std::error_code errorCode;
+    writeTime = std::filesystem::last_write_time(filePath, errorCode);
+
+    return static_cast<bool>(errorCode) == false;
+}
+
+} // namespace snv
@@ -1,4 +1,5 @@
 #include <Engine/Assets/Texture.hpp>
+#include <Engine/Core/Assert.hpp>
 #include <Engine/Renderer/Renderer.hpp>
 
 #include <utility>
@@ -7,19 +8,19 @@
 namespace snv
 {
 
-Texture::Texture(const TextureDesc& textureDesc, std::unique_ptr<ui8[]>&& textureData)
-    : m_textureData(std::move(textureData))
-    , m_textureHandle(Renderer::CreateTexture(textureDesc, m_textureData.get()))
-{}
+Texture::Texture(const TextureDesc& textureDesc, std::span<const ui8> textureData)
+{
+    SNV_ASSERT(textureData.size_bytes() >= GetTextureSize(textureDesc), "Texture data is smaller than its mip chain");
+
+    m_textureHandle = Renderer::CreateTexture(textureDesc, textureData.data());
+}
 
 Texture::Texture(Texture&& other) noexcept
-    : m_textureData(std::exchange(other.m_textureData, nullptr))
-    , m_textureHandle(std::exchange(other.m_textureHandle, TextureHandle::InvalidHandle))
+    : m_textureHandle(std::exchange(other.m_textureHandle, TextureHandle::InvalidHandle))
 {}
 
 Texture& Texture::operator=(Texture&& other) noexcept
 {
-    m_textureData   = std::exchange(other.m_textureData, nullptr);
     m_textureHandle = std::exchange(other.m_textureHandle, TextureHandle::InvalidHandle);
 
     return *this;
@@ -29,6 +30,7 @@ Texture& Texture::operator=(Texture&& other) noexcept
 static constexpr TextureDesc s_DefaultTextureDesc = {
     .Width    = 4,
     .Height   = 4,
+    .MipCount = 1,
     .Format   = TextureFormat::RGBA8,
     .WrapMode = TextureWrapMode::Repeat,
 };
@@ -45,10 +47,7 @@ std::shared_ptr<Texture> Texture::GetBlackTexture()
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     };
-    auto blackTextureDataPtr = std::make_unique<ui8[]>(4 * 4 * 4);
-    std::memcpy(blackTextureDataPtr.get(), blackTextureData, 4 * 4 * 4);
-
-    static auto blackTexture = std::make_shared<Texture>(s_DefaultTextureDesc, std::move(blackTextureDataPtr));
+    static auto blackTexture = std::make_shared<Texture>(s_DefaultTextureDesc, blackTextureData);
 
     return blackTexture;
 }
@@ -61,10 +60,7 @@ std::shared_ptr<Texture> Texture::GetWhiteTexture()
         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
     };
-    auto whiteTextureDataPtr = std::make_unique<ui8[]>(4 * 4 * 4);
-    std::memcpy(whiteTextureDataPtr.get(), whiteTextureData, 4 * 4 * 4);
-
-    static auto whiteTexture = std::make_shared<Texture>(s_DefaultTextureDesc, std::move(whiteTextureDataPtr));
+    static auto whiteTexture = std::make_shared<Texture>(s_DefaultTextureDesc, whiteTextureData);
 
     return whiteTexture;
 }
@@ -77,10 +73,7 @@ std::shared_ptr<Texture> Texture::GetNormalTexture()
         127, 127, 255, 255, 127, 127, 255, 255, 127, 127, 255, 255, 127, 127, 255, 255,
         127, 127, 255, 255, 127, 127, 255, 255, 127, 127, 255, 255, 127, 127, 255, 255,
     };
-    auto normalTextureDataPtr = std::make_unique<ui8[]>(4 * 4 * 4);
-    std::memcpy(normalTextureDataPtr.get(), normalTextureData, 4 * 4 * 4);
-
-    static auto normalTexture = std::make_shared<Texture>(s_DefaultTextureDesc, std::move(normalTextureDataPtr));
+    static auto normalTexture = std::make_shared<Texture>(s_DefaultTextureDesc, normalTextureData);
 
     return normalTexture;
 }
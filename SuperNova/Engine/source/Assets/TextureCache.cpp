@@ -0,0 +1,203 @@
+#include <Engine/Assets/TextureCache.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+
+namespace
+{
+
+constexpr ui32 k_Magic         = 0x54564E53; // 'SNVT'
+constexpr ui32 k_Version       = 1;
+constexpr ui64 k_DataAlignment = 16;
+
+
+struct FileHeader
+{
+    ui32 Magic;
+    ui32 Version;
+    ui64 SourceHash;
+    ui32 Width;
+    ui32 Height;
+    ui32 MipCount;
+    ui8  Format;
+    ui8  WrapMode;
+    ui8  _Padding[2];
+    ui64 DataOffset;
+    ui64 DataSize;
+};
+
+} // namespace
+
+
+namespace snv::TextureCache
+{
+
+bool Read(const std::string& cachePath, ui64 sourceHash, CookedTexture& cookedTexture)
+{
+    MappedFile cacheFile(cachePath);
+    if (cacheFile.IsValid() == false)
+    {
+        return false;
+    }
+
+    const auto fileData = cacheFile.GetData();
+    const auto fileSize = fileData.size();
+
+    if (fileSize < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+
+    if (header.Magic != k_Magic || header.Version != k_Version || header.SourceHash != sourceHash)
+    {
+        LOG_INFO("TextureCache: {} is stale, it will be recooked", cachePath);
+        return false;
+    }
+
+    // NOTE(v.matushkin): GetTextureSize() indexes a table with the format, it has to be checked before anything else
+    if (header.Format > static_cast<ui8>(TextureFormat::DEPTH32F)
+        || header.WrapMode > static_cast<ui8>(TextureWrapMode::Repeat))
+    {
+        LOG_WARN("TextureCache: {} is corrupted, it will be recooked", cachePath);
+        return false;
+    }
+
+    const TextureDesc textureDesc = {
+        .Width    = header.Width,
+        .Height   = header.Height,
+        .MipCount = header.MipCount,
+        .Format   = static_cast<TextureFormat>(header.Format),
+        .WrapMode = static_cast<TextureWrapMode>(header.WrapMode),
+    };
+
+    if (header.MipCount == 0
+        || header.MipCount > GetFullMipCount(header.Width, header.Height)
+        || header.DataSize != GetTextureSize(textureDesc)
+        || header.DataOffset > fileSize
+        || header.DataSize > fileSize - header.DataOffset)
+    {
+        LOG_WARN("TextureCache: {} is corrupted, it will be recooked", cachePath);
+        return false;
+    }
+
+    cookedTexture.Desc = textureDesc;
+    cookedTexture.Data = std::span(reinterpret_cast<const ui8*>(fileData.data() + header.DataOffset), header.DataSize);
+    cookedTexture.File = std::move(cacheFile);
+
+    return true;
+}
+
+bool Write(const std::string& cachePath, ui64 sourceHash, const TextureDesc& textureDesc, std::span<const ui8> textureData)
+{
+    const FileHeader header = {
+        .Magic      = k_Magic,
+        .Version    = k_Version,
+        .SourceHash = sourceHash,
+        .Width      = textureDesc.Width,
+        .Height     = textureDesc.Height,
+        .MipCount   = textureDesc.MipCount,
+        .Format     = static_cast<ui8>(textureDesc.Format),
+        .WrapMode   = static_cast<ui8>(textureDesc.WrapMode),
+        ._Padding   = {},
+        .DataOffset = (sizeof(FileHeader) + k_DataAlignment - 1) & ~(k_DataAlignment - 1),
+        .DataSize   = textureData.size_bytes(),
+    };
+
+    // NOTE(v.matushkin): Write into a temporary file first, so a crash can't leave a half written cache
+    const std::filesystem::path cacheFilePath(cachePath);
+    const std::filesystem::path tempFilePath(cachePath + ".tmp");
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(cacheFilePath.parent_path(), errorCode);
+
+    {
+        std::ofstream cacheFile(tempFilePath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (cacheFile.is_open() == false)
+        {
+            LOG_WARN("TextureCache: can't open {} for writing", tempFilePath.string());
+            return false;
+        }
+
+        static constexpr char zeros[k_DataAlignment] = {};
+
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        cacheFile.write(zeros, header.DataOffset - sizeof(FileHeader));
+        cacheFile.write(reinterpret_cast<const char*>(textureData.data()), textureData.size_bytes());
+
+        if (cacheFile.good() == false)
+        {
+            LOG_WARN("TextureCache: failed to write {}", tempFilePath.string());
+            cacheFile.close();
+            std::filesystem::remove(tempFilePath, errorCode);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, cacheFilePath, errorCode);
+    if (errorCode)
+    {
+        LOG_WARN("TextureCache: failed to rename {} to {}, error: {}", tempFilePath.string(), cachePath, errorCode.message());
+        std::filesystem::remove(tempFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+
+void GenerateMipChain(const TextureDesc& textureDesc, std::span<ui8> textureData)
+{
+    // TODO(v.matushkin): Filter in linear space when textures will be loaded as sRGB
+    SNV_ASSERT(textureDesc.Format == TextureFormat::RGBA8, "Mip chain generation supports only RGBA8");
+    SNV_ASSERT(textureData.size_bytes() >= GetTextureSize(textureDesc), "textureData is too small for the mip chain");
+
+    constexpr ui32 pixelSize = 4;
+
+    auto srcMip = textureData.data();
+
+    for (ui32 mip = 1; mip < textureDesc.MipCount; ++mip)
+    {
+        const auto srcWidth  = GetMipDimension(textureDesc.Width, mip - 1);
+        const auto srcHeight = GetMipDimension(textureDesc.Height, mip - 1);
+        const auto dstWidth  = GetMipDimension(textureDesc.Width, mip);
+        const auto dstHeight = GetMipDimension(textureDesc.Height, mip);
+        const auto dstMip    = srcMip + ui64(srcWidth) * srcHeight * pixelSize;
+
+        for (ui32 y = 0; y < dstHeight; ++y)
+        {
+            // NOTE(v.matushkin): Odd dimensions just clamp the last row/column, good enough for a box filter
+            const auto srcY0 = std::min(y * 2, srcHeight - 1);
+            const auto srcY1 = std::min(y * 2 + 1, srcHeight - 1);
+
+            for (ui32 x = 0; x < dstWidth; ++x)
+            {
+                const auto srcX0 = std::min(x * 2, srcWidth - 1);
+                const auto srcX1 = std::min(x * 2 + 1, srcWidth - 1);
+
+                const auto p00 = srcMip + (ui64(srcY0) * srcWidth + srcX0) * pixelSize;
+                const auto p01 = srcMip + (ui64(srcY0) * srcWidth + srcX1) * pixelSize;
+                const auto p10 = srcMip + (ui64(srcY1) * srcWidth + srcX0) * pixelSize;
+                const auto p11 = srcMip + (ui64(srcY1) * srcWidth + srcX1) * pixelSize;
+                const auto dst = dstMip + (ui64(y) * dstWidth + x) * pixelSize;
+
+                for (ui32 channel = 0; channel < pixelSize; ++channel)
+                {
+                    dst[channel] = static_cast<ui8>((p00[channel] + p01[channel] + p10[channel] + p11[channel] + 2) / 4);
+                }
+            }
+        }
+
+        srcMip = dstMip;
+    }
+}
+
+} // namespace snv::TextureCache
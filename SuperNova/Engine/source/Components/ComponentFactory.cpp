@@ -10,6 +10,8 @@ namespace snv
 
 entt::entity ComponentFactory::CreateEntity()
 {
+    MEMORY_TAG_SCOPE(MemoryTag::ECS);
+
     return m_registry.create();
 }
 
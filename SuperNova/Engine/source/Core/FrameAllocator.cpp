@@ -0,0 +1,128 @@
+#include <Engine/Core/FrameAllocator.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
+
+#include <bit>
+#include <cstdint>
+
+
+namespace
+{
+
+size_t GetAlignmentPadding(uintptr_t address, size_t alignment)
+{
+    return (alignment - (address & (alignment - 1))) & (alignment - 1);
+}
+
+} // namespace
+
+
+namespace snv
+{
+
+LinearArena::LinearArena(size_t capacity)
+    : m_capacity(capacity)
+    , m_offset(0)
+{
+    MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+    m_memory = static_cast<std::byte*>(MemoryTracker::Allocate(m_capacity));
+}
+
+LinearArena::~LinearArena()
+{
+    Reset();
+    MemoryTracker::Free(m_memory);
+}
+
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    SNV_ASSERT(std::has_single_bit(alignment), "LinearArena: alignment must be a power of 2");
+
+    // NOTE(v.matushkin): CAS instead of fetch_add, so only the padding this allocation really needs is taken.
+    //  The offset keeps growing past the capacity, Reset() uses it as the size the frame needed
+    auto   offset = m_offset.load(std::memory_order_relaxed);
+    size_t alignedOffset;
+    do
+    {
+        alignedOffset = offset + GetAlignmentPadding(reinterpret_cast<uintptr_t>(m_memory) + offset, alignment);
+    }
+    while (m_offset.compare_exchange_weak(offset, alignedOffset + size, std::memory_order_relaxed) == false);
+
+    if (alignedOffset + size <= m_capacity)
+    {
+        return m_memory + alignedOffset;
+    }
+
+    return AllocateOverflow(size, alignment);
+}
+
+void LinearArena::Reset()
+{
+    const auto usedBytes = m_offset.load(std::memory_order_relaxed);
+    m_offset.store(0, std::memory_order_relaxed);
+
+    if (usedBytes <= m_capacity)
+    {
+        return;
+    }
+
+    //- Grow, so the next time everything fits
+    for (auto overflowBlock : m_overflowBlocks)
+    {
+        MemoryTracker::Free(overflowBlock);
+    }
+    m_overflowBlocks.clear();
+
+    MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+    MemoryTracker::Free(m_memory);
+    m_capacity = std::bit_ceil(usedBytes);
+    m_memory   = static_cast<std::byte*>(MemoryTracker::Allocate(m_capacity));
+}
+
+
+void* LinearArena::AllocateOverflow(size_t size, size_t alignment)
+{
+    MEMORY_TAG_SCOPE(MemoryTag::Transient);
+
+    std::scoped_lock lock(m_overflowMutex);
+
+    const auto overflowBlock = static_cast<std::byte*>(MemoryTracker::Allocate(size + alignment - 1));
+    m_overflowBlocks.push_back(overflowBlock);
+
+    return overflowBlock + GetAlignmentPadding(reinterpret_cast<uintptr_t>(overflowBlock), alignment);
+}
+
+
+void FrameAllocator::Init(ui32 framesInFlight, size_t arenaCapacity)
+{
+    SNV_ASSERT(framesInFlight != 0, "FrameAllocator: there must be at least 1 frame in flight");
+
+    s_arenas.reserve(framesInFlight);
+    for (ui32 i = 0; i < framesInFlight; ++i)
+    {
+        s_arenas.push_back(std::make_unique<LinearArena>(arenaCapacity));
+    }
+
+    s_currentArena = s_arenas[0].get();
+}
+
+void FrameAllocator::Shutdown()
+{
+    s_arenas.clear();
+    s_currentArena = nullptr;
+}
+
+
+void FrameAllocator::BeginFrame(ui32 frameIndex)
+{
+    SNV_ASSERT(frameIndex < s_arenas.size(), "FrameAllocator: frameIndex is out of the frames in flight");
+
+    s_currentArena = s_arenas[frameIndex].get();
+    s_currentArena->Reset();
+}
+
+} // namespace snv
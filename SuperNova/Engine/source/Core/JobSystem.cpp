@@ -0,0 +1,312 @@
+#include <Engine/Core/JobSystem.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+#include <Engine/Core/Profiler.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+const ui32 k_MaxJobsPerThread   = 1024; // NOTE(v.matushkin): Power of 2, the job ring and the deque wrap around with it
+const ui32 k_IdleSpinCount      = 64;   // NOTE(v.matushkin): GetJob() attempts before a worker goes to sleep
+const ui32 k_InvalidThreadIndex = ~0u;
+
+
+// NOTE(v.matushkin): Guarded by a mutex, the owner and a thief only contend when the deque is almost empty,
+//  the jobs are coarse enough that the lock doesn't show up
+class JobDeque
+{
+public:
+    void Push(snv::Job* job)
+    {
+        std::scoped_lock lock(m_mutex);
+        SNV_ASSERT(m_bottom - m_top < k_MaxJobsPerThread, "JobSystem: the job deque is full");
+        m_jobs[m_bottom++ % k_MaxJobsPerThread] = job;
+    }
+
+    //- Owner, LIFO, the job it just pushed is the one with the hottest data
+    [[nodiscard]] snv::Job* Pop()
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_bottom == m_top)
+        {
+            return nullptr;
+        }
+        return m_jobs[--m_bottom % k_MaxJobsPerThread];
+    }
+
+    //- Thieves, FIFO, the oldest job is usually the biggest one
+    [[nodiscard]] snv::Job* Steal()
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_bottom == m_top)
+        {
+            return nullptr;
+        }
+        return m_jobs[m_top++ % k_MaxJobsPerThread];
+    }
+
+private:
+    std::mutex m_mutex;
+    ui64       m_top    = 0;
+    ui64       m_bottom = 0;
+    snv::Job*  m_jobs[k_MaxJobsPerThread];
+};
+
+
+struct ThreadData
+{
+    JobDeque                    Deque;
+    std::unique_ptr<snv::Job[]> Jobs;
+    ui32                        NextJob;
+    ui32                        RandomState; // NOTE(v.matushkin): Picks the first steal victim
+};
+
+
+std::vector<std::unique_ptr<ThreadData>> g_Threads; // NOTE(v.matushkin): [0] is the thread that called Init()
+std::vector<std::thread>                 g_Workers;
+
+std::atomic<bool>       g_IsRunning;
+std::atomic<ui32>       g_QueuedJobCount;
+std::atomic<ui32>       g_SleepingWorkerCount;
+std::mutex              g_WakeMutex;
+std::condition_variable g_WakeCondition;
+
+thread_local ui32 t_ThreadIndex = k_InvalidThreadIndex;
+
+
+ThreadData& GetThreadData()
+{
+    SNV_ASSERT(t_ThreadIndex != k_InvalidThreadIndex, "JobSystem: jobs can only be used from the thread 0 and the jobs");
+    return *g_Threads[t_ThreadIndex];
+}
+
+ui32 NextRandom(ThreadData& threadData)
+{
+    // NOTE(v.matushkin): xorshift32, only needs to spread the thieves over the victims
+    auto x = threadData.RandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    threadData.RandomState = x;
+    return x;
+}
+
+
+snv::Job* GetJob(ThreadData& threadData)
+{
+    auto job = threadData.Deque.Pop();
+
+    if (job == nullptr)
+    {
+        const auto threadCount = static_cast<ui32>(g_Threads.size());
+        const auto firstVictim = NextRandom(threadData) % threadCount;
+        for (ui32 i = 0; i < threadCount && job == nullptr; ++i)
+        {
+            auto& victim = *g_Threads[(firstVictim + i) % threadCount];
+            if (&victim != &threadData)
+            {
+                job = victim.Deque.Steal();
+            }
+        }
+    }
+
+    if (job != nullptr)
+    {
+        g_QueuedJobCount.fetch_sub(1);
+    }
+
+    return job;
+}
+
+} // namespace
+
+
+namespace snv
+{
+
+void JobSystem::Init(ui32 workerCount)
+{
+    SNV_ASSERT(g_Threads.empty(), "JobSystem: already initialized");
+
+    if (workerCount == 0)
+    {
+        // NOTE(v.matushkin): hardware_concurrency() can return 0 if it can't figure it out
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    const auto threadCount = workerCount + 1;
+    g_Threads.reserve(threadCount);
+    for (ui32 i = 0; i < threadCount; ++i)
+    {
+        auto threadData         = std::make_unique<ThreadData>();
+        threadData->Jobs        = std::make_unique<Job[]>(k_MaxJobsPerThread);
+        threadData->NextJob     = 0;
+        threadData->RandomState = i * 0x9E3779B9u + 1;
+        g_Threads.push_back(std::move(threadData));
+    }
+
+    t_ThreadIndex = 0;
+    g_IsRunning.store(true);
+
+    g_Workers.reserve(workerCount);
+    for (ui32 i = 1; i < threadCount; ++i)
+    {
+        g_Workers.emplace_back(&JobSystem::WorkerLoop, i);
+    }
+
+    LOG_INFO("JobSystem: {} workers", workerCount);
+}
+
+void JobSystem::Shutdown()
+{
+    SNV_ASSERT(g_QueuedJobCount.load() == 0, "JobSystem: there are unfinished jobs");
+
+    {
+        std::scoped_lock lock(g_WakeMutex);
+        g_IsRunning.store(false);
+    }
+    g_WakeCondition.notify_all();
+
+    for (auto& worker : g_Workers)
+    {
+        worker.join();
+    }
+
+    g_Workers.clear();
+    g_Threads.clear();
+    t_ThreadIndex = k_InvalidThreadIndex;
+}
+
+
+ui32 JobSystem::GetThreadCount()
+{
+    return static_cast<ui32>(g_Threads.size());
+}
+
+
+void JobSystem::Run(Job* job)
+{
+    GetThreadData().Deque.Push(job);
+
+    // NOTE(v.matushkin): seq_cst pairs with the worker that increments the sleeping count and then checks
+    //  the queued count, one of the two always sees the other, so a job is never left with everyone asleep
+    g_QueuedJobCount.fetch_add(1);
+    if (g_SleepingWorkerCount.load() > 0)
+    {
+        {
+            std::scoped_lock lock(g_WakeMutex);
+        }
+        g_WakeCondition.notify_one();
+    }
+}
+
+void JobSystem::Wait(const Job* job)
+{
+    auto& threadData = GetThreadData();
+
+    while (IsFinished(job) == false)
+    {
+        if (auto otherJob = GetJob(threadData))
+        {
+            Execute(*otherJob);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::IsFinished(const Job* job)
+{
+    return job->m_unfinishedJobs.load(std::memory_order_acquire) == 0;
+}
+
+
+Job* JobSystem::AllocateJob(Job* parent)
+{
+    auto& threadData = GetThreadData();
+
+    auto job = &threadData.Jobs[threadData.NextJob++ % k_MaxJobsPerThread];
+    SNV_ASSERT(IsFinished(job), "JobSystem: the job ring wrapped around to an unfinished job, increase k_MaxJobsPerThread");
+
+    job->m_parent = parent;
+    job->m_unfinishedJobs.store(1, std::memory_order_relaxed);
+    if (parent != nullptr)
+    {
+        // NOTE(v.matushkin): The parent is alive here, it has at least its own 1, so it can't finish in between
+        parent->m_unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    {
+        PROFILE_ZONE("JobSystem::Job");
+        job.m_function(job);
+    }
+    Finish(&job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+    while (job != nullptr)
+    {
+        // NOTE(v.matushkin): Read the parent first, once the counter hits 0 the owner can reuse the job
+        const auto parent = job->m_parent;
+        if (job->m_unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        job = parent;
+    }
+}
+
+void JobSystem::WorkerLoop(ui32 threadIndex)
+{
+    PROFILE_THREAD("JobWorker");
+
+    t_ThreadIndex    = threadIndex;
+    auto& threadData = *g_Threads[threadIndex];
+
+    while (true)
+    {
+        Job* job = nullptr;
+        for (ui32 i = 0; i < k_IdleSpinCount && job == nullptr; ++i)
+        {
+            job = GetJob(threadData);
+            if (job == nullptr)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (job != nullptr)
+        {
+            Execute(*job);
+            continue;
+        }
+
+        std::unique_lock lock(g_WakeMutex);
+        g_SleepingWorkerCount.fetch_add(1);
+        g_WakeCondition.wait(lock, [] { return g_QueuedJobCount.load() > 0 || g_IsRunning.load() == false; });
+        g_SleepingWorkerCount.fetch_sub(1);
+
+        if (g_IsRunning.load() == false)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace snv
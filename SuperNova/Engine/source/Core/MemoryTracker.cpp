@@ -0,0 +1,403 @@
+#include <Engine/Core/MemoryTracker.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+
+
+namespace
+{
+
+// NOTE(v.matushkin): Keeps the block after it aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__
+struct alignas(16) AllocationHeader
+{
+    ui64           Size;
+    ui32           AlignmentOffset; // NOTE(v.matushkin): From the malloc'ed pointer to the header, 0 if not overaligned
+    snv::MemoryTag Tag;
+};
+static_assert(sizeof(AllocationHeader) == 16);
+
+
+struct TagCounters
+{
+    std::atomic<ui64> CurrentBytes;
+    std::atomic<ui64> PeakBytes;
+    std::atomic<ui64> CurrentAllocations;
+    std::atomic<ui64> TotalAllocations;
+};
+
+
+const char* k_MemoryTagNames[] = {
+    "Untagged",  // MemoryTag::Untagged
+    "Assets",    // MemoryTag::Assets
+    "Renderer",  // MemoryTag::Renderer
+    "ECS",       // MemoryTag::ECS
+    "Transient", // MemoryTag::Transient
+};
+static_assert(std::size(k_MemoryTagNames) == static_cast<ui64>(snv::MemoryTag::Count));
+
+
+// NOTE(v.matushkin): Everything here is constant initialized, operator new can be called before any dynamic initialization
+TagCounters                               g_TagCounters[static_cast<ui64>(snv::MemoryTag::Count)];
+std::atomic<ui64>                         g_HeapAllocationCount;
+std::atomic<snv::HeapAllocationGuardMode> g_HeapAllocationGuardMode = snv::HeapAllocationGuardMode::Count;
+
+thread_local snv::MemoryTag t_CurrentTag                = snv::MemoryTag::Untagged;
+thread_local bool           t_IsHeapAllocationForbidden = false;
+
+
+void TrackAllocation(const AllocationHeader& header)
+{
+    auto& tagCounters = g_TagCounters[static_cast<ui64>(header.Tag)];
+
+    const auto currentBytes = tagCounters.CurrentBytes.fetch_add(header.Size, std::memory_order_relaxed) + header.Size;
+    auto       peakBytes    = tagCounters.PeakBytes.load(std::memory_order_relaxed);
+    while (currentBytes > peakBytes
+           && tagCounters.PeakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed) == false)
+    {
+    }
+
+    tagCounters.CurrentAllocations.fetch_add(1, std::memory_order_relaxed);
+    tagCounters.TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (t_IsHeapAllocationForbidden)
+    {
+        // NOTE(v.matushkin): The assert itself allocates, it must not end up here again
+        t_IsHeapAllocationForbidden = false;
+        SNV_ASSERT(false, "Heap allocation inside of a HeapAllocationGuard");
+    }
+}
+
+void TrackFree(const AllocationHeader& header)
+{
+    auto& tagCounters = g_TagCounters[static_cast<ui64>(header.Tag)];
+
+    tagCounters.CurrentBytes.fetch_sub(header.Size, std::memory_order_relaxed);
+    tagCounters.CurrentAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+// NOTE(v.matushkin): For the std::align_val_t forms of operator new, freed with MemoryTracker::Free() as any other block
+void* AllocateAligned(size_t size, size_t alignment)
+{
+    SNV_ASSERT(std::has_single_bit(alignment), "MemoryTracker: alignment must be a power of 2");
+
+    if (alignment <= alignof(AllocationHeader))
+    {
+        return snv::MemoryTracker::Allocate(size);
+    }
+
+    // NOTE(v.matushkin): malloc'ed memory is aligned to 16 at least, so the header in front of the aligned block is too
+    const auto memory = static_cast<std::byte*>(std::malloc(sizeof(AllocationHeader) + alignment + size));
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto memoryAddress = reinterpret_cast<uintptr_t>(memory);
+    const auto blockAddress  = (memoryAddress + sizeof(AllocationHeader) + alignment - 1) & ~(alignment - 1);
+    const auto header        = reinterpret_cast<AllocationHeader*>(blockAddress) - 1;
+
+    header->Size            = size;
+    header->AlignmentOffset = static_cast<ui32>(reinterpret_cast<std::byte*>(header) - memory);
+    header->Tag             = t_CurrentTag;
+    TrackAllocation(*header);
+
+    return header + 1;
+}
+#endif // SNV_MEMORY_TRACKING_ENABLED
+
+} // namespace
+
+
+namespace snv
+{
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+
+void* MemoryTracker::Allocate(size_t size)
+{
+    auto header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    header->Size            = size;
+    header->AlignmentOffset = 0;
+    header->Tag             = t_CurrentTag;
+    TrackAllocation(*header);
+
+    return header + 1;
+}
+
+void* MemoryTracker::Reallocate(void* memory, size_t size)
+{
+    if (memory == nullptr)
+    {
+        return Allocate(size);
+    }
+
+    auto       header    = static_cast<AllocationHeader*>(memory) - 1;
+    const auto oldHeader = *header;
+    SNV_ASSERT(oldHeader.AlignmentOffset == 0, "MemoryTracker: overaligned blocks can't be reallocated");
+
+    header = static_cast<AllocationHeader*>(std::realloc(header, sizeof(AllocationHeader) + size));
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    // NOTE(v.matushkin): The block keeps its tag, it's not a new allocation of the current one
+    TrackFree(oldHeader);
+    header->Size = size;
+    TrackAllocation(*header);
+
+    return header + 1;
+}
+
+void MemoryTracker::Free(void* memory)
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    const auto header = static_cast<AllocationHeader*>(memory) - 1;
+    TrackFree(*header);
+    std::free(reinterpret_cast<std::byte*>(header) - header->AlignmentOffset);
+}
+
+
+MemoryTag MemoryTracker::GetCurrentTag()
+{
+    return t_CurrentTag;
+}
+
+void MemoryTracker::SetCurrentTag(MemoryTag tag)
+{
+    t_CurrentTag = tag;
+}
+
+#else
+
+void* MemoryTracker::Allocate(size_t size)
+{
+    return std::malloc(size);
+}
+
+void* MemoryTracker::Reallocate(void* memory, size_t size)
+{
+    return std::realloc(memory, size);
+}
+
+void MemoryTracker::Free(void* memory)
+{
+    std::free(memory);
+}
+
+
+MemoryTag MemoryTracker::GetCurrentTag()
+{
+    return MemoryTag::Untagged;
+}
+
+void MemoryTracker::SetCurrentTag(MemoryTag tag)
+{}
+
+#endif // SNV_MEMORY_TRACKING_ENABLED
+
+
+MemoryTagStats MemoryTracker::GetTagStats(MemoryTag tag)
+{
+    const auto& tagCounters = g_TagCounters[static_cast<ui64>(tag)];
+
+    return MemoryTagStats{
+        .CurrentBytes       = tagCounters.CurrentBytes.load(std::memory_order_relaxed),
+        .PeakBytes          = tagCounters.PeakBytes.load(std::memory_order_relaxed),
+        .CurrentAllocations = tagCounters.CurrentAllocations.load(std::memory_order_relaxed),
+        .TotalAllocations   = tagCounters.TotalAllocations.load(std::memory_order_relaxed),
+    };
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    return k_MemoryTagNames[static_cast<ui64>(tag)];
+}
+
+void MemoryTracker::LogTagStats()
+{
+    for (ui64 i = 0; i < static_cast<ui64>(MemoryTag::Count); ++i)
+    {
+        const auto tag      = static_cast<MemoryTag>(i);
+        const auto tagStats = GetTagStats(tag);
+
+        LOG_INFO(
+            "Memory: {:<9} | current {:.3f}MB in {} allocations | peak {:.3f}MB | {} allocations total",
+            GetTagName(tag),
+            tagStats.CurrentBytes / (1024.0 * 1024.0),
+            tagStats.CurrentAllocations,
+            tagStats.PeakBytes / (1024.0 * 1024.0),
+            tagStats.TotalAllocations
+        );
+    }
+}
+
+
+ui64 MemoryTracker::GetHeapAllocationCount()
+{
+    return g_HeapAllocationCount.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::SetHeapAllocationGuardMode(HeapAllocationGuardMode guardMode)
+{
+    g_HeapAllocationGuardMode.store(guardMode, std::memory_order_relaxed);
+}
+
+
+bool MemoryTracker::BeginHeapAllocationGuard()
+{
+    const auto wasAllocationForbidden = t_IsHeapAllocationForbidden;
+    if (g_HeapAllocationGuardMode.load(std::memory_order_relaxed) == HeapAllocationGuardMode::Assert)
+    {
+        t_IsHeapAllocationForbidden = true;
+    }
+
+    return wasAllocationForbidden;
+}
+
+void MemoryTracker::EndHeapAllocationGuard(bool wasAllocationForbidden)
+{
+    t_IsHeapAllocationForbidden = wasAllocationForbidden;
+}
+
+} // namespace snv
+
+
+#ifdef SNV_MEMORY_TRACKING_ENABLED
+
+// NOTE(v.matushkin): Every form is replaced, the aligned ones too, so overaligned allocations are tracked
+//  and the default allocator never sees a block that came from here.
+//  The engine is a static library, these have to stay in the same translation unit as MemoryTracker
+//  so the linker always picks them up.
+
+void* operator new(std::size_t size)
+{
+    // NOTE(v.matushkin): new of 0 bytes still has to return a unique pointer
+    if (auto memory = snv::MemoryTracker::Allocate(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return snv::MemoryTracker::Allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return snv::MemoryTracker::Allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+
+//- Overaligned
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto memory = AllocateAligned(size == 0 ? 1 : size, static_cast<std::size_t>(alignment)))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    snv::MemoryTracker::Free(memory);
+}
+
+#endif // SNV_MEMORY_TRACKING_ENABLED
@@ -0,0 +1,274 @@
+#include <Engine/Core/Profiler.hpp>
+
+#include <Engine/Core/Log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// NOTE(v.matushkin): 16 bytes per event, 1MB per thread
+constexpr ui64 k_EventsPerThread = 64 * 1024;
+
+
+struct ProfileEvent
+{
+    const char* ZoneName;  // NOTE(v.matushkin): nullptr for the end of a zone
+    ui64        Timestamp; // NOTE(v.matushkin): Nanoseconds since g_Epoch
+};
+
+struct ThreadEvents
+{
+    std::unique_ptr<ProfileEvent[]> Events;
+    // NOTE(v.matushkin): Monotonic, (Head % k_EventsPerThread) is the next event. Only the owning thread writes,
+    //  release on the store publishes the event to EndCapture()
+    std::atomic<ui64>               Head;
+    std::atomic<const char*>        ThreadName;
+    ui32                            ThreadId; // NOTE(v.matushkin): In the order of the first zone
+};
+
+
+const Clock::time_point g_Epoch = Clock::now();
+
+// NOTE(v.matushkin): Guards g_Threads, only taken once per thread and by EndCapture().
+//  ThreadEvents are never freed, the events of a finished thread can still be captured
+std::mutex                                 g_ThreadsMutex;
+std::vector<std::unique_ptr<ThreadEvents>> g_Threads;
+
+std::atomic<bool> g_IsCapturing = false;
+ui64              g_CaptureStart;
+
+thread_local ThreadEvents* t_ThreadEvents = nullptr;
+
+
+ui64 GetTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_Epoch).count();
+}
+
+ThreadEvents& GetThreadEvents()
+{
+    if (t_ThreadEvents == nullptr)
+    {
+        auto threadEvents = std::make_unique<ThreadEvents>();
+        threadEvents->Events = std::make_unique<ProfileEvent[]>(k_EventsPerThread);
+        threadEvents->Head.store(0, std::memory_order_relaxed);
+        threadEvents->ThreadName.store(nullptr, std::memory_order_relaxed);
+
+        std::scoped_lock lock(g_ThreadsMutex);
+        threadEvents->ThreadId = static_cast<ui32>(g_Threads.size());
+        t_ThreadEvents         = threadEvents.get();
+        g_Threads.push_back(std::move(threadEvents));
+    }
+
+    return *t_ThreadEvents;
+}
+
+void PushEvent(const char* zoneName)
+{
+    auto&      threadEvents = GetThreadEvents();
+    const auto head         = threadEvents.Head.load(std::memory_order_relaxed);
+
+    threadEvents.Events[head % k_EventsPerThread] = ProfileEvent{
+        .ZoneName  = zoneName,
+        .Timestamp = GetTimestamp(),
+    };
+    threadEvents.Head.store(head + 1, std::memory_order_release);
+}
+
+
+void WriteTraceEvent(std::ofstream& traceFile, bool& isFirstEvent, const char* phase, const char* zoneName, ui64 timestamp, ui32 threadId)
+{
+    if (isFirstEvent == false)
+    {
+        traceFile << ",\n";
+    }
+    isFirstEvent = false;
+
+    // NOTE(v.matushkin): Zone names are string literals, there is nothing to escape. ts is in microseconds
+    traceFile << "{\"ph\":\"" << phase << "\",\"pid\":0,\"tid\":" << threadId << ",\"ts\":" << (timestamp / 1000.0);
+    if (zoneName != nullptr)
+    {
+        traceFile << ",\"name\":\"" << zoneName << "\"";
+    }
+    traceFile << "}";
+}
+
+// NOTE(v.matushkin): Writes the events of [captureStart, captureEnd] so that every zone is balanced,
+//  zones that started before the capture begin at captureStart, zones that are still open end at captureEnd
+void WriteThreadEvents(
+    std::ofstream&                   traceFile,
+    bool&                            isFirstEvent,
+    const std::vector<ProfileEvent>& events,
+    ui32                             threadId,
+    ui64                             captureStart,
+    ui64                             captureEnd
+)
+{
+    std::vector<const char*> openZones;
+    bool                     isCaptureStarted = false;
+
+    const auto startCapture = [&]() {
+        if (isCaptureStarted == false)
+        {
+            isCaptureStarted = true;
+            for (const auto zoneName : openZones)
+            {
+                WriteTraceEvent(traceFile, isFirstEvent, "B", zoneName, captureStart, threadId);
+            }
+        }
+    };
+
+    for (const auto& event : events)
+    {
+        if (event.Timestamp > captureEnd)
+        {
+            break;
+        }
+
+        const auto isInCapture = event.Timestamp >= captureStart;
+        if (isInCapture)
+        {
+            startCapture();
+        }
+
+        if (event.ZoneName != nullptr)
+        {
+            openZones.push_back(event.ZoneName);
+            if (isInCapture)
+            {
+                WriteTraceEvent(traceFile, isFirstEvent, "B", event.ZoneName, event.Timestamp, threadId);
+            }
+        }
+        // NOTE(v.matushkin): The begin of this zone was pushed out of the ring buffer
+        else if (openZones.empty() == false)
+        {
+            openZones.pop_back();
+            if (isInCapture)
+            {
+                WriteTraceEvent(traceFile, isFirstEvent, "E", nullptr, event.Timestamp, threadId);
+            }
+        }
+    }
+
+    startCapture();
+    for (ui64 i = 0; i < openZones.size(); ++i)
+    {
+        WriteTraceEvent(traceFile, isFirstEvent, "E", nullptr, captureEnd, threadId);
+    }
+}
+
+} // namespace
+
+
+namespace snv
+{
+
+void Profiler::BeginZone(const char* zoneName)
+{
+    PushEvent(zoneName);
+}
+
+void Profiler::EndZone()
+{
+    PushEvent(nullptr);
+}
+
+void Profiler::SetThreadName(const char* threadName)
+{
+    GetThreadEvents().ThreadName.store(threadName, std::memory_order_relaxed);
+}
+
+
+void Profiler::BeginCapture()
+{
+    g_CaptureStart = GetTimestamp();
+    g_IsCapturing.store(true, std::memory_order_relaxed);
+}
+
+bool Profiler::IsCapturing()
+{
+    return g_IsCapturing.load(std::memory_order_relaxed);
+}
+
+bool Profiler::EndCapture(const std::string& filePath)
+{
+    const auto captureStart = g_CaptureStart;
+    const auto captureEnd   = GetTimestamp();
+    g_IsCapturing.store(false, std::memory_order_relaxed);
+
+    std::ofstream traceFile(filePath, std::ios::out | std::ios::trunc);
+    if (traceFile.is_open() == false)
+    {
+        LOG_ERROR("Profiler: can't open {} for writing", filePath);
+        return false;
+    }
+
+    traceFile << std::fixed << std::setprecision(3);
+    traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool                      isFirstEvent = true;
+    std::vector<ProfileEvent> events;
+
+    std::scoped_lock lock(g_ThreadsMutex);
+    for (const auto& threadEvents : g_Threads)
+    {
+        //- Copy the ring buffer out
+        // NOTE(v.matushkin): The thread keeps recording, the events it overwrote while they were copied are torn,
+        //  so everything older than the head after the copy minus the buffer size is dropped
+        const auto head       = threadEvents->Head.load(std::memory_order_acquire);
+        const auto firstEvent = head > k_EventsPerThread ? head - k_EventsPerThread : 0;
+
+        events.clear();
+        for (auto i = firstEvent; i < head; ++i)
+        {
+            events.push_back(threadEvents->Events[i % k_EventsPerThread]);
+        }
+
+        const auto headAfterCopy   = threadEvents->Head.load(std::memory_order_acquire);
+        const auto firstValidEvent = headAfterCopy + 1 > k_EventsPerThread ? headAfterCopy + 1 - k_EventsPerThread : 0;
+        if (firstValidEvent > firstEvent)
+        {
+            const auto tornEventCount = std::min(static_cast<size_t>(firstValidEvent - firstEvent), events.size());
+            events.erase(events.begin(), events.begin() + tornEventCount);
+        }
+
+        //- Write
+        const auto threadId   = threadEvents->ThreadId;
+        const auto threadName = threadEvents->ThreadName.load(std::memory_order_relaxed);
+        if (threadName != nullptr)
+        {
+            if (isFirstEvent == false)
+            {
+                traceFile << ",\n";
+            }
+            isFirstEvent = false;
+            traceFile << "{\"ph\":\"M\",\"pid\":0,\"tid\":" << threadId << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << threadName << "\"}}";
+        }
+
+        WriteThreadEvents(traceFile, isFirstEvent, events, threadId, captureStart, captureEnd);
+    }
+
+    traceFile << "\n]}\n";
+
+    if (traceFile.good() == false)
+    {
+        LOG_ERROR("Profiler: failed to write {}", filePath);
+        return false;
+    }
+
+    LOG_INFO("Profiler: capture of {:.3f}ms written to {}", (captureEnd - captureStart) / 1'000'000.0, filePath);
+    return true;
+}
+
+} // namespace snv
@@ -20,8 +20,16 @@ const char* k_AssetDir      = "../../assets/";
 const char* k_SponzaObjPath = "Sponza/sponza.obj";
 const char* k_ShaderName    = "triangle";
 
+// NOTE(v.matushkin): Recompile the shaders when their sources change
+const bool k_ShaderHotReload = true;
+
 const snv::GraphicsApi k_GraphicsApi = snv::GraphicsApi::Vulkan;
 
+const snv::SwapchainDesc k_SwapchainDesc = {
+    .PreferredPresentMode = snv::PresentMode::Mailbox,
+    .FramesInFlight       = 2,
+};
+
 
 namespace snv
 {
@@ -35,13 +43,17 @@ void Engine::OnCreate()
     const auto windowWidth  = Window::GetWidth();
     const auto windowHeight = Window::GetHeight();
 
-    Renderer::Init(k_GraphicsApi);
+    Renderer::Init(k_GraphicsApi, k_SwapchainDesc);
     Renderer::SetViewport(0, 0, windowWidth, windowHeight);
     Renderer::SetClearColor(0.5f, 0.5f, 0.5f, 1.0f);
     Renderer::EnableDepthTest();
     Renderer::SetDepthFunction(DepthFunction::Less);
 
     AssetDatabase::Init(k_AssetDir);
+    if (k_ShaderHotReload)
+    {
+        AssetDatabase::EnableShaderHotReload();
+    }
 
     (void) AssetDatabase::LoadAsset<Shader>(k_ShaderName);
 
@@ -60,6 +72,7 @@ void Engine::OnDestroy()
 {
     LOG_TRACE("SuperNova-Engine Shutdown");
 
+    AssetDatabase::Shutdown();
     Renderer::Shutdown();
 }
 
@@ -2,9 +2,11 @@
 
 #include <Engine/Application/Window.hpp>
 #include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Profiler.hpp>
 
 #include <dxgi1_6.h>
 
+#include <algorithm>
 #include <string>
 
 
@@ -86,10 +88,35 @@
 const ui32 k_WindowWidth  = 1100;
 const ui32 k_WindowHeight = 800;
 
-const D3D12_INPUT_ELEMENT_DESC k_InputElementDesc[] = {
-    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    {"NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    {"TEXCOORD", 0, DXGI_FORMAT_R32G32B32_FLOAT, 2, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+// NOTE(v.matushkin): Same as in DX11Backend, place it in something like DXCommon.hpp?
+const char* dx12_VertexAttributeSemantic[] = {
+    "POSITION", // VertexAttribute::Position
+    "NORMAL",   // VertexAttribute::Normal
+    "TEXCOORD", // VertexAttribute::TexCoord0
+};
+
+// NOTE(v.matushkin): [VertexAttributeFormat][Dimension - 1], there are no 3 component 8/16 bit or 64 bit vertex formats in DXGI
+const DXGI_FORMAT dx12_VertexAttributeFormat[][4] = {
+    {DXGI_FORMAT_R8_SINT,   DXGI_FORMAT_R8G8_SINT,   DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R8G8B8A8_SINT},       // Int8
+    {DXGI_FORMAT_R16_SINT,  DXGI_FORMAT_R16G16_SINT, DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R16G16B16A16_SINT},   // Int16
+    {DXGI_FORMAT_R32_SINT,  DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G32B32_SINT,  DXGI_FORMAT_R32G32B32A32_SINT},   // Int32
+    {DXGI_FORMAT_R8_UINT,   DXGI_FORMAT_R8G8_UINT,   DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R8G8B8A8_UINT},       // UInt8
+    {DXGI_FORMAT_R16_UINT,  DXGI_FORMAT_R16G16_UINT, DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R16G16B16A16_UINT},   // UInt16
+    {DXGI_FORMAT_R32_UINT,  DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT,  DXGI_FORMAT_R32G32B32A32_UINT},   // UInt32
+    {DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_FLOAT},  // Float16
+    {DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT}, // Float32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,     DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_UNKNOWN},             // Float64
+};
+const DXGI_FORMAT dx12_VertexAttributeFormatNormalized[][4] = {
+    {DXGI_FORMAT_R8_SNORM,  DXGI_FORMAT_R8G8_SNORM,   DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R8G8B8A8_SNORM},      // Int8
+    {DXGI_FORMAT_R16_SNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_SNORM},  // Int16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Int32
+    {DXGI_FORMAT_R8_UNORM,  DXGI_FORMAT_R8G8_UNORM,   DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R8G8B8A8_UNORM},      // UInt8
+    {DXGI_FORMAT_R16_UNORM, DXGI_FORMAT_R16G16_UNORM, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_UNORM},  // UInt16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // UInt32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float64
 };
 
 // NOTE(v.matushkin): Same as in DX11Backend, place it in something like DXCommon.hpp?
@@ -195,7 +222,12 @@ DX12Backend::DX12Backend()
     CreateFence();
 
     CreateConstantBuffer(m_cbPerFrame.GetAddressOf(), sizeof(PerFrame) * k_BackBufferFrames);
-    CreateConstantBuffer(m_cbPerDraw.GetAddressOf(), sizeof(PerDraw) * k_BackBufferFrames);
+    CreateConstantBuffer(m_cbPerDraw.GetAddressOf(), sizeof(PerDraw) * k_MaxDrawsPerFrame * k_BackBufferFrames);
+    {
+        D3D12_RANGE d3dReadRange = { .Begin = 0, .End = 0 };
+        m_cbPerFrame->Map(0, &d3dReadRange, reinterpret_cast<void**>(&m_cbPerFrameMapped));
+        m_cbPerDraw->Map(0, &d3dReadRange, reinterpret_cast<void**>(&m_cbPerDrawMapped));
+    }
 
     CreateRootSignature();
 
@@ -253,8 +285,10 @@ void DX12Backend::Clear(BufferBit bufferBitMask)
 {}
 
 
-void DX12Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
+void DX12Backend::BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
 {
+    PROFILE_ZONE("DX12Backend::BeginFrame");
+
     // TODO(v.matushkin): <RenderGraph>
     if (g_IsPipelineInitialized == false)
     {
@@ -273,25 +307,15 @@ void DX12Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4&
     {
         m_cbPerFrameData._CameraProjection = cameraProjection;
         m_cbPerFrameData._CameraView       = cameraView;
-        m_cbPerDrawData._ObjectToWorld     = localToWorld;
 
         const auto cbPerFrameStartByte = m_currentBackBufferIndex * sizeof(PerFrame);
-        const auto cbPerDrawStartByte  = m_currentBackBufferIndex * sizeof(PerDraw);
-        D3D12_RANGE d3dReadRange = { .Begin = 0, .End = 0 };
-        ui8* cbDataBegin;
-
-        m_cbPerFrame->Map(0, &d3dReadRange, reinterpret_cast<void**>(&cbDataBegin));
-        std::memcpy(&cbDataBegin[cbPerFrameStartByte], &m_cbPerFrameData, sizeof(PerFrame));
-        m_cbPerFrame->Unmap(0, nullptr);
-
-        m_cbPerDraw->Map(0, &d3dReadRange, reinterpret_cast<void**>(&cbDataBegin));
-        std::memcpy(&cbDataBegin[cbPerDrawStartByte], &m_cbPerDrawData, sizeof(PerDraw));
-        m_cbPerDraw->Unmap(0, nullptr);
+        std::memcpy(&m_cbPerFrameMapped[cbPerFrameStartByte], &m_cbPerFrameData, sizeof(PerFrame));
 
         const auto cbPerFrameLocation = m_cbPerFrame->GetGPUVirtualAddress() + cbPerFrameStartByte;
-        const auto cbPerDrawLocation  = m_cbPerDraw->GetGPUVirtualAddress() + cbPerDrawStartByte;
         m_graphicsCommandList->SetGraphicsRootConstantBufferView(RootParameterIndex::cbPerFrame, cbPerFrameLocation);
-        m_graphicsCommandList->SetGraphicsRootConstantBufferView(RootParameterIndex::cbPerDraw, cbPerDrawLocation);
+
+        // NOTE(v.matushkin): PerDraw is set by the SetObjectToWorld commands in Submit
+        m_cbPerDrawCount = 0;
     }
 
     //- Set DescriptorHeaps
@@ -334,6 +358,8 @@ void DX12Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4&
 
 void DX12Backend::EndFrame()
 {
+    PROFILE_ZONE("DX12Backend::EndFrame");
+
     //- Transition RenderTarget from RENDER_TARGET to PRESENT
     D3D12_RESOURCE_TRANSITION_BARRIER d3dResourceTransitionBarrier = {
         .pResource   = m_backBuffers[m_currentBackBufferIndex].Get(),
@@ -363,21 +389,69 @@ void DX12Backend::EndFrame()
 }
 
 // NOTE(v.matushkin): Useless vertexCount?
-void DX12Backend::DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount)
+void DX12Backend::Submit(const RenderCommandStream& commandStream)
 {
-    //- Set Index/Vertex buffers
-    const auto& buffer = m_buffers[bufferHandle];
-    D3D12_VERTEX_BUFFER_VIEW d3dVertexBuffers[] = {buffer.PositionView, buffer.NormalView, buffer.TexCoord0View};
-    m_graphicsCommandList->IASetIndexBuffer(&buffer.IndexView);
-    m_graphicsCommandList->IASetVertexBuffers(0, 3, d3dVertexBuffers);
-
-    //- Set Material Texture
-    const auto& texture = m_textures[textureHandle];
-    auto srvGPUDescriptorHandle = m_descriptorHeapSRV->GetGPUDescriptorHandleForHeapStart();
-    srvGPUDescriptorHandle.ptr += m_srvDescriptorSize * texture.IndexInDescriptorHeap;
-    m_graphicsCommandList->SetGraphicsRootDescriptorTable(RootParameterIndex::dtTextures, srvGPUDescriptorHandle);
-
-    m_graphicsCommandList->DrawIndexedInstanced(indexCount, 1, 0, 0, 0);
+    PROFILE_ZONE("DX12Backend::Submit");
+
+    for (RenderCommandReader reader(commandStream); reader.IsEnd() == false;)
+    {
+        switch (reader.GetType())
+        {
+        case RenderCommandType::BindBuffer:
+        {
+            const auto& command = reader.Read<BindBufferCommand>();
+            const auto& buffer  = m_buffers[command.Buffer];
+
+            m_graphicsCommandList->IASetIndexBuffer(&buffer.IndexView);
+            m_graphicsCommandList->IASetVertexBuffers(0, static_cast<ui32>(m_vertexLayout.size()), buffer.VertexViews);
+            break;
+        }
+        case RenderCommandType::BindTexture:
+        {
+            const auto& command = reader.Read<BindTextureCommand>();
+            const auto& texture = m_textures[command.Texture];
+
+            auto srvGPUDescriptorHandle = m_descriptorHeapSRV->GetGPUDescriptorHandleForHeapStart();
+            srvGPUDescriptorHandle.ptr += m_srvDescriptorSize * texture.IndexInDescriptorHeap;
+            m_graphicsCommandList->SetGraphicsRootDescriptorTable(RootParameterIndex::dtTextures, srvGPUDescriptorHandle);
+            break;
+        }
+        case RenderCommandType::SetObjectToWorld:
+            SetPerDraw(reader.Read<SetObjectToWorldCommand>().ObjectToWorld);
+            break;
+        case RenderCommandType::DrawIndexed:
+        {
+            const auto& command = reader.Read<DrawIndexedCommand>();
+            m_graphicsCommandList->DrawIndexedInstanced(command.IndexCount, 1, 0, 0, 0);
+            break;
+        }
+        case RenderCommandType::DrawIndexedInstanced:
+        {
+            // TODO(v.matushkin): Real instancing needs PerDraw as a StructuredBuffer indexed with SV_InstanceID,
+            //  for now every instance is its own draw with its own cbPerDraw
+            const auto& command   = reader.Read<DrawIndexedInstancedCommand>();
+            const auto  instances = commandStream.GetInstanceData().subspan(command.FirstInstance, command.InstanceCount);
+            for (const auto& objectToWorld : instances)
+            {
+                SetPerDraw(objectToWorld);
+                m_graphicsCommandList->DrawIndexedInstanced(command.IndexCount, 1, 0, 0, 0);
+            }
+            break;
+        }
+        }
+    }
+}
+
+void DX12Backend::SetPerDraw(const glm::mat4x4& objectToWorld)
+{
+    // NOTE(v.matushkin): Linear allocation from the current back buffer part of m_cbPerDraw,
+    //  it is only reused after WaitForPreviousFrame(), so nothing in flight is overwritten
+    SNV_ASSERT(m_cbPerDrawCount < k_MaxDrawsPerFrame, "Too many draws in one frame, increase k_MaxDrawsPerFrame");
+    const auto cbPerDrawStartByte = (m_currentBackBufferIndex * k_MaxDrawsPerFrame + m_cbPerDrawCount++) * sizeof(PerDraw);
+    std::memcpy(&m_cbPerDrawMapped[cbPerDrawStartByte], &objectToWorld, sizeof(glm::mat4x4));
+
+    const auto cbPerDrawLocation = m_cbPerDraw->GetGPUVirtualAddress() + cbPerDrawStartByte;
+    m_graphicsCommandList->SetGraphicsRootConstantBufferView(RootParameterIndex::cbPerDraw, cbPerDrawLocation);
 }
 
 void DX12Backend::DrawArrays(i32 count)
@@ -390,6 +464,7 @@ void DX12Backend::DrawElements(i32 count)
 // TODO(v.matushkin): Upload index buffer, better memory managment
 BufferHandle DX12Backend::CreateBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 )
@@ -441,49 +516,45 @@ BufferHandle DX12Backend::CreateBuffer(
     // Initialize the vertex buffer view.
     dx12Buffer.IndexView.BufferLocation = dx12Buffer.Index->GetGPUVirtualAddress();
     dx12Buffer.IndexView.SizeInBytes    = indexData.size_bytes();
-    dx12Buffer.IndexView.Format         = DXGI_FORMAT_R32_UINT;
+    dx12Buffer.IndexView.Format         = indexFormat == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 
-    ID3D12Resource2* d3dResources[] = {
-        dx12Buffer.Position.Get(),
-        dx12Buffer.Normal.Get(),
-        dx12Buffer.TexCoord0.Get(),
-    };
-    D3D12_VERTEX_BUFFER_VIEW* d3dVertexBufferViews[] = {
-        &dx12Buffer.PositionView,
-        &dx12Buffer.NormalView,
-        &dx12Buffer.TexCoord0View,
-    };
+    //- Check the vertex format
+    if (m_vertexLayout.empty())
+    {
+        SNV_ASSERT(g_IsPipelineInitialized == false, "The pipeline was created without a vertex layout");
+        m_vertexLayout = vertexLayout;
+    }
+    SNV_ASSERT(
+        std::equal(vertexLayout.begin(), vertexLayout.end(), m_vertexLayout.begin(), m_vertexLayout.end(), IsSameVertexFormat),
+        "Every buffer must have the same vertex format, there is only one pipeline"
+    );
 
-    // TODO(v.matushkin): At least I should use one heap for this vertex buffers
+    // NOTE(v.matushkin): One buffer for all the attributes, the layout tells where each one of them is
+    d3dResourceDesc.Width = vertexData.size_bytes();
+    m_device->CreateCommittedResource2(
+        &d3dHeapProperties,
+        D3D12_HEAP_FLAG_NONE,               // NOTE(v.matushkin): Sure?
+        &d3dResourceDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,  // NOTE(v.matushkin): Sure?
+        nullptr,                            // D3D12_CLEAR_VALUE is null for buffers
+        nullptr,                            // ID3D12ProtectedResourceSession1
+        IID_PPV_ARGS(dx12Buffer.Vertex.GetAddressOf())
+    );
+    ui8* vertexDataBegin;
+    dx12Buffer.Vertex->Map(0, &d3dRange, reinterpret_cast<void**>(&vertexDataBegin));
+    std::memcpy(vertexDataBegin, vertexData.data(), vertexData.size_bytes());
+    dx12Buffer.Vertex->Unmap(0, nullptr);
+
+    const auto vertexBufferLocation = dx12Buffer.Vertex->GetGPUVirtualAddress();
     for (ui32 i = 0; i < vertexLayout.size(); ++i)
     {
-        // TODO(v.matushkin): Adjust VertexAttributeDescriptor to remove this hacks
         const auto& vertexAttribute = vertexLayout[i];
-        const auto  currOffset      = vertexAttribute.Offset;
-        const auto  nextOffset      = (i + 1) < vertexLayout.size() ? vertexLayout[i + 1].Offset : vertexData.size_bytes();
-        const auto  attributeSize   = (nextOffset - currOffset);
-
-        d3dResourceDesc.Width = attributeSize;
-
-        auto hr = m_device->CreateCommittedResource2(
-            &d3dHeapProperties,
-            D3D12_HEAP_FLAG_NONE,               // NOTE(v.matushkin): Sure?
-            &d3dResourceDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,  // NOTE(v.matushkin): Sure?
-            nullptr,                            // D3D12_CLEAR_VALUE is null for buffers
-            nullptr,                            // ID3D12ProtectedResourceSession1
-            IID_PPV_ARGS(&d3dResources[i])
-        );
-
-        // Copy the triangle data to the vertex buffer.
-        ui8* vertexDataBegin;
-        d3dResources[i]->Map(0, &d3dRange, reinterpret_cast<void**>(&vertexDataBegin));
-        std::memcpy(vertexDataBegin, vertexData.data() + currOffset, attributeSize);
-        d3dResources[i]->Unmap(0, nullptr);
-        // Initialize the vertex buffer view.
-        d3dVertexBufferViews[i]->BufferLocation = d3dResources[i]->GetGPUVirtualAddress();
-        d3dVertexBufferViews[i]->StrideInBytes  = sizeof(f32) * 3;
-        d3dVertexBufferViews[i]->SizeInBytes    = attributeSize;
+
+        dx12Buffer.VertexViews[i] = D3D12_VERTEX_BUFFER_VIEW{
+            .BufferLocation = vertexBufferLocation + vertexAttribute.Offset,
+            .SizeInBytes    = static_cast<ui32>(vertexData.size_bytes() - vertexAttribute.Offset),
+            .StrideInBytes  = vertexAttribute.Stride,
+        };
     }
 
     static ui32 buffer_handle_workaround = 0;
@@ -511,7 +582,7 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
         .Width                    = textureDesc.Width,
         .Height                   = textureDesc.Height,
         .DepthOrArraySize         = 1,
-        .MipLevels                = 1,
+        .MipLevels                = static_cast<UINT16>(textureDesc.MipCount),
         .Format                   = dxgiTextureFormat,
         .SampleDesc               = dxgiSampleDesc,
         // .Layout                   = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,  //NOTE(v.matushkin): ???
@@ -539,15 +610,17 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
     );
 
     //- Create CPU -> GPU upload buffer
-    ui64 uploadBufferSize;
-    D3D12_PLACED_SUBRESOURCE_FOOTPRINT d3dTextureLayout;
-    ui32 numRows;
+    const auto mipCount = textureDesc.MipCount;
+
+    ui64                                            uploadBufferSize;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> d3dTextureLayouts(mipCount);
+    std::vector<ui32>                               numRows(mipCount);
 
     m_device->GetCopyableFootprints1(
         &d3dResourceDesc,
-        0, 1, 0,
-        &d3dTextureLayout,
-        &numRows,
+        0, mipCount, 0,
+        d3dTextureLayouts.data(),
+        numRows.data(),
         nullptr,
         &uploadBufferSize
     );
@@ -555,6 +628,7 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
     d3dResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
     d3dResourceDesc.Width     = uploadBufferSize;
     d3dResourceDesc.Height    = 1;
+    d3dResourceDesc.MipLevels = 1;
     d3dResourceDesc.Format    = DXGI_FORMAT_UNKNOWN;
     d3dResourceDesc.Layout    = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
@@ -572,35 +646,35 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
     );
 
     //- Copy texture to the GPU
-    // TODO(v.matushkin): I can get RowPitch/SlicePitch from TextureDesc or from GetCopyableFootprints1, is there any difference?
-    const auto rowPitch = d3dTextureLayout.Footprint.RowPitch;
-    D3D12_SUBRESOURCE_DATA d3dSubresourceData = {
-        .pData      = textureData,
-        .RowPitch   = rowPitch,
-        .SlicePitch = rowPitch * numRows,
-    };
-
     //-- Copy texture to intermediate upload heap
+    // NOTE(v.matushkin): Texture data mips are tightly packed, but upload heap rows are
+    //  D3D12_TEXTURE_DATA_PITCH_ALIGNMENT aligned, so it has to be copied row by row
     D3D12_RANGE d3dReadRange = { .Begin = 0, .End = 0 };
     ui8* uploadBufferBegin;
     // NOTE(v.matushkin): Can pass nullptr instead of d3dReadRange, is it the same thing?
     d3dTextureUploadHeap->Map(0, &d3dReadRange, reinterpret_cast<void**>(&uploadBufferBegin));
-    std::memcpy(uploadBufferBegin, textureData, uploadBufferSize);
+    {
+        const auto pixelSize = GetTextureFormatSize(textureDesc.Format);
+        const ui8* mipData   = textureData;
+
+        for (ui32 mip = 0; mip < mipCount; ++mip)
+        {
+            const auto& d3dTextureLayout = d3dTextureLayouts[mip];
+            const auto  mipRowSize       = GetMipDimension(textureDesc.Width, mip) * pixelSize;
+            const auto  uploadRowPitch   = d3dTextureLayout.Footprint.RowPitch;
+            auto        uploadMipBegin   = uploadBufferBegin + d3dTextureLayout.Offset;
+
+            for (ui32 row = 0; row < numRows[mip]; ++row)
+            {
+                std::memcpy(uploadMipBegin + row * uploadRowPitch, mipData + row * mipRowSize, mipRowSize);
+            }
+
+            mipData += GetMipSize(textureDesc, mip);
+        }
+    }
     // NOTE(v.matushkin): Does it needs to be Unmapped?
     d3dTextureUploadHeap->Unmap(0, nullptr);
 
-    //-- Copy texture from upload heap to GPU
-    D3D12_TEXTURE_COPY_LOCATION d3dTextureCopyLocationSrc = {
-        .pResource       = d3dTextureUploadHeap.Get(),
-        .Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
-        .PlacedFootprint = d3dTextureLayout
-    };
-    D3D12_TEXTURE_COPY_LOCATION d3dTextureCopyLocationDst = {
-        .pResource        = dx12Texture.Texture.Get(),
-        .Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
-        .SubresourceIndex = 0
-    };
-
     D3D12_RESOURCE_TRANSITION_BARRIER d3dResourceTransitionBarrier = {
         .pResource   = dx12Texture.Texture.Get(),
         .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, // NOTE(v.matushkin): ???
@@ -616,8 +690,22 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
     auto commandAllocator = m_commandAllocators[0].Get();
     commandAllocator->Reset();
     m_graphicsCommandList->Reset(commandAllocator, nullptr);
-    // NOTE(v.matushkin): The fuck is DstX/DstY/DstZ and pSrcBox ?
-    m_graphicsCommandList->CopyTextureRegion(&d3dTextureCopyLocationDst, 0, 0, 0, &d3dTextureCopyLocationSrc, nullptr);
+    //-- Copy texture from upload heap to GPU
+    for (ui32 mip = 0; mip < mipCount; ++mip)
+    {
+        D3D12_TEXTURE_COPY_LOCATION d3dTextureCopyLocationSrc = {
+            .pResource       = d3dTextureUploadHeap.Get(),
+            .Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+            .PlacedFootprint = d3dTextureLayouts[mip]
+        };
+        D3D12_TEXTURE_COPY_LOCATION d3dTextureCopyLocationDst = {
+            .pResource        = dx12Texture.Texture.Get(),
+            .Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+            .SubresourceIndex = mip
+        };
+        // NOTE(v.matushkin): The fuck is DstX/DstY/DstZ and pSrcBox ?
+        m_graphicsCommandList->CopyTextureRegion(&d3dTextureCopyLocationDst, 0, 0, 0, &d3dTextureCopyLocationSrc, nullptr);
+    }
     m_graphicsCommandList->ResourceBarrier(1, &d3dResourceBarrier);
     m_graphicsCommandList->Close();
 
@@ -627,7 +715,7 @@ TextureHandle DX12Backend::CreateTexture(const TextureDesc& textureDesc, const u
     //- Create Texture SRV
     D3D12_TEX2D_SRV d3dTexture2DSRV = {
         // .MostDetailedMip     = ,
-        .MipLevels           = 1,
+        .MipLevels           = textureDesc.MipCount,
         // .PlaneSlice          = ,
         // .ResourceMinLODClamp = ,
     };
@@ -669,6 +757,13 @@ ShaderHandle DX12Backend::CreateShader(std::span<const char> vertexSource, std::
     return shaderHandle;
 }
 
+bool DX12Backend::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    // TODO(v.matushkin): Shaders are bound directly, there is nothing to swap at a frame boundary yet
+    LOG_WARN("DX12Backend: shader hot reload is not supported");
+    return false;
+}
+
 
 void DX12Backend::CreateDevice()
 {
@@ -1120,9 +1215,28 @@ void DX12Backend::CreatePipeline()
         // .FrontFace        = , // D3D12_DEPTH_STENCILOP_DESC
         // .BackFace         = , // D3D12_DEPTH_STENCILOP_DESC
     };
+    // NOTE(v.matushkin): Input slot per attribute, so AlignedByteOffset is always 0
+    D3D12_INPUT_ELEMENT_DESC d3dInputElementDescs[static_cast<ui8>(VertexAttribute::Count)];
+    for (ui32 i = 0; i < m_vertexLayout.size(); ++i)
+    {
+        const auto& vertexAttribute = m_vertexLayout[i];
+        const auto  dxgiFormatTable = vertexAttribute.Normalized ? dx12_VertexAttributeFormatNormalized : dx12_VertexAttributeFormat;
+        const auto  dxgiFormat      = dxgiFormatTable[static_cast<ui8>(vertexAttribute.Format)][vertexAttribute.Dimension - 1];
+        SNV_ASSERT(dxgiFormat != DXGI_FORMAT_UNKNOWN, "Unsupported vertex attribute format");
+
+        d3dInputElementDescs[i] = D3D12_INPUT_ELEMENT_DESC{
+            .SemanticName         = dx12_VertexAttributeSemantic[static_cast<ui8>(vertexAttribute.Attribute)],
+            .SemanticIndex        = 0,
+            .Format               = dxgiFormat,
+            .InputSlot            = i,
+            .AlignedByteOffset    = 0,
+            .InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+            .InstanceDataStepRate = 0,
+        };
+    }
     D3D12_INPUT_LAYOUT_DESC d3dInputLayoutDesc = {
-        .pInputElementDescs = k_InputElementDesc,
-        .NumElements        = ARRAYSIZE(k_InputElementDesc),
+        .pInputElementDescs = d3dInputElementDescs,
+        .NumElements        = static_cast<ui32>(m_vertexLayout.size()),
     };
     DXGI_SAMPLE_DESC dxgiSampleDesc = {
         .Count   = 1,
@@ -2,19 +2,43 @@
 
 #include <Engine/Application/Window.hpp>
 #include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Profiler.hpp>
 
 #include <d3d11_4.h>
 #include <d3dcompiler.h>
 
+#include <algorithm>
 #include <string>
 
 
-// TODO(v.matushkin): Find out how D3D11_APPEND_ALIGNED_ELEMENT works
-// TODO(v.matushkin): TEXCOORD to DXGI_FORMAT_R32G32_FLOAT
-constexpr D3D11_INPUT_ELEMENT_DESC k_InputElementDesc[] = {
-    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-    {"NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-    {"TEXCOORD", 0, DXGI_FORMAT_R32G32B32_FLOAT, 2, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+constexpr const char* dx11_VertexAttributeSemantic[] = {
+    "POSITION", // VertexAttribute::Position
+    "NORMAL",   // VertexAttribute::Normal
+    "TEXCOORD", // VertexAttribute::TexCoord0
+};
+
+// NOTE(v.matushkin): [VertexAttributeFormat][Dimension - 1], there are no 3 component 8/16 bit or 64 bit vertex formats in DXGI
+constexpr DXGI_FORMAT dx11_VertexAttributeFormat[][4] = {
+    {DXGI_FORMAT_R8_SINT,   DXGI_FORMAT_R8G8_SINT,   DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R8G8B8A8_SINT},       // Int8
+    {DXGI_FORMAT_R16_SINT,  DXGI_FORMAT_R16G16_SINT, DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R16G16B16A16_SINT},   // Int16
+    {DXGI_FORMAT_R32_SINT,  DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G32B32_SINT,  DXGI_FORMAT_R32G32B32A32_SINT},   // Int32
+    {DXGI_FORMAT_R8_UINT,   DXGI_FORMAT_R8G8_UINT,   DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R8G8B8A8_UINT},       // UInt8
+    {DXGI_FORMAT_R16_UINT,  DXGI_FORMAT_R16G16_UINT, DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_R16G16B16A16_UINT},   // UInt16
+    {DXGI_FORMAT_R32_UINT,  DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT,  DXGI_FORMAT_R32G32B32A32_UINT},   // UInt32
+    {DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_FLOAT},  // Float16
+    {DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT}, // Float32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,     DXGI_FORMAT_UNKNOWN,         DXGI_FORMAT_UNKNOWN},             // Float64
+};
+constexpr DXGI_FORMAT dx11_VertexAttributeFormatNormalized[][4] = {
+    {DXGI_FORMAT_R8_SNORM,  DXGI_FORMAT_R8G8_SNORM,   DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R8G8B8A8_SNORM},      // Int8
+    {DXGI_FORMAT_R16_SNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_SNORM},  // Int16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Int32
+    {DXGI_FORMAT_R8_UNORM,  DXGI_FORMAT_R8G8_UNORM,   DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R8G8B8A8_UNORM},      // UInt8
+    {DXGI_FORMAT_R16_UNORM, DXGI_FORMAT_R16G16_UNORM, DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_R16G16B16A16_UNORM},  // UInt16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // UInt32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float16
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float32
+    {DXGI_FORMAT_UNKNOWN,   DXGI_FORMAT_UNKNOWN,      DXGI_FORMAT_UNKNOWN,        DXGI_FORMAT_UNKNOWN},             // Float64
 };
 
 // NOTE(v.matushkin): Don't know if I should use UINT or UNORM
@@ -110,19 +134,19 @@ void DX11Backend::Clear(BufferBit bufferBitMask)
 {}
 
 
-void DX11Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
+void DX11Backend::BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
 {
+    PROFILE_ZONE("DX11Backend::BeginFrame");
+
     // TODO(v.matushkin): Shouldn't get shader like this, tmp workaround
     const auto& shader = m_shaders.begin()->second;
 
     m_cbPerFrameData._CameraProjection = cameraProjection;
     m_cbPerFrameData._CameraView       = cameraView;
-    m_cbPerDrawData._ObjectToWorld     = localToWorld;
     // Update constant buffers
     // TODO(v.matushkin): UpdateSubresource1 ?
     //  And learn what this parameters do
     m_deviceContext->UpdateSubresource(m_cbPerFrame.Get(), 0, nullptr, &m_cbPerFrameData, 0, 0);
-    m_deviceContext->UpdateSubresource(m_cbPerDraw.Get(), 0, nullptr, &m_cbPerDrawData, 0, 0);
 
     // Clear render targets
     m_deviceContext->ClearRenderTargetView(m_renderTargetView.Get(), m_clearColor);
@@ -134,7 +158,7 @@ void DX11Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4&
 
 
     m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_deviceContext->IASetInputLayout(shader.InputLayout.Get());
+    m_deviceContext->IASetInputLayout(m_inputLayout.Get());
 
     // Set up Vertex shader stage
     ID3D11Buffer* constantBuffers[]{m_cbPerFrame.Get(), m_cbPerDraw.Get()};
@@ -146,26 +170,73 @@ void DX11Backend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4&
 
 void DX11Backend::EndFrame()
 {
+    PROFILE_ZONE("DX11Backend::EndFrame");
+
     m_swapChain->Present(1, 0);
 }
 
-void DX11Backend::DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount)
+void DX11Backend::Submit(const RenderCommandStream& commandStream)
 {
-    // TODO(v.matushkin): Rename, there is no GraphicsBuffer anymore
-    const auto& graphicsBuffer = m_buffers[bufferHandle];
-    const auto& texture        = m_textures[textureHandle];
-
-    ID3D11Buffer* d3dBuffers[] = {graphicsBuffer.Position.Get(), graphicsBuffer.Normal.Get(), graphicsBuffer.TexCoord0.Get()};
-    ui32          strides[]    = {sizeof(f32) * 3, sizeof(f32) * 3, sizeof(f32) * 3};
-    ui32          offset[]     = {0, 0, 0};
+    PROFILE_ZONE("DX11Backend::Submit");
 
-    m_deviceContext->IASetVertexBuffers(0, 3, d3dBuffers, strides, offset);
-    m_deviceContext->IASetIndexBuffer(graphicsBuffer.Index.Get(), DXGI_FORMAT_R32_UINT, 0);
-
-    m_deviceContext->PSSetShaderResources(0, 1, texture.SRV.GetAddressOf());
-    m_deviceContext->PSSetSamplers(0, 1, texture.Sampler.GetAddressOf());
+    for (RenderCommandReader reader(commandStream); reader.IsEnd() == false;)
+    {
+        switch (reader.GetType())
+        {
+        case RenderCommandType::BindBuffer:
+        {
+            const auto& command = reader.Read<BindBufferCommand>();
+            // TODO(v.matushkin): Rename, there is no GraphicsBuffer anymore
+            const auto& graphicsBuffer  = m_buffers[command.Buffer];
+            const auto  vertexSlotCount = static_cast<ui32>(m_vertexLayout.size());
+
+            ID3D11Buffer* d3dBuffers[static_cast<ui8>(VertexAttribute::Count)];
+            std::fill_n(d3dBuffers, vertexSlotCount, graphicsBuffer.Vertex.Get());
+
+            m_deviceContext->IASetVertexBuffers(0, vertexSlotCount, d3dBuffers, graphicsBuffer.VertexStrides, graphicsBuffer.VertexOffsets);
+            m_deviceContext->IASetIndexBuffer(graphicsBuffer.Index.Get(), graphicsBuffer.IndexFormat, 0);
+            break;
+        }
+        case RenderCommandType::BindTexture:
+        {
+            const auto& command = reader.Read<BindTextureCommand>();
+            const auto& texture = m_textures[command.Texture];
+
+            m_deviceContext->PSSetShaderResources(0, 1, texture.SRV.GetAddressOf());
+            m_deviceContext->PSSetSamplers(0, 1, texture.Sampler.GetAddressOf());
+            break;
+        }
+        case RenderCommandType::SetObjectToWorld:
+            SetPerDraw(reader.Read<SetObjectToWorldCommand>().ObjectToWorld);
+            break;
+        case RenderCommandType::DrawIndexed:
+        {
+            const auto& command = reader.Read<DrawIndexedCommand>();
+            m_deviceContext->DrawIndexed(command.IndexCount, 0, 0);
+            break;
+        }
+        case RenderCommandType::DrawIndexedInstanced:
+        {
+            // TODO(v.matushkin): Real instancing needs PerDraw as a StructuredBuffer indexed with SV_InstanceID,
+            //  for now every instance is its own draw
+            const auto& command   = reader.Read<DrawIndexedInstancedCommand>();
+            const auto  instances = commandStream.GetInstanceData().subspan(command.FirstInstance, command.InstanceCount);
+            for (const auto& objectToWorld : instances)
+            {
+                SetPerDraw(objectToWorld);
+                m_deviceContext->DrawIndexed(command.IndexCount, 0, 0);
+            }
+            break;
+        }
+        }
+    }
+}
 
-    m_deviceContext->DrawIndexed(indexCount, 0, 0);
+void DX11Backend::SetPerDraw(const glm::mat4x4& objectToWorld)
+{
+    // NOTE(v.matushkin): The driver renames the buffer on every update, so each draw sees its own matrix
+    m_cbPerDrawData._ObjectToWorld = objectToWorld;
+    m_deviceContext->UpdateSubresource(m_cbPerDraw.Get(), 0, nullptr, &m_cbPerDrawData, 0, 0);
 }
 
 void DX11Backend::DrawArrays(i32 count)
@@ -177,6 +248,7 @@ void DX11Backend::DrawElements(i32 count)
 
 BufferHandle DX11Backend::CreateBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 )
@@ -190,30 +262,31 @@ BufferHandle DX11Backend::CreateBuffer(
         .SysMemSlicePitch = 0,
     };
     m_device->CreateBuffer(&d3dIndexBufferDesc, &d3dIndexSubresourceData, dx11Buffer.Index.GetAddressOf());
+    dx11Buffer.IndexFormat = indexFormat == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 
-    ID3D11Buffer** d3dBuffers[] = {
-        dx11Buffer.Position.GetAddressOf(),
-        dx11Buffer.Normal.GetAddressOf(),
-        dx11Buffer.TexCoord0.GetAddressOf(),
+    // NOTE(v.matushkin): One buffer for all the attributes, the layout tells where each one of them is
+    CD3D11_BUFFER_DESC     d3dVertexBufferDesc(vertexData.size_bytes(), D3D11_BIND_VERTEX_BUFFER);
+    D3D11_SUBRESOURCE_DATA d3dVertexSubresourceData = {
+        .pSysMem          = vertexData.data(),
+        .SysMemPitch      = 0,
+        .SysMemSlicePitch = 0,
     };
+    m_device->CreateBuffer(&d3dVertexBufferDesc, &d3dVertexSubresourceData, dx11Buffer.Vertex.GetAddressOf());
 
     for (ui32 i = 0; i < vertexLayout.size(); ++i)
     {
-        // TODO(v.matushkin): Adjust VertexAttributeDescriptor to remove this hacks
-        const auto& vertexAttribute = vertexLayout[i];
-        const auto  currOffset      = vertexAttribute.Offset;
-        const auto  nextOffset      = (i + 1) < vertexLayout.size() ? vertexLayout[i + 1].Offset : vertexData.size_bytes();
-        const auto  attributeSize   = (nextOffset - currOffset);
-
-        CD3D11_BUFFER_DESC     d3dAttributeBufferDesc(attributeSize, D3D11_BIND_VERTEX_BUFFER);
-        D3D11_SUBRESOURCE_DATA d3dAttributeSubresourceData = {
-            .pSysMem          = vertexData.data() + currOffset, // TODO(v.matushkin): Will this work?
-            .SysMemPitch      = 0,
-            .SysMemSlicePitch = 0,
-        };
-        // TODO(v.matushkin): Create mupltiple buffers in one call?
-        m_device->CreateBuffer(&d3dAttributeBufferDesc, &d3dAttributeSubresourceData, d3dBuffers[i]);
+        dx11Buffer.VertexOffsets[i] = vertexLayout[i].Offset;
+        dx11Buffer.VertexStrides[i] = vertexLayout[i].Stride;
+    }
+
+    if (m_inputLayout == nullptr)
+    {
+        CreateInputLayout(vertexLayout);
     }
+    SNV_ASSERT(
+        std::equal(vertexLayout.begin(), vertexLayout.end(), m_vertexLayout.begin(), m_vertexLayout.end(), IsSameVertexFormat),
+        "Every buffer must have the same vertex format, there is only one input layout"
+    );
 
     static ui32 buffer_handle_workaround = 0;
     auto        graphicsBufferHandle     = static_cast<BufferHandle>(buffer_handle_workaround++);
@@ -234,7 +307,7 @@ TextureHandle DX11Backend::CreateTexture(const TextureDesc& textureDesc, const u
     D3D11_TEXTURE2D_DESC1 d3dTextureDesc = {
         .Width          = textureDesc.Width, // TODO(v.matushkin): Make Width/Height ui32?
         .Height         = textureDesc.Height,
-        .MipLevels      = 1, // TODO(v.matushkin): No way to use texture without mip, 0 =  generate a full set of subtextures?
+        .MipLevels      = textureDesc.MipCount,
         .ArraySize      = 1,
         .Format         = dxgiTextureFormat,
         .SampleDesc     = dxgiSampleDesc,
@@ -244,16 +317,23 @@ TextureHandle DX11Backend::CreateTexture(const TextureDesc& textureDesc, const u
         .MiscFlags      = 0,                             // NOTE(v.matushkin): Whats this?
         .TextureLayout  = D3D11_TEXTURE_LAYOUT_UNDEFINED // Can use only UNDEFINED if CPUAccessFlags = 0
     };
-    D3D11_SUBRESOURCE_DATA d3dSubresourceData = {
-        .pSysMem          = textureData,
-        .SysMemPitch      = textureDesc.Width * 4, // TODO(v.matushkin): Remove hardcoded shit
-        .SysMemSlicePitch = 0,
-    };
-    m_device->CreateTexture2D1(&d3dTextureDesc, &d3dSubresourceData, dx11Texture.Texture.GetAddressOf());
+    const auto pixelSize = GetTextureFormatSize(textureDesc.Format);
+
+    std::vector<D3D11_SUBRESOURCE_DATA> d3dSubresourceData(textureDesc.MipCount);
+    for (ui32 mip = 0; mip < textureDesc.MipCount; ++mip)
+    {
+        d3dSubresourceData[mip] = {
+            .pSysMem          = textureData,
+            .SysMemPitch      = GetMipDimension(textureDesc.Width, mip) * pixelSize,
+            .SysMemSlicePitch = 0,
+        };
+        textureData += GetMipSize(textureDesc, mip);
+    }
+    m_device->CreateTexture2D1(&d3dTextureDesc, d3dSubresourceData.data(), dx11Texture.Texture.GetAddressOf());
 
     D3D11_TEX2D_SRV d3dSrvTex2D = {
         .MostDetailedMip = 0,
-        .MipLevels       = 1,
+        .MipLevels       = textureDesc.MipCount,
     };
     // TODO(v.matushkin): Don't know how to use ID3D11ShaderResourceView1
     //  if m_deviceContext->PSSetShaderResources takes only ID3D11ShaderResourceView
@@ -338,14 +418,8 @@ ShaderHandle DX11Backend::CreateShader(std::span<const char> vertexSource, std::
     const auto fragmentBufferSize = d3dFragmentBlob->GetBufferSize();
 
     DX11Shader dx11Shader;
+    dx11Shader.VertexBytecode.Attach(d3dVertexBlob);
 
-    m_device->CreateInputLayout(
-        k_InputElementDesc,
-        ARRAYSIZE(k_InputElementDesc),
-        vertexBuffer,
-        vertexBufferSize,
-        dx11Shader.InputLayout.GetAddressOf()
-    );
     m_device->CreateVertexShader(vertexBuffer, vertexBufferSize, nullptr, dx11Shader.VertexShader.GetAddressOf());
     m_device->CreatePixelShader(fragmentBuffer, fragmentBufferSize, nullptr, dx11Shader.FragmentShader.GetAddressOf());
 
@@ -357,6 +431,51 @@ ShaderHandle DX11Backend::CreateShader(std::span<const char> vertexSource, std::
     return shaderHandle;
 }
 
+bool DX11Backend::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    // TODO(v.matushkin): Shaders are bound directly, there is nothing to swap at a frame boundary yet
+    LOG_WARN("DX11Backend: shader hot reload is not supported");
+    return false;
+}
+
+
+void DX11Backend::CreateInputLayout(const std::vector<VertexAttributeDesc>& vertexLayout)
+{
+    // TODO(v.matushkin): Shouldn't get shader like this, tmp workaround
+    SNV_ASSERT(m_shaders.empty() == false, "Shader must be created before the first buffer");
+    const auto& shader = m_shaders.begin()->second;
+
+    D3D11_INPUT_ELEMENT_DESC d3dInputElementDescs[static_cast<ui8>(VertexAttribute::Count)];
+
+    for (ui32 i = 0; i < vertexLayout.size(); ++i)
+    {
+        const auto& vertexAttribute = vertexLayout[i];
+        const auto  dxgiFormatTable = vertexAttribute.Normalized ? dx11_VertexAttributeFormatNormalized : dx11_VertexAttributeFormat;
+        const auto  dxgiFormat      = dxgiFormatTable[static_cast<ui8>(vertexAttribute.Format)][vertexAttribute.Dimension - 1];
+        SNV_ASSERT(dxgiFormat != DXGI_FORMAT_UNKNOWN, "Unsupported vertex attribute format");
+
+        // NOTE(v.matushkin): Input slot per attribute, so AlignedByteOffset is always 0
+        d3dInputElementDescs[i] = D3D11_INPUT_ELEMENT_DESC{
+            .SemanticName         = dx11_VertexAttributeSemantic[static_cast<ui8>(vertexAttribute.Attribute)],
+            .SemanticIndex        = 0,
+            .Format               = dxgiFormat,
+            .InputSlot            = i,
+            .AlignedByteOffset    = 0,
+            .InputSlotClass       = D3D11_INPUT_PER_VERTEX_DATA,
+            .InstanceDataStepRate = 0,
+        };
+    }
+
+    m_device->CreateInputLayout(
+        d3dInputElementDescs,
+        static_cast<ui32>(vertexLayout.size()),
+        shader.VertexBytecode->GetBufferPointer(),
+        shader.VertexBytecode->GetBufferSize(),
+        m_inputLayout.GetAddressOf()
+    );
+    m_vertexLayout = vertexLayout;
+}
+
 
 void DX11Backend::CreateDevice()
 {
@@ -0,0 +1,96 @@
+#include <Engine/Renderer/DrawSorting.hpp>
+
+#include <Engine/Core/Assert.hpp>
+
+#include <bit>
+#include <utility>
+
+
+namespace
+{
+
+constexpr ui32 k_RadixBits   = 8;
+constexpr ui32 k_RadixSize   = 1 << k_RadixBits;
+constexpr ui32 k_RadixPasses = 64 / k_RadixBits;
+
+constexpr ui64 Mask(ui32 bits)
+{
+    return (ui64(1) << bits) - 1;
+}
+
+} // namespace
+
+
+namespace snv::DrawSorting
+{
+
+ui64 MakeSortKey(ShaderHandle pipeline, TextureHandle texture, BufferHandle buffer, f32 depth)
+{
+    // NOTE(v.matushkin): Bits of a positive float are ordered the same way as the float itself,
+    //  so the top bits of it are a logarithmic depth bucket for free
+    const auto depthBits   = depth > 0.0f ? std::bit_cast<ui32>(depth) : 0u;
+    const auto depthBucket = depthBits >> (32 - k_DepthBits);
+
+    ui64 key = static_cast<ui64>(pipeline) & Mask(k_PipelineBits);
+    key      = (key << k_TextureBits) | (static_cast<ui64>(texture) & Mask(k_TextureBits));
+    key      = (key << k_BufferBits)  | (static_cast<ui64>(buffer) & Mask(k_BufferBits));
+    key      = (key << k_DepthBits)   | depthBucket;
+
+    return key;
+}
+
+std::span<SortItem> RadixSort(std::span<SortItem> items, std::span<SortItem> scratch)
+{
+    SNV_ASSERT(scratch.size() == items.size(), "DrawSorting: scratch must be the same size as items");
+
+    const auto count = items.size();
+    if (count < 2)
+    {
+        return items;
+    }
+
+    //- Histograms of every pass in one go over the keys
+    ui32 histograms[k_RadixPasses][k_RadixSize] = {};
+    for (const auto& item : items)
+    {
+        for (ui32 pass = 0; pass < k_RadixPasses; ++pass)
+        {
+            histograms[pass][(item.Key >> (pass * k_RadixBits)) & (k_RadixSize - 1)]++;
+        }
+    }
+
+    auto source      = items;
+    auto destination = scratch;
+
+    for (ui32 pass = 0; pass < k_RadixPasses; ++pass)
+    {
+        auto&      histogram = histograms[pass];
+        const auto shift     = pass * k_RadixBits;
+
+        // NOTE(v.matushkin): All the keys have the same digit, the pass wouldn't move anything
+        if (histogram[(source[0].Key >> shift) & (k_RadixSize - 1)] == count)
+        {
+            continue;
+        }
+
+        //-- Exclusive prefix sum, histogram becomes the write offsets
+        ui32 offset = 0;
+        for (auto& digitCount : histogram)
+        {
+            const auto digitOffset = offset;
+            offset                += digitCount;
+            digitCount             = digitOffset;
+        }
+
+        for (const auto& item : source)
+        {
+            destination[histogram[(item.Key >> shift) & (k_RadixSize - 1)]++] = item;
+        }
+
+        std::swap(source, destination);
+    }
+
+    return source;
+}
+
+} // namespace snv::DrawSorting
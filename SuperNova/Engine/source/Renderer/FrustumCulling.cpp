@@ -0,0 +1,197 @@
+#include <Engine/Renderer/FrustumCulling.hpp>
+
+#include <Engine/Core/Assert.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SNV_CULLING_SSE
+    #include <emmintrin.h>
+#endif
+
+#include <bit>
+#include <cmath>
+
+
+namespace snv::FrustumCulling
+{
+
+void CullingBounds::Clear()
+{
+    m_count = 0;
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+}
+
+void CullingBounds::Add(const AABB& aabb, const glm::mat4x4& transform)
+{
+    // NOTE(v.matushkin): Grow by a whole SIMD register, so Cull() never has to handle the tail separately
+    if (m_count % k_SimdWidth == 0)
+    {
+        const auto paddedCount = m_count + k_SimdWidth;
+        m_centerX.resize(paddedCount, 0.0f);
+        m_centerY.resize(paddedCount, 0.0f);
+        m_centerZ.resize(paddedCount, 0.0f);
+        m_extentX.resize(paddedCount, 0.0f);
+        m_extentY.resize(paddedCount, 0.0f);
+        m_extentZ.resize(paddedCount, 0.0f);
+    }
+
+    const f32 center[3] = {
+        (aabb.Max.x + aabb.Min.x) * 0.5f,
+        (aabb.Max.y + aabb.Min.y) * 0.5f,
+        (aabb.Max.z + aabb.Min.z) * 0.5f,
+    };
+    const f32 extent[3] = {
+        (aabb.Max.x - aabb.Min.x) * 0.5f,
+        (aabb.Max.y - aabb.Min.y) * 0.5f,
+        (aabb.Max.z - aabb.Min.z) * 0.5f,
+    };
+
+    // NOTE(v.matushkin): Arvo's method, center is transformed as a point,
+    //  extents by the absolute values of the rotation/scale part
+    f32 transformedCenter[3];
+    f32 transformedExtent[3];
+    for (ui32 row = 0; row < 3; ++row)
+    {
+        transformedCenter[row] = transform[3][row];
+        transformedExtent[row] = 0.0f;
+        for (ui32 column = 0; column < 3; ++column)
+        {
+            transformedCenter[row] += transform[column][row] * center[column];
+            transformedExtent[row] += std::abs(transform[column][row]) * extent[column];
+        }
+    }
+
+    m_centerX[m_count] = transformedCenter[0];
+    m_centerY[m_count] = transformedCenter[1];
+    m_centerZ[m_count] = transformedCenter[2];
+    m_extentX[m_count] = transformedExtent[0];
+    m_extentY[m_count] = transformedExtent[1];
+    m_extentZ[m_count] = transformedExtent[2];
+
+    m_count++;
+}
+
+
+// NOTE(v.matushkin): Gribb/Hartmann plane extraction, row(i) + row(3) for the left/bottom/near planes
+//  and row(3) - row(i) for the right/top/far. The near plane is the one for [-1, 1] clip depth,
+//  with [0, 1] depth it's just slightly behind the real one, so the test stays conservative.
+Frustum ExtractFrustum(const glm::mat4x4& clipFromBounds)
+{
+    const auto& m = clipFromBounds;
+
+    Frustum frustum;
+    for (ui32 i = 0; i < 3; ++i)
+    {
+        const auto positivePlane = i * 2;
+        const auto negativePlane = i * 2 + 1;
+
+        frustum.PlaneX[positivePlane] = m[0][3] + m[0][i];
+        frustum.PlaneY[positivePlane] = m[1][3] + m[1][i];
+        frustum.PlaneZ[positivePlane] = m[2][3] + m[2][i];
+        frustum.PlaneW[positivePlane] = m[3][3] + m[3][i];
+
+        frustum.PlaneX[negativePlane] = m[0][3] - m[0][i];
+        frustum.PlaneY[negativePlane] = m[1][3] - m[1][i];
+        frustum.PlaneZ[negativePlane] = m[2][3] - m[2][i];
+        frustum.PlaneW[negativePlane] = m[3][3] - m[3][i];
+    }
+
+    return frustum;
+}
+
+// NOTE(v.matushkin): Box is outside if for any plane dot(n, center) + w < -dot(abs(n), extents)
+ui32 Cull(const Frustum& frustum, const CullingBounds& bounds, std::span<ui32> visibleIndices)
+{
+    const auto count = bounds.m_count;
+    SNV_ASSERT(visibleIndices.size() >= count, "FrustumCulling: visibleIndices can't fit all the bounds");
+
+    ui32 visibleCount = 0;
+
+#ifdef SNV_CULLING_SSE
+    // NOTE(v.matushkin): Splat the planes once, they are the same for every group of boxes
+    __m128 planeX[k_PlaneCount];
+    __m128 planeY[k_PlaneCount];
+    __m128 planeZ[k_PlaneCount];
+    __m128 planeW[k_PlaneCount];
+    __m128 planeAbsX[k_PlaneCount];
+    __m128 planeAbsY[k_PlaneCount];
+    __m128 planeAbsZ[k_PlaneCount];
+    for (ui32 plane = 0; plane < k_PlaneCount; ++plane)
+    {
+        planeX[plane]    = _mm_set1_ps(frustum.PlaneX[plane]);
+        planeY[plane]    = _mm_set1_ps(frustum.PlaneY[plane]);
+        planeZ[plane]    = _mm_set1_ps(frustum.PlaneZ[plane]);
+        planeW[plane]    = _mm_set1_ps(frustum.PlaneW[plane]);
+        planeAbsX[plane] = _mm_set1_ps(std::abs(frustum.PlaneX[plane]));
+        planeAbsY[plane] = _mm_set1_ps(std::abs(frustum.PlaneY[plane]));
+        planeAbsZ[plane] = _mm_set1_ps(std::abs(frustum.PlaneZ[plane]));
+    }
+#endif // SNV_CULLING_SSE
+
+    for (ui32 first = 0; first < count; first += k_SimdWidth)
+    {
+        const auto laneCount = count - first < k_SimdWidth ? count - first : k_SimdWidth;
+
+#ifdef SNV_CULLING_SSE
+        const __m128 centerX = _mm_loadu_ps(bounds.m_centerX.data() + first);
+        const __m128 centerY = _mm_loadu_ps(bounds.m_centerY.data() + first);
+        const __m128 centerZ = _mm_loadu_ps(bounds.m_centerZ.data() + first);
+        const __m128 extentX = _mm_loadu_ps(bounds.m_extentX.data() + first);
+        const __m128 extentY = _mm_loadu_ps(bounds.m_extentY.data() + first);
+        const __m128 extentZ = _mm_loadu_ps(bounds.m_extentZ.data() + first);
+
+        __m128 outside = _mm_setzero_ps();
+        for (ui32 plane = 0; plane < k_PlaneCount; ++plane)
+        {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(centerX, planeX[plane]), _mm_mul_ps(centerY, planeY[plane])),
+                _mm_add_ps(_mm_mul_ps(centerZ, planeZ[plane]), planeW[plane])
+            );
+            const __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(extentX, planeAbsX[plane]), _mm_mul_ps(extentY, planeAbsY[plane])),
+                _mm_mul_ps(extentZ, planeAbsZ[plane])
+            );
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        ui32 visibleMask = ~static_cast<ui32>(_mm_movemask_ps(outside)) & ((1u << laneCount) - 1);
+        while (visibleMask != 0)
+        {
+            visibleIndices[visibleCount++] = first + std::countr_zero(visibleMask);
+            visibleMask &= visibleMask - 1;
+        }
+#else
+        for (ui32 lane = 0; lane < laneCount; ++lane)
+        {
+            const auto index = first + lane;
+
+            bool isOutside = false;
+            for (ui32 plane = 0; plane < k_PlaneCount; ++plane)
+            {
+                const auto distance = bounds.m_centerX[index] * frustum.PlaneX[plane]
+                                    + bounds.m_centerY[index] * frustum.PlaneY[plane]
+                                    + bounds.m_centerZ[index] * frustum.PlaneZ[plane]
+                                    + frustum.PlaneW[plane];
+                const auto radius   = bounds.m_extentX[index] * std::abs(frustum.PlaneX[plane])
+                                    + bounds.m_extentY[index] * std::abs(frustum.PlaneY[plane])
+                                    + bounds.m_extentZ[index] * std::abs(frustum.PlaneZ[plane]);
+                isOutside |= distance + radius < 0.0f;
+            }
+
+            if (isOutside == false)
+            {
+                visibleIndices[visibleCount++] = index;
+            }
+        }
+#endif // SNV_CULLING_SSE
+    }
+
+    return visibleCount;
+}
+
+} // namespace snv::FrustumCulling
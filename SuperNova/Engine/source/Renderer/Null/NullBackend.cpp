@@ -0,0 +1,203 @@
+#include <Engine/Renderer/Null/NullBackend.hpp>
+
+#include <Engine/Core/Log.hpp>
+#include <Engine/Core/Profiler.hpp>
+
+
+namespace snv
+{
+
+NullBackend::NullBackend()
+    : m_counters{}
+{
+    LOG_INFO("NullBackend Init, nothing will be rendered");
+}
+
+NullBackend::~NullBackend()
+{
+    LOG_INFO(
+        "NullBackend Shutdown\n"
+        "\tFrames: {}\n"
+        "\tSubmit calls: {} ({} commands)\n"
+        "\tDrawIndexed commands: {}\n"
+        "\tDrawIndexedInstanced commands: {} ({} instances)\n"
+        "\tBuffers: {} ({} bytes)\n"
+        "\tTextures: {} ({} bytes)\n"
+        "\tShaders: {}",
+        m_counters.EndFrame,
+        m_counters.Submit, m_counters.SubmittedCommands,
+        m_counters.DrawIndexed,
+        m_counters.DrawIndexedInstanced, m_counters.Instances,
+        m_counters.CreateBuffer, m_counters.BufferBytes,
+        m_counters.CreateTexture, m_counters.TextureBytes,
+        m_counters.CreateShader
+    );
+}
+
+
+void NullBackend::EnableBlend()
+{}
+
+void NullBackend::EnableDepthTest()
+{}
+
+void NullBackend::SetBlendFunction(BlendFactor source, BlendFactor destination)
+{}
+
+void NullBackend::SetClearColor(f32 r, f32 g, f32 b, f32 a)
+{}
+
+void NullBackend::SetDepthFunction(DepthFunction depthFunction)
+{}
+
+void NullBackend::SetViewport(i32 x, i32 y, i32 width, i32 height)
+{}
+
+
+void NullBackend::Clear(BufferBit bufferBitMask)
+{
+    m_counters.Clear++;
+    m_commandList.push_back({.Type = CommandType::Clear});
+}
+
+
+void NullBackend::BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
+{
+    PROFILE_ZONE("NullBackend::BeginFrame");
+
+    m_cameraView       = cameraView;
+    m_cameraProjection = cameraProjection;
+
+    m_counters.BeginFrame++;
+    // NOTE(v.matushkin): clear() keeps the capacity, so after the first frame there are no allocations
+    m_commandList.clear();
+    m_commandList.push_back({.Type = CommandType::BeginFrame});
+}
+
+void NullBackend::EndFrame()
+{
+    PROFILE_ZONE("NullBackend::EndFrame");
+
+    m_counters.EndFrame++;
+    m_commandList.push_back({.Type = CommandType::EndFrame});
+}
+
+void NullBackend::Submit(const RenderCommandStream& commandStream)
+{
+    PROFILE_ZONE("NullBackend::Submit");
+
+    m_counters.Submit++;
+    m_counters.SubmittedCommands += commandStream.GetCommandCount();
+
+    auto        texture       = TextureHandle::InvalidHandle;
+    auto        buffer        = BufferHandle::InvalidHandle;
+    glm::mat4x4 objectToWorld = glm::mat4x4(1.0f);
+
+    for (RenderCommandReader reader(commandStream); reader.IsEnd() == false;)
+    {
+        switch (reader.GetType())
+        {
+        case RenderCommandType::BindBuffer:
+            buffer = reader.Read<BindBufferCommand>().Buffer;
+            break;
+        case RenderCommandType::BindTexture:
+            texture = reader.Read<BindTextureCommand>().Texture;
+            break;
+        case RenderCommandType::SetObjectToWorld:
+            objectToWorld = reader.Read<SetObjectToWorldCommand>().ObjectToWorld;
+            break;
+        case RenderCommandType::DrawIndexed:
+            m_counters.DrawIndexed++;
+            m_commandList.push_back({
+                .Type          = CommandType::DrawIndexed,
+                .Texture       = texture,
+                .Buffer        = buffer,
+                .IndexCount    = reader.Read<DrawIndexedCommand>().IndexCount,
+                .InstanceCount = 1,
+                .ObjectToWorld = objectToWorld,
+            });
+            break;
+        case RenderCommandType::DrawIndexedInstanced:
+        {
+            const auto& command = reader.Read<DrawIndexedInstancedCommand>();
+
+            m_counters.DrawIndexedInstanced++;
+            m_counters.Instances += command.InstanceCount;
+            m_commandList.push_back({
+                .Type          = CommandType::DrawIndexedInstanced,
+                .Texture       = texture,
+                .Buffer        = buffer,
+                .IndexCount    = command.IndexCount,
+                .InstanceCount = command.InstanceCount,
+                .ObjectToWorld = commandStream.GetInstanceData()[command.FirstInstance],
+            });
+            break;
+        }
+        }
+    }
+}
+
+void NullBackend::DrawArrays(i32 count)
+{
+    m_counters.DrawArrays++;
+    m_commandList.push_back({.Type = CommandType::DrawArrays, .VertexCount = count});
+}
+
+void NullBackend::DrawElements(i32 count)
+{
+    m_counters.DrawElements++;
+    m_commandList.push_back({.Type = CommandType::DrawElements, .IndexCount = count});
+}
+
+
+BufferHandle NullBackend::CreateBuffer(
+    std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
+    std::span<const std::byte>              vertexData,
+    const std::vector<VertexAttributeDesc>& vertexLayout
+)
+{
+    NullBuffer nullBuffer = {
+        .IndexSize            = indexData.size_bytes(),
+        .IndexDataFormat      = indexFormat,
+        .VertexSize           = vertexData.size_bytes(),
+        .VertexAttributeCount = static_cast<ui32>(vertexLayout.size()),
+    };
+
+    m_counters.BufferBytes += nullBuffer.IndexSize + nullBuffer.VertexSize;
+    const auto bufferHandle = static_cast<BufferHandle>(m_counters.CreateBuffer++);
+
+    m_buffers[bufferHandle] = nullBuffer;
+
+    return bufferHandle;
+}
+
+TextureHandle NullBackend::CreateTexture(const TextureDesc& textureDesc, const ui8* textureData)
+{
+    m_counters.TextureBytes += GetTextureSize(textureDesc);
+    const auto textureHandle = static_cast<TextureHandle>(m_counters.CreateTexture++);
+
+    m_textures[textureHandle] = NullTexture{.Desc = textureDesc};
+
+    return textureHandle;
+}
+
+ShaderHandle NullBackend::CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    const auto shaderHandle = static_cast<ShaderHandle>(m_counters.CreateShader++);
+
+    m_shaders[shaderHandle] = NullShader{
+        .VertexSourceSize   = vertexSource.size_bytes(),
+        .FragmentSourceSize = fragmentSource.size_bytes(),
+    };
+
+    return shaderHandle;
+}
+
+bool NullBackend::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    // NOTE(v.matushkin): Called on the shader watcher thread, so it doesn't touch m_shaders/m_counters
+    return true;
+}
+
+} // namespace snv
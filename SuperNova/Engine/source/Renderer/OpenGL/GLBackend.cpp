@@ -2,6 +2,7 @@
 
 #include <Engine/Application/Window.hpp>
 #include <Engine/Core/Log.hpp>
+#include <Engine/Core/Profiler.hpp>
 
 #include <glad/glad.h>
 
@@ -33,6 +34,18 @@ constexpr ui32 gl_BufferBit[] = {
     GL_STENCIL_BUFFER_BIT // BufferBit::Stencil
 };
 
+// NOTE(v.matushkin): Passes measured by the GLGpuProfiler
+namespace GpuPass
+{
+    const ui32 Clear = 0;
+    const ui32 Draws = 1;
+} // namespace GpuPass
+
+const char* const gl_GpuPassNames[] = {
+    "Clear", // GpuPass::Clear
+    "Draws", // GpuPass::Draws
+};
+
 
 #ifdef SNV_ENABLE_DEBUG
 void APIENTRY openGLMessageCallback(
@@ -102,6 +115,7 @@ void APIENTRY openGLMessageCallback(
 
 
 GLBackend::GLBackend()
+    : m_gpuProfiler(gl_GpuPassNames)
 {
     LOG_INFO(
         "OpengGL Info\n"
@@ -128,6 +142,13 @@ GLBackend::GLBackend()
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
+
+    glCreateBuffers(1, &m_instanceBuffer);
+}
+
+GLBackend::~GLBackend()
+{
+    glDeleteBuffers(1, &m_instanceBuffer);
 }
 
 
@@ -187,37 +208,113 @@ void GLBackend::Clear(BufferBit bufferBitMask)
 }
 
 
-void GLBackend::BeginFrame(const glm::mat4x4& localToWorld, const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
+void GLBackend::BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
 {
+    PROFILE_ZONE("GLBackend::BeginFrame");
+
+    m_gpuProfiler.BeginFrame();
+
     // NOTE(v.matushkin): Don't need to clear stencil rn, just to test that is working
     const auto cleaFlags = snv::BufferBit::Color | snv::BufferBit::Depth | snv::BufferBit::Stencil;
+    m_gpuProfiler.BeginPass(GpuPass::Clear);
     Clear(static_cast<snv::BufferBit>(cleaFlags));
+    m_gpuProfiler.EndPass();
+
+    ApplyShaderReloads();
 
     // TODO(v.matushkin): Shouldn't get shader like this, tmp workaround
     // const auto& shader = m_shaders[shaderHandle];
     const auto& shader = m_shaders.begin()->second;
     shader.SetInt1("_DiffuseTexture", 0);
-    shader.SetMatrix4("_ObjectToWorld", localToWorld);
     shader.SetMatrix4("_MatrixV", cameraView);
     shader.SetMatrix4("_MatrixP", cameraProjection);
+    shader.SetInt1("_FirstInstance", -1);
     shader.Bind();
 }
 
 void GLBackend::EndFrame()
 {
+    PROFILE_ZONE("GLBackend::EndFrame");
+
+    m_gpuProfiler.EndFrame();
+
     // TODO(v.matushkin): Workaround, GLBackend should manage its context, but it's not worthy rn
     Window::SwapBuffers();
 }
 
-void GLBackend::DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount)
+void GLBackend::Submit(const RenderCommandStream& commandStream)
 {
-    const auto& texture        = m_textures[textureHandle];
-    const auto& graphicsBuffer = m_buffers[bufferHandle];
+    PROFILE_ZONE("GLBackend::Submit");
+
+    // TODO(v.matushkin): Shouldn't get shader like this, tmp workaround
+    const auto& shader = m_shaders.begin()->second;
 
-    texture.Bind(0);
-    graphicsBuffer.Bind();
+    m_gpuProfiler.BeginPass(GpuPass::Draws);
 
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    // NOTE(v.matushkin): Orphan the buffer every frame, so it doesn't wait for the previous frame draws
+    const auto instanceData = commandStream.GetInstanceData();
+    if (instanceData.empty() == false)
+    {
+        glNamedBufferData(m_instanceBuffer, instanceData.size_bytes(), instanceData.data(), GL_STREAM_DRAW);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_instanceBuffer);
+    }
+
+    const GLBuffer* graphicsBuffer = nullptr;
+    // NOTE(v.matushkin): -1 means the shader uses _ObjectToWorld, otherwise the instance buffer
+    i32             firstInstance  = -1;
+
+    for (RenderCommandReader reader(commandStream); reader.IsEnd() == false;)
+    {
+        switch (reader.GetType())
+        {
+        case RenderCommandType::BindBuffer:
+        {
+            const auto& command = reader.Read<BindBufferCommand>();
+            graphicsBuffer      = &m_buffers[command.Buffer];
+            graphicsBuffer->Bind();
+            break;
+        }
+        case RenderCommandType::BindTexture:
+        {
+            const auto& command = reader.Read<BindTextureCommand>();
+            m_textures[command.Texture].Bind(0);
+            break;
+        }
+        case RenderCommandType::SetObjectToWorld:
+        {
+            const auto& command = reader.Read<SetObjectToWorldCommand>();
+            shader.SetMatrix4("_ObjectToWorld", command.ObjectToWorld);
+            break;
+        }
+        case RenderCommandType::DrawIndexed:
+        {
+            const auto& command = reader.Read<DrawIndexedCommand>();
+            if (firstInstance != -1)
+            {
+                firstInstance = -1;
+                shader.SetInt1("_FirstInstance", firstInstance);
+            }
+            glDrawElements(GL_TRIANGLES, command.IndexCount, graphicsBuffer->GetIndexType(), 0);
+            break;
+        }
+        case RenderCommandType::DrawIndexedInstanced:
+        {
+            const auto& command = reader.Read<DrawIndexedInstancedCommand>();
+            firstInstance       = static_cast<i32>(command.FirstInstance);
+            shader.SetInt1("_FirstInstance", firstInstance);
+            glDrawElementsInstanced(
+                GL_TRIANGLES,
+                command.IndexCount,
+                graphicsBuffer->GetIndexType(),
+                0,
+                static_cast<i32>(command.InstanceCount)
+            );
+            break;
+        }
+        }
+    }
+
+    m_gpuProfiler.EndPass();
 }
 
 void GLBackend::DrawArrays(i32 count)
@@ -234,11 +331,12 @@ void GLBackend::DrawElements(i32 count)
 
 BufferHandle GLBackend::CreateBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 )
 {
-    GLBuffer   glBuffer(indexData, vertexData, vertexLayout);
+    GLBuffer   glBuffer(indexData, indexFormat, vertexData, vertexLayout);
     const auto handle = glBuffer.GetHandle();
     m_buffers.emplace(handle, std::move(glBuffer));
 
@@ -263,4 +361,46 @@ ShaderHandle GLBackend::CreateShader(std::span<const char> vertexSource, std::sp
     return handle;
 }
 
+bool GLBackend::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    std::lock_guard lock(m_shaderReloadMutex);
+    m_pendingShaderReloads.push_back(PendingShaderReload{
+        .Handle         = shaderHandle,
+        .VertexSource   = std::string(vertexSource.data(), vertexSource.size()),
+        .FragmentSource = std::string(fragmentSource.data(), fragmentSource.size()),
+    });
+
+    return true;
+}
+
+
+void GLBackend::ApplyShaderReloads()
+{
+    std::vector<PendingShaderReload> shaderReloads;
+    {
+        std::lock_guard lock(m_shaderReloadMutex);
+        shaderReloads.swap(m_pendingShaderReloads);
+    }
+
+    for (const auto& shaderReload : shaderReloads)
+    {
+        const auto shaderIt = m_shaders.find(shaderReload.Handle);
+        if (shaderIt == m_shaders.end())
+        {
+            continue;
+        }
+
+        GLShader glShader(shaderReload.VertexSource, shaderReload.FragmentSource);
+        if (glShader.IsLinked() == false)
+        {
+            LOG_ERROR("GLBackend: failed to reload shader {}, the old one is kept", static_cast<ui32>(shaderReload.Handle));
+            continue;
+        }
+
+        // NOTE(v.matushkin): The map key stays the same, ShaderHandle given out by CreateShader() must remain valid
+        shaderIt->second = std::move(glShader);
+        LOG_INFO("GLBackend: shader {} reloaded", static_cast<ui32>(shaderReload.Handle));
+    }
+}
+
 } // namespace snv
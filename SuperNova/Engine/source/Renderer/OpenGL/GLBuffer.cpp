@@ -31,13 +31,16 @@ GLBuffer::GLBuffer() noexcept
     : m_vao(k_InvalidHandle)
     , m_vbo(-1)
     , m_ibo(-1)
+    , m_indexType(GL_UNSIGNED_INT)
 {}
 
 GLBuffer::GLBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 ) noexcept
+    : m_indexType(indexFormat == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT)
 {
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
@@ -54,10 +57,18 @@ GLBuffer::GLBuffer(
     for (const auto& vertexAttribute : vertexLayout)
     {
         const auto attribute = static_cast<ui8>(vertexAttribute.Attribute);
-        const auto format    = gl_VertexAttributeFormat[static_cast<ui8>(vertexAttribute.Format)];
-        
+        const auto format     = gl_VertexAttributeFormat[static_cast<ui8>(vertexAttribute.Format)];
+        const auto normalized = vertexAttribute.Normalized ? GL_TRUE : GL_FALSE;
+
         glEnableVertexAttribArray(attribute);
-        glVertexAttribPointer(attribute, vertexAttribute.Dimension, format, GL_FALSE, 0, UINT_TO_VOID_PTR(vertexAttribute.Offset));
+        glVertexAttribPointer(
+            attribute,
+            vertexAttribute.Dimension,
+            format,
+            normalized,
+            vertexAttribute.Stride,
+            UINT_TO_VOID_PTR(vertexAttribute.Offset)
+        );
     }
 }
 
@@ -66,14 +77,16 @@ GLBuffer::GLBuffer(GLBuffer&& other) noexcept
     : m_vao(std::exchange(other.m_vao, -1))
     , m_vbo(std::exchange(other.m_vbo, -1))
     , m_ibo(std::exchange(other.m_ibo, -1))
+    , m_indexType(other.m_indexType)
 {}
 
 GLBuffer& GLBuffer::operator=(GLBuffer&& other) noexcept
 {
     // NOTE(v.matushkin): Not sure if this is correct
-    m_vao = std::exchange(other.m_vao, -1);
-    m_vbo = std::exchange(other.m_vbo, -1);
-    m_ibo = std::exchange(other.m_ibo, -1);
+    m_vao       = std::exchange(other.m_vao, -1);
+    m_vbo       = std::exchange(other.m_vbo, -1);
+    m_ibo       = std::exchange(other.m_ibo, -1);
+    m_indexType = other.m_indexType;
 
     return *this;
 }
@@ -0,0 +1,129 @@
+#include <Engine/Renderer/OpenGL/GLGpuProfiler.hpp>
+
+#include <Engine/Core/Assert.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+
+constexpr ui32 gl_PipelineStatisticTarget[] = {
+    GL_VERTEX_SHADER_INVOCATIONS,   // PipelineStatistic::VertexInvocations
+    GL_FRAGMENT_SHADER_INVOCATIONS, // PipelineStatistic::FragmentInvocations
+};
+
+
+namespace snv
+{
+
+GLGpuProfiler::GLGpuProfiler(std::span<const char* const> passNames)
+    : m_passCount(static_cast<ui32>(passNames.size()))
+    , m_currentFrame(0)
+    , m_frameStats()
+{
+    SNV_ASSERT(passNames.size() <= k_MaxGpuPasses, "GLGpuProfiler: too many passes, increase k_MaxGpuPasses");
+
+    std::copy(passNames.begin(), passNames.end(), m_passNames);
+    std::fill_n(m_isFrameRecorded, k_QueryFrames, false);
+
+    for (ui32 i = 0; i < k_QueryFrames; ++i)
+    {
+        glCreateQueries(GL_TIME_ELAPSED, m_passCount, m_passQueries[i]);
+        for (ui32 j = 0; j < PipelineStatistic::Count; ++j)
+        {
+            glCreateQueries(gl_PipelineStatisticTarget[j], 1, &m_statisticQueries[i][j]);
+        }
+    }
+}
+
+GLGpuProfiler::~GLGpuProfiler()
+{
+    for (ui32 i = 0; i < k_QueryFrames; ++i)
+    {
+        glDeleteQueries(m_passCount, m_passQueries[i]);
+        glDeleteQueries(PipelineStatistic::Count, m_statisticQueries[i]);
+    }
+}
+
+
+void GLGpuProfiler::BeginFrame()
+{
+    m_currentFrame = (m_currentFrame + 1) % k_QueryFrames;
+
+    if (m_isFrameRecorded[m_currentFrame])
+    {
+        ReadFrameQueries(m_currentFrame);
+    }
+
+    m_isFrameRecorded[m_currentFrame] = true;
+    std::fill_n(m_isPassRecorded[m_currentFrame], k_MaxGpuPasses, false);
+
+    for (ui32 i = 0; i < PipelineStatistic::Count; ++i)
+    {
+        glBeginQuery(gl_PipelineStatisticTarget[i], m_statisticQueries[m_currentFrame][i]);
+    }
+}
+
+void GLGpuProfiler::EndFrame()
+{
+    for (ui32 i = 0; i < PipelineStatistic::Count; ++i)
+    {
+        glEndQuery(gl_PipelineStatisticTarget[i]);
+    }
+}
+
+
+void GLGpuProfiler::BeginPass(ui32 passIndex)
+{
+    m_isPassRecorded[m_currentFrame][passIndex] = true;
+    glBeginQuery(GL_TIME_ELAPSED, m_passQueries[m_currentFrame][passIndex]);
+}
+
+void GLGpuProfiler::EndPass()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+
+void GLGpuProfiler::ReadFrameQueries(ui32 frameIndex)
+{
+    // NOTE(v.matushkin): Every query of the frame is ended before the statistic ones,
+    //  if those are available the whole frame is
+    for (const auto statisticQuery : m_statisticQueries[frameIndex])
+    {
+        i32 isAvailable = GL_FALSE;
+        glGetQueryObjectiv(statisticQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_FALSE)
+        {
+            return;
+        }
+    }
+
+    GpuFrameStats frameStats = {};
+
+    for (ui32 i = 0; i < m_passCount; ++i)
+    {
+        if (m_isPassRecorded[frameIndex][i] == false)
+        {
+            continue;
+        }
+
+        ui64 elapsedNanoseconds;
+        glGetQueryObjectui64v(m_passQueries[frameIndex][i], GL_QUERY_RESULT, &elapsedNanoseconds);
+
+        const auto milliseconds = static_cast<f32>(static_cast<f64>(elapsedNanoseconds) / 1'000'000.0);
+
+        frameStats.FrameMilliseconds             += milliseconds;
+        frameStats.Passes[frameStats.PassCount++] = GpuPassStats{
+            .Name         = m_passNames[i],
+            .Milliseconds = milliseconds,
+        };
+    }
+
+    glGetQueryObjectui64v(m_statisticQueries[frameIndex][PipelineStatistic::VertexInvocations], GL_QUERY_RESULT, &frameStats.VertexInvocations);
+    glGetQueryObjectui64v(m_statisticQueries[frameIndex][PipelineStatistic::FragmentInvocations], GL_QUERY_RESULT, &frameStats.FragmentInvocations);
+
+    m_frameStats = frameStats;
+}
+
+} // namespace snv
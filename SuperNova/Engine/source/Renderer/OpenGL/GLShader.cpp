@@ -35,18 +35,38 @@ GLShader::GLShader(std::span<const char> vertexSource, std::span<const char> fra
     glDeleteShader(fragmentShaderID);
 }
 
+GLShader::~GLShader()
+{
+    if (m_shaderProgramID != k_InvalidHandle)
+    {
+        glDeleteProgram(m_shaderProgramID);
+    }
+}
+
 GLShader::GLShader(GLShader&& other) noexcept
     : m_shaderProgramID(std::exchange(other.m_shaderProgramID, k_InvalidHandle))
 {}
 
 GLShader& GLShader::operator=(GLShader&& other) noexcept
 {
+    if (m_shaderProgramID != k_InvalidHandle)
+    {
+        glDeleteProgram(m_shaderProgramID);
+    }
     m_shaderProgramID = std::exchange(other.m_shaderProgramID, k_InvalidHandle);
 
     return *this;
 }
 
 
+bool GLShader::IsLinked() const
+{
+    i32 isLinked;
+    glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &isLinked);
+
+    return isLinked == GL_TRUE;
+}
+
 void GLShader::Bind() const
 {
     glUseProgram(m_shaderProgramID);
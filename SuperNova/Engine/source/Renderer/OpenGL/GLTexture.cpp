@@ -50,11 +50,20 @@ GLTexture::GLTexture(const TextureDesc& textureDesc, const ui8* textureData)
     glTextureParameteri(m_textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTextureParameteri(m_textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    const auto width  = textureDesc.Width;
-    const auto height = textureDesc.Height;
+    const auto mipCount = textureDesc.MipCount;
     const auto [glInternalFormat, glFormat, glType] = gl_TextureFormat[static_cast<ui8>(textureDesc.Format)];
-    glTextureStorage2D(m_textureID, 1, glInternalFormat, width, height);
-    glTextureSubImage2D(m_textureID, 0, 0, 0, width, height, glFormat, glType, textureData);
+    glTextureStorage2D(m_textureID, mipCount, glInternalFormat, textureDesc.Width, textureDesc.Height);
+
+    // NOTE(v.matushkin): Mips are tightly packed, default GL_UNPACK_ALIGNMENT(4) breaks small R8/RG8/R16 mips
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (ui32 mip = 0; mip < mipCount; ++mip)
+    {
+        const auto mipWidth  = GetMipDimension(textureDesc.Width, mip);
+        const auto mipHeight = GetMipDimension(textureDesc.Height, mip);
+        glTextureSubImage2D(m_textureID, mip, 0, 0, mipWidth, mipHeight, glFormat, glType, textureData);
+        textureData += GetMipSize(textureDesc, mip);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
 GLTexture::GLTexture(GLTexture&& other) noexcept
@@ -1,6 +1,9 @@
 #include <Engine/Renderer/Renderer.hpp>
 
+#include <Engine/Renderer/DrawSorting.hpp>
+#include <Engine/Renderer/FrustumCulling.hpp>
 #include <Engine/Renderer/IRendererBackend.hpp>
+#include <Engine/Renderer/Null/NullBackend.hpp>
 #include <Engine/Renderer/OpenGL/GLBackend.hpp>
 #include <Engine/Renderer/Vulkan/VulkanBackend.hpp>
 #ifdef SNV_PLATFORM_WINDOWS
@@ -9,9 +12,13 @@
 #endif
 
 #include <Engine/Core/Assert.hpp>
+#include <Engine/Core/FrameAllocator.hpp>
+#include <Engine/Core/MemoryTracker.hpp>
+#include <Engine/Core/Profiler.hpp>
 
 #include <Engine/Assets/Material.hpp>
 #include <Engine/Assets/Mesh.hpp>
+#include <Engine/Assets/Shader.hpp>
 #include <Engine/Assets/Texture.hpp>
 
 #include <Engine/Components/ComponentFactory.hpp>
@@ -19,19 +26,48 @@
 #include <Engine/Components/MeshRenderer.hpp>
 #include <Engine/Components/Transform.hpp>
 
+#include <glm/geometric.hpp>
+#include <glm/ext/vector_float4.hpp>
+
+
+// NOTE(v.matushkin): Per frame in flight, grows by itself if a frame needs more
+constexpr size_t k_FrameArenaCapacity = 1024 * 1024;
+
 
 namespace snv
 {
 
-void Renderer::Init(GraphicsApi graphicsApi)
+struct DrawCandidate
 {
+    ShaderHandle  Pipeline;
+    TextureHandle Texture;
+    BufferHandle  Buffer;
+    i32           IndexCount;
+    glm::vec3     BoundsCenter; // NOTE(v.matushkin): World space
+    glm::mat4x4   ObjectToWorld;
+};
+
+
+// NOTE(v.matushkin): Reused so they don't allocate every frame. The rest of the culling/sorting data
+//  is in the FrameAllocator
+static FrustumCulling::CullingBounds g_CullingBounds;
+static RenderCommandStream           g_CommandStream;
+
+
+void Renderer::Init(GraphicsApi graphicsApi, const SwapchainDesc& swapchainDesc)
+{
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
     switch (graphicsApi)
     {
     case GraphicsApi::OpenGL:
         s_rendererBackend = new GLBackend();
         break;
     case GraphicsApi::Vulkan:
-        s_rendererBackend = new VulkanBackend();
+        s_rendererBackend = new VulkanBackend(swapchainDesc);
+        break;
+    case GraphicsApi::Null:
+        s_rendererBackend = new NullBackend();
         break;
 #ifdef SNV_PLATFORM_WINDOWS
     case GraphicsApi::DirectX11:
@@ -47,11 +83,15 @@ void Renderer::Init(GraphicsApi graphicsApi)
     }
 
     s_graphicsApi = graphicsApi;
+
+    FrameAllocator::Init(s_rendererBackend->GetFramesInFlight(), k_FrameArenaCapacity);
 }
 
 void Renderer::Shutdown()
 {
     delete s_rendererBackend;
+
+    FrameAllocator::Shutdown();
 }
 
 
@@ -92,13 +132,22 @@ void Renderer::Clear(BufferBit bufferBitMask)
 }
 
 
-// TODO(v.matushkin): Each mesh should use its own Transform, but since I dont have Tranform hierarchy
-//   use global localToWorld
+// TODO(v.matushkin): There is no Transform hierarchy yet, so localToWorld is used as a parent of every MeshRenderer
 void Renderer::RenderFrame(const glm::mat4x4& localToWorld)
 {
+    PROFILE_ZONE("Renderer::RenderFrame");
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
+    // NOTE(v.matushkin): A steady state frame shouldn't allocate, the scratch containers and the frame arenas
+    //  only grow when the scene does
+    const HeapAllocationGuard heapAllocationGuard;
+
+    //- Frame memory of this frame in flight is free once the GPU is done with it
+    FrameAllocator::BeginFrame(s_rendererBackend->WaitForFrameInFlight());
+
     const auto cameraView = ComponentFactory::GetView<const Camera>();
     SNV_ASSERT(cameraView.size() == 1, "The scene must have at least and only 1 camera");
-    const auto meshRendererView = ComponentFactory::GetView<const MeshRenderer>();
+    const auto meshRendererView = ComponentFactory::GetView<const MeshRenderer, const Transform>();
 
     for (const auto [entity, camera] : cameraView.each())
     {
@@ -106,43 +155,173 @@ void Renderer::RenderFrame(const glm::mat4x4& localToWorld)
         const auto& cameraTranformForReal = ComponentFactory::GetComponent<Transform>(entity);
         //const auto& cameraTransform = cameraView.get<Transform>(entity);
 
-        s_rendererBackend->BeginFrame(localToWorld, cameraTranformForReal.GetMatrix(), camera.GetProjectionMatrix());
+        const auto& cameraMatrix = cameraTranformForReal.GetMatrix();
+        const auto& projection   = camera.GetProjectionMatrix();
 
-        for (const auto [entity, meshRenderer] : meshRendererView.each())
+        //- Culling
+        // NOTE(v.matushkin): Bounds are moved into the world space, so the frustum is the same for every mesh
+        g_CullingBounds.Clear();
+        ArenaVector<DrawCandidate> drawCandidates(FrameAllocator::GetArena());
+        drawCandidates.reserve(meshRendererView.size_hint());
+        for (const auto [entity, meshRenderer, transform] : meshRendererView.each())
         {
-            const auto material      = meshRenderer.GetMaterial();
-            const auto textureHandle = material->GetBaseColorMap()->GetTextureHandle();
+            const auto  objectToWorld = localToWorld * transform.GetMatrix();
+            const auto& material      = meshRenderer.GetMaterial();
+            const auto& mesh          = meshRenderer.GetMesh();
+            const auto& bounds        = mesh->GetBounds();
+
+            g_CullingBounds.Add(bounds, objectToWorld);
+            drawCandidates.push_back({
+                .Pipeline      = material->GetShader()->GetHandle(),
+                .Texture       = material->GetBaseColorMap()->GetTextureHandle(),
+                .Buffer        = mesh->GetHandle(),
+                .IndexCount    = mesh->GetIndexCount(),
+                .BoundsCenter  = glm::vec3(objectToWorld * glm::vec4((bounds.Min + bounds.Max) * 0.5f, 1.0f)),
+                .ObjectToWorld = objectToWorld,
+            });
+        }
+
+        const auto clipFromWorld     = projection * cameraMatrix;
+        const auto frustum           = FrustumCulling::ExtractFrustum(clipFromWorld);
+        const auto visibleCandidates = FrameAllocator::AllocateArray<ui32>(g_CullingBounds.GetCount());
+        const auto visibleCount      = FrustumCulling::Cull(frustum, g_CullingBounds, visibleCandidates);
 
-            const auto mesh        = meshRenderer.GetMesh();
-            const auto meshHandle  = mesh->GetHandle();
-            const auto indexCount  = mesh->GetIndexCount();
-            const auto vertexCount = mesh->GetVertexCount();
+        //- Sorting
+        // NOTE(v.matushkin): Clip space w is the view depth for a perspective projection, whatever the handedness
+        const glm::vec4 clipW = {clipFromWorld[0][3], clipFromWorld[1][3], clipFromWorld[2][3], clipFromWorld[3][3]};
 
-            s_rendererBackend->DrawBuffer(textureHandle, meshHandle, indexCount, vertexCount);
+        const auto unsortedItems = FrameAllocator::AllocateArray<DrawSorting::SortItem>(visibleCount);
+        for (ui32 i = 0; i < visibleCount; ++i)
+        {
+            const auto  candidateIndex = visibleCandidates[i];
+            const auto& drawCandidate  = drawCandidates[candidateIndex];
+            const auto  depth          = glm::dot(clipW, glm::vec4(drawCandidate.BoundsCenter, 1.0f));
+
+            unsortedItems[i] = {
+                .Key   = DrawSorting::MakeSortKey(drawCandidate.Pipeline, drawCandidate.Texture, drawCandidate.Buffer, depth),
+                .Index = candidateIndex,
+            };
         }
+        const auto sortScratch = FrameAllocator::AllocateArray<DrawSorting::SortItem>(visibleCount);
+        const auto sortItems   = DrawSorting::RadixSort(unsortedItems, sortScratch);
+
+        //- Recording
+        s_frameStats = {
+            .CulledObjects = g_CullingBounds.GetCount() - visibleCount,
+        };
 
+        // NOTE(v.matushkin): Binds only go into the stream when the state changes, a changed pipeline/texture/buffer
+        //  is one state change each. There is only one pipeline in the backends, so it's not a command yet.
+        auto boundPipeline = ShaderHandle::InvalidHandle;
+        auto boundTexture  = TextureHandle::InvalidHandle;
+        auto boundBuffer   = BufferHandle::InvalidHandle;
+
+        g_CommandStream.Clear();
+        const auto sortItemCount = static_cast<ui32>(sortItems.size());
+        for (ui32 runBegin = 0; runBegin < sortItemCount;)
+        {
+            const auto& drawCandidate = drawCandidates[sortItems[runBegin].Index];
+
+            // NOTE(v.matushkin): Draws of the same mesh with the same material are next to each other after sorting,
+            //  depth is the lowest part of the key. A run of them is one instanced draw.
+            auto runEnd = runBegin + 1;
+            for (; runEnd < sortItemCount; ++runEnd)
+            {
+                const auto& nextCandidate = drawCandidates[sortItems[runEnd].Index];
+                if (nextCandidate.Pipeline != drawCandidate.Pipeline
+                    || nextCandidate.Texture != drawCandidate.Texture
+                    || nextCandidate.Buffer != drawCandidate.Buffer)
+                {
+                    break;
+                }
+            }
+            const auto instanceCount = runEnd - runBegin;
+
+            if (drawCandidate.Pipeline != boundPipeline)
+            {
+                boundPipeline = drawCandidate.Pipeline;
+                s_frameStats.StateChanges++;
+            }
+            if (drawCandidate.Texture != boundTexture)
+            {
+                boundTexture = drawCandidate.Texture;
+                g_CommandStream.BindTexture(boundTexture);
+                s_frameStats.StateChanges++;
+            }
+            if (drawCandidate.Buffer != boundBuffer)
+            {
+                boundBuffer = drawCandidate.Buffer;
+                g_CommandStream.BindBuffer(boundBuffer);
+                s_frameStats.StateChanges++;
+            }
+
+            if (instanceCount == 1)
+            {
+                g_CommandStream.SetObjectToWorld(drawCandidate.ObjectToWorld);
+                g_CommandStream.DrawIndexed(drawCandidate.IndexCount);
+            }
+            else
+            {
+                auto instances = g_CommandStream.DrawIndexedInstanced(drawCandidate.IndexCount, instanceCount);
+                for (ui32 i = 0; i < instanceCount; ++i)
+                {
+                    instances[i] = drawCandidates[sortItems[runBegin + i].Index].ObjectToWorld;
+                }
+                s_frameStats.InstancedObjects += instanceCount;
+            }
+
+            s_frameStats.DrawCalls++;
+            s_frameStats.Triangles += static_cast<ui64>(drawCandidate.IndexCount / 3) * instanceCount;
+
+            runBegin = runEnd;
+        }
+
+        //- Submission
+        s_rendererBackend->BeginFrame(cameraMatrix, projection);
+        s_rendererBackend->Submit(g_CommandStream);
         s_rendererBackend->EndFrame();
     }
+
+    s_frameStats.HeapAllocations = static_cast<ui32>(heapAllocationGuard.GetAllocationCount());
+}
+
+GpuFrameStats Renderer::GetGpuFrameStats()
+{
+    return s_rendererBackend->GetGpuFrameStats();
 }
 
 
 BufferHandle Renderer::CreateBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 )
 {
-    return s_rendererBackend->CreateBuffer(indexData, vertexData, vertexLayout);
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
+    return s_rendererBackend->CreateBuffer(indexData, indexFormat, vertexData, vertexLayout);
 }
 
 TextureHandle Renderer::CreateTexture(const TextureDesc& textureDesc, const ui8* textureData)
 {
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
     return s_rendererBackend->CreateTexture(textureDesc, textureData);
 }
 
 ShaderHandle Renderer::CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource)
 {
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
     return s_rendererBackend->CreateShader(vertexSource, fragmentSource);
 }
 
+bool Renderer::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    MEMORY_TAG_SCOPE(MemoryTag::Renderer);
+
+    return s_rendererBackend->ReloadShader(shaderHandle, vertexSource, fragmentSource);
+}
+
 } // namespace snv
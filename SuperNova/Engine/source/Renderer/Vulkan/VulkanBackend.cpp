@@ -1,6 +1,11 @@
 #include <Engine/Renderer/Vulkan/VulkanBackend.hpp>
 #include <Engine/Core/Assert.hpp>
+#include <Engine/Core/JobSystem.hpp>
+#include <Engine/Core/Log.hpp>
+#include <Engine/Core/Profiler.hpp>
 #include <Engine/Renderer/Vulkan/VulkanShaderCompiler.hpp>
+#include <Engine/Utils/Hash.hpp>
+#include <Engine/Utils/MappedFile.hpp>
 
 #ifdef SNV_PLATFORM_WINDOWS
     #define NOMINMAX
@@ -13,6 +18,10 @@
     #include <Engine/Application/Window.hpp>
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <limits>
 
 // TODO(v.matushkin):
@@ -30,9 +39,11 @@
 //     Mismatch between DX12 and VK Backends, vulkan says that RGBA8888_UNORM is unsupported on my PC,
 //       which means that setting DXGI_FORMAT_R8G8B8A8_UNORM in DX backend is wrong, but then, it would be reported as error, no?
 //     - https://medium.com/@heypete/hello-triangle-meet-swift-and-wide-color-6f9e246616d9
-//   - <ImageCount>
 //   - <ImageExtent>
 //
+// - <SwapchainRecreation>
+//   Out of date/suboptimal swapchain is only logged, it should be recreated with oldSwapchain
+//
 // - <SupportChecks>
 //   - validation layers
 //   - instance extensions
@@ -58,8 +69,6 @@
 //   - Should I use 'alignas(256)' ?
 //   - Query minUniformBufferOffsetAlignment with VkPhysicalDeviceProperties to align individual uniform buffer members?
 //     GLM_FORCE_DEFAULT_ALIGNED_GENTYPES ?
-//   - Place all UniformBuffers in one VkDeviceMemory?
-//   - Always mapped?
 //   [LINKS]
 //     - https://developer.nvidia.com/vulkan-shader-resource-binding
 //     - Not sure how relevant this is http://kylehalladay.com/blog/tutorial/vulkan/2017/08/13/Vulkan-Uniform-Buffers.html
@@ -73,7 +82,8 @@
 //   should be?
 //
 // - <BufferAndImageCreation>
-//   - There is a lot of code repetition in creating VkBuffer/VkImage and allocating memory for them
+//   - There is a lot of code repetition in creating VkBuffer/VkImage
+//   - Memory goes through VulkanMemoryAllocator, should it handle dedicated allocations for render targets?
 //   - There is even more code repetition in CreateMesh/CreateTexture
 //   - There is a code repetition in FindImageMemoryTypeIndex and FindBufferMemoryTypeIndex
 //
@@ -105,30 +115,95 @@ const VkFormat vk_TextureFormat[] = {
     VK_FORMAT_D32_SFLOAT
 };
 
+// NOTE(v.matushkin): [VertexAttributeFormat][Dimension - 1], UNDEFINED for the combinations that don't exist
+const VkFormat vk_VertexAttributeFormat[][4] = {
+    {VK_FORMAT_R8_SINT,     VK_FORMAT_R8G8_SINT,     VK_FORMAT_R8G8B8_SINT,        VK_FORMAT_R8G8B8A8_SINT},         // Int8
+    {VK_FORMAT_R16_SINT,    VK_FORMAT_R16G16_SINT,   VK_FORMAT_R16G16B16_SINT,     VK_FORMAT_R16G16B16A16_SINT},     // Int16
+    {VK_FORMAT_R32_SINT,    VK_FORMAT_R32G32_SINT,   VK_FORMAT_R32G32B32_SINT,     VK_FORMAT_R32G32B32A32_SINT},     // Int32
+    {VK_FORMAT_R8_UINT,     VK_FORMAT_R8G8_UINT,     VK_FORMAT_R8G8B8_UINT,        VK_FORMAT_R8G8B8A8_UINT},         // UInt8
+    {VK_FORMAT_R16_UINT,    VK_FORMAT_R16G16_UINT,   VK_FORMAT_R16G16B16_UINT,     VK_FORMAT_R16G16B16A16_UINT},     // UInt16
+    {VK_FORMAT_R32_UINT,    VK_FORMAT_R32G32_UINT,   VK_FORMAT_R32G32B32_UINT,     VK_FORMAT_R32G32B32A32_UINT},     // UInt32
+    {VK_FORMAT_R16_SFLOAT,  VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT,   VK_FORMAT_R16G16B16A16_SFLOAT},   // Float16
+    {VK_FORMAT_R32_SFLOAT,  VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT,   VK_FORMAT_R32G32B32A32_SFLOAT},   // Float32
+    {VK_FORMAT_R64_SFLOAT,  VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT,   VK_FORMAT_R64G64B64A64_SFLOAT},   // Float64
+};
+const VkFormat vk_VertexAttributeFormatNormalized[][4] = {
+    {VK_FORMAT_R8_SNORM,    VK_FORMAT_R8G8_SNORM,    VK_FORMAT_R8G8B8_SNORM,       VK_FORMAT_R8G8B8A8_SNORM},        // Int8
+    {VK_FORMAT_R16_SNORM,   VK_FORMAT_R16G16_SNORM,  VK_FORMAT_R16G16B16_SNORM,    VK_FORMAT_R16G16B16A16_SNORM},    // Int16
+    {VK_FORMAT_UNDEFINED,   VK_FORMAT_UNDEFINED,     VK_FORMAT_UNDEFINED,          VK_FORMAT_UNDEFINED},             // Int32
+    {VK_FORMAT_R8_UNORM,    VK_FORMAT_R8G8_UNORM,    VK_FORMAT_R8G8B8_UNORM,       VK_FORMAT_R8G8B8A8_UNORM},        // UInt8
+    {VK_FORMAT_R16_UNORM,   VK_FORMAT_R16G16_UNORM,  VK_FORMAT_R16G16B16_UNORM,    VK_FORMAT_R16G16B16A16_UNORM},    // UInt16
+    {VK_FORMAT_UNDEFINED,   VK_FORMAT_UNDEFINED,     VK_FORMAT_UNDEFINED,          VK_FORMAT_UNDEFINED},             // UInt32
+    {VK_FORMAT_UNDEFINED,   VK_FORMAT_UNDEFINED,     VK_FORMAT_UNDEFINED,          VK_FORMAT_UNDEFINED},             // Float16
+    {VK_FORMAT_UNDEFINED,   VK_FORMAT_UNDEFINED,     VK_FORMAT_UNDEFINED,          VK_FORMAT_UNDEFINED},             // Float32
+    {VK_FORMAT_UNDEFINED,   VK_FORMAT_UNDEFINED,     VK_FORMAT_UNDEFINED,          VK_FORMAT_UNDEFINED},             // Float64
+};
+
 namespace ShaderSet
 {
     const ui32 Camera   = 0;
-    const ui32 Material = 1;
+    const ui32 Textures = 1;
 }
 namespace ShaderBinding
 {
     //- Set 0
-    const ui32 ubPerFrame    = 0;
-    const ui32 ubPerDraw     = 1;
-    const ui32 sSampler      = 2;
+    const ui32 ubPerFrame = 0;
+    const ui32 sbPerDraw  = 1;
+    const ui32 sSampler   = 2;
     //- Set 1
-    const ui32 tBaseColorMap = 0;
+    const ui32 tTextures  = 0;
 } // namespace ShaderBinding
+// NOTE(v.matushkin): Passes measured by the VulkanGpuProfiler
+namespace GpuPass
+{
+    const ui32 GeometryArena = 0;
+    const ui32 DirectDraws   = 1; // NOTE(v.matushkin): Begins in the first chunk, ends in the last one
+} // namespace GpuPass
+
+const VkBlendFactor vk_BlendFactor[] = {
+    VK_BLEND_FACTOR_ONE,                 // BlendFactor::One
+    VK_BLEND_FACTOR_SRC_ALPHA,           // BlendFactor::SrcAlpha
+    VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, // BlendFactor::OneMinusSrcAlpha
+};
+
+const VkCompareOp vk_CompareOp[] = {
+    VK_COMPARE_OP_NEVER,            // DepthFunction::Never
+    VK_COMPARE_OP_LESS,             // DepthFunction::Less
+    VK_COMPARE_OP_EQUAL,            // DepthFunction::Equal
+    VK_COMPARE_OP_LESS_OR_EQUAL,    // DepthFunction::LessOrEqual
+    VK_COMPARE_OP_GREATER,          // DepthFunction::Greater
+    VK_COMPARE_OP_NOT_EQUAL,        // DepthFunction::NotEqual
+    VK_COMPARE_OP_GREATER_OR_EQUAL, // DepthFunction::GreaterOrEqual
+    VK_COMPARE_OP_ALWAYS,           // DepthFunction::Always
+};
+
+const VkPresentModeKHR vk_PresentMode[] = {
+    VK_PRESENT_MODE_FIFO_KHR,      // PresentMode::Fifo
+    VK_PRESENT_MODE_MAILBOX_KHR,   // PresentMode::Mailbox
+    VK_PRESENT_MODE_IMMEDIATE_KHR, // PresentMode::Immediate
+};
+
+// NOTE(v.matushkin): Indexed by the index type group of the geometry arena indirect commands
+const VkIndexType vk_GeometryArenaIndexTypes[] = {
+    VK_INDEX_TYPE_UINT16,
+    VK_INDEX_TYPE_UINT32,
+};
+
+const char* const vk_GpuPassNames[] = {
+    "GeometryArena", // GpuPass::GeometryArena
+    "DirectDraws",   // GpuPass::DirectDraws
+};
 
 const VkFormat k_SwapchainFormat    = VK_FORMAT_B8G8R8A8_UNORM;
 const VkFormat k_DepthStencilFormat = VK_FORMAT_D32_SFLOAT;
 const f32      k_DepthClearValue    = 1.0f;
 
-// NOTE(v.mnatushkin): 0.04s, this will break for FPS <30, I'm sure I'm doing this acquire/present thing wrong
-const ui64 k_Timeout = 40'000'000;
+// NOTE(v.matushkin): A frame wait is not given up on, it's only reported every k_FrameWaitTimeout nanoseconds (1s)
+const ui64 k_FrameWaitTimeout = 1'000'000'000;
 
-// TODO(v.matushkin): <RenderGraph>
-static bool g_IsPipelineInitialized = false;
+// NOTE(v.matushkin): Relative to the working directory, the data is only valid for the same driver and GPU,
+//  so it doesn't belong to the asset cache
+const char* k_PipelineCachePath = "vk_pipeline_cache.bin";
 
 
 // NOTE(v.matushkin): The are other validation layers
@@ -232,12 +307,30 @@ static VKAPI_ATTR void VKAPI_CALL vkDestroyDebugUtilsMessengerEXT(
 namespace snv
 {
 
-VulkanBackend::VulkanBackend()
-    : m_currentFrame(0)
+VulkanBackend::VulkanBackend(const SwapchainDesc& swapchainDesc)
+    : m_frameSerial(0)
+    , m_framesInFlight(std::clamp(swapchainDesc.FramesInFlight, 1u, k_MaxFramesInFlight))
+    , m_currentFrame(0)
+    , m_pipelineState{
+        .VertexLayoutHash       = 0,
+        .Shader                 = ShaderHandle::InvalidHandle,
+        .SourceBlendFactor      = BlendFactor::One,
+        .DestinationBlendFactor = BlendFactor::One,
+        .DepthCompare           = DepthFunction::Less,
+        .BlendEnable            = false,
+        .DepthTestEnable        = true,
+        ._Padding               = {},
+    }
+    , m_reloadPipelineState()
 {
     m_clearValues[0].color        = {.float32 = {1.0f, 0.0f, 0.0f, 0.0f}};
     m_clearValues[1].depthStencil = {.depth = k_DepthClearValue, .stencil = 0};
 
+    if (m_framesInFlight != swapchainDesc.FramesInFlight)
+    {
+        LOG_WARN("VulkanBackend: {} frames in flight is not supported, using {}", swapchainDesc.FramesInFlight, m_framesInFlight);
+    }
+
     VulkanShaderCompiler::Init();
 
     CreateInstance();
@@ -246,21 +339,43 @@ VulkanBackend::VulkanBackend()
 #endif
     CreateSurface();
     CreateDevice();
-    CreateSwapchain();
+    FindMemoryTypeIndices();
+    m_memoryAllocator.Init(m_physiacalDevice, m_device);
+    CreateSwapchain(swapchainDesc.PreferredPresentMode);
     CreateDepthBuffer();
     CreateRenderPass();
     CreateFramebuffers();
 
     CreateCommandPool();
     CreateCommandBuffers();
-    FindMemoryTypeIndices();
+    CreateSecondaryCommandBuffers();
     CreateSyncronizationObjects();
+    m_uploadQueue.Init(
+        m_device,
+        m_graphicsQueue,
+        m_graphicsQueueFamily,
+        &m_memoryAllocator,
+        m_bufferMemoryTypeIndex.CPUtoGPU
+    );
+    m_gpuProfiler.Init(
+        m_physiacalDevice,
+        m_device,
+        m_graphicsQueueFamily,
+        m_framesInFlight,
+        m_isPipelineStatisticsEnabled,
+        vk_GpuPassNames
+    );
 
     CreateUniformBuffers();
+    CreateIndirectBuffers();
+    CreateGeometryArena();
     CreateTextureSampler();
     CreateDescriptorPool();
     CreateDescriptorSetLayouts();
     CreateDescriptorSets();
+
+    CreatePipelineLayout();
+    CreatePipelineCache();
 }
 
 VulkanBackend::~VulkanBackend()
@@ -269,30 +384,45 @@ VulkanBackend::~VulkanBackend()
 
     vkQueueWaitIdle(m_graphicsQueue);
 
+    m_uploadQueue.Shutdown();
+    m_gpuProfiler.Shutdown();
+
     //- Resources
     //-- Uniform Buffers
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
-        vkDestroyBuffer(m_device, m_ubPerDraw[i], nullptr);
+        vkDestroyBuffer(m_device, m_sbPerDraw[i], nullptr);
         vkDestroyBuffer(m_device, m_ubPerFrame[i], nullptr);
 
-        vkFreeMemory(m_device, m_ubPerDrawMemory[i], nullptr);
-        vkFreeMemory(m_device, m_ubPerFrameMemory[i], nullptr);
+        m_memoryAllocator.Free(m_sbPerDrawMemory[i]);
+        m_memoryAllocator.Free(m_ubPerFrameMemory[i]);
+    }
+    //-- Indirect Buffers
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
+    {
+        vkDestroyBuffer(m_device, m_indirectBuffers[i], nullptr);
+        m_memoryAllocator.Free(m_indirectBufferMemory[i]);
     }
     //-- Meshes
+    vkDestroyBuffer(m_device, m_geometryArena.Index, nullptr);
+    vkDestroyBuffer(m_device, m_geometryArena.Vertex, nullptr);
+
+    m_memoryAllocator.Free(m_geometryArena.IndexMemory);
+    m_memoryAllocator.Free(m_geometryArena.VertexMemory);
+
     for (auto& handleAndBuffer : m_buffers)
     {
         auto& buffer = handleAndBuffer.second;
+        if (buffer.InGeometryArena)
+        {
+            continue;
+        }
 
         vkDestroyBuffer(m_device, buffer.Index, nullptr);
-        vkDestroyBuffer(m_device, buffer.Position, nullptr);
-        vkDestroyBuffer(m_device, buffer.Normal, nullptr);
-        vkDestroyBuffer(m_device, buffer.TexCoord0, nullptr);
+        vkDestroyBuffer(m_device, buffer.Vertex, nullptr);
 
-        vkFreeMemory(m_device, buffer.IndexMemory, nullptr);
-        vkFreeMemory(m_device, buffer.PositionMemory, nullptr);
-        vkFreeMemory(m_device, buffer.NormalMemory, nullptr);
-        vkFreeMemory(m_device, buffer.TexCoord0Memory, nullptr);
+        m_memoryAllocator.Free(buffer.IndexMemory);
+        m_memoryAllocator.Free(buffer.VertexMemory);
     }
     //-- Textures
     vkDestroySampler(m_device, m_sampler, nullptr);
@@ -303,7 +433,7 @@ VulkanBackend::~VulkanBackend()
 
         vkDestroyImageView(m_device, texture.View, nullptr);
         vkDestroyImage(m_device, texture.Image, nullptr);
-        vkFreeMemory(m_device, texture.Memory, nullptr);
+        m_memoryAllocator.Free(texture.Memory);
     }
     //-- Shaders
     // NOTE(v.matushkin): Delete them afetr pipeline creation?
@@ -314,25 +444,47 @@ VulkanBackend::~VulkanBackend()
         vkDestroyShaderModule(m_device, shader.Vertex, nullptr);
         vkDestroyShaderModule(m_device, shader.Fragment, nullptr);
     }
+    // NOTE(v.matushkin): The shader watcher is stopped by now, nothing can be pushed anymore
+    for (auto& shaderReload : m_pendingShaderReloads)
+    {
+        vkDestroyPipeline(m_device, shaderReload.Pipeline, nullptr);
+        vkDestroyShaderModule(m_device, shaderReload.Shader.Vertex, nullptr);
+        vkDestroyShaderModule(m_device, shaderReload.Shader.Fragment, nullptr);
+    }
+    DestroyRetiredShaders(true);
 
     //- Descriptors
     vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
     vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayoutCamera, nullptr);
-    vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayourMaterial, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayoutTextures, nullptr);
 
     //- Syncronization Objects
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
         vkDestroySemaphore(m_device, m_semaphoreImageAvailable[i], nullptr);
+    }
+    for (ui32 i = 0; i < m_swapchainImageCount; ++i)
+    {
         vkDestroySemaphore(m_device, m_semaphoreRenderFinished[i], nullptr);
-
-        vkDestroyFence(m_device, m_fences[i], nullptr);
     }
+    vkDestroySemaphore(m_device, m_frameTimeline, nullptr);
 
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
+    {
+        for (auto commandPool : m_secondaryCommandPools[i])
+        {
+            vkDestroyCommandPool(m_device, commandPool, nullptr);
+        }
+    }
 
     //- Graphics Pipeline
-    vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
+    for (auto& stateAndPipeline : m_pipelines)
+    {
+        vkDestroyPipeline(m_device, stateAndPipeline.second, nullptr);
+    }
+    SavePipelineCache();
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
     vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
     vkDestroyRenderPass(m_device, m_renderPass, nullptr);
 
@@ -340,15 +492,17 @@ VulkanBackend::~VulkanBackend()
     //-- Depth
     vkDestroyImageView(m_device, m_depthImageView, nullptr);
     vkDestroyImage(m_device, m_depthImage, nullptr);
-    vkFreeMemory(m_device, m_depthImageMemory, nullptr);
+    m_memoryAllocator.Free(m_depthImageMemory);
     //-- Color
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_swapchainImageCount; ++i)
     {
         vkDestroyFramebuffer(m_device, m_framebuffers[i], nullptr);
         vkDestroyImageView(m_device, m_backBuffers[i], nullptr);
     }
     vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
 
+    m_memoryAllocator.Shutdown();
+
     vkDestroyDevice(m_device, nullptr);
     vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
 #ifdef SNV_GPU_API_DEBUG_ENABLED
@@ -359,13 +513,20 @@ VulkanBackend::~VulkanBackend()
 
 
 void VulkanBackend::EnableBlend()
-{}
+{
+    m_pipelineState.BlendEnable = true;
+}
 
 void VulkanBackend::EnableDepthTest()
-{}
+{
+    m_pipelineState.DepthTestEnable = true;
+}
 
 void VulkanBackend::SetBlendFunction(BlendFactor source, BlendFactor destination)
-{}
+{
+    m_pipelineState.SourceBlendFactor      = source;
+    m_pipelineState.DestinationBlendFactor = destination;
+}
 
 void VulkanBackend::SetClearColor(f32 r, f32 g, f32 b, f32 a)
 {
@@ -373,7 +534,9 @@ void VulkanBackend::SetClearColor(f32 r, f32 g, f32 b, f32 a)
 }
 
 void VulkanBackend::SetDepthFunction(DepthFunction depthFunction)
-{}
+{
+    m_pipelineState.DepthCompare = depthFunction;
+}
 
 void VulkanBackend::SetViewport(i32 x, i32 y, i32 width, i32 height)
 {}
@@ -383,25 +546,45 @@ void VulkanBackend::Clear(BufferBit bufferBitMask)
 {}
 
 
-void VulkanBackend::BeginFrame(
-    const glm::mat4x4& localToWorld,
-    const glm::mat4x4& cameraView,
-    const glm::mat4x4& cameraProjection
-)
+ui32 VulkanBackend::WaitForFrameInFlight()
+{
+    WaitForFrame(m_frameSerials[m_currentFrame]);
+    return m_currentFrame;
+}
+
+
+void VulkanBackend::BeginFrame(const glm::mat4x4& cameraView, const glm::mat4x4& cameraProjection)
 {
-    // TODO(v.matushkin): <RenderGraph>
-    if (g_IsPipelineInitialized == false)
+    PROFILE_ZONE("VulkanBackend::BeginFrame");
+
+    ApplyShaderReloads();
+
+    // TODO(v.matushkin): <RenderGraph> There is still one shader for everything, Submit() doesn't switch pipelines
+    m_graphicsPipeline = GetOrCreatePipeline(m_shaders.begin()->first);
+
+    //- Wait until the GPU is done with the last frame that used the resources of this frame in flight
+    // NOTE(v.matushkin): The Renderer has already waited in WaitForFrameInFlight(), the serial is reached, so it returns right away
+    WaitForFrame(m_frameSerials[m_currentFrame]);
+
+    // NOTE(v.matushkin): The semaphore was waited by the submit of that frame, so it's free to be signaled again
+    auto       semaphoreImageAvailable = m_semaphoreImageAvailable[m_currentFrame];
+    const auto vkAcquireResult         = vkAcquireNextImageKHR(
+        m_device,
+        m_swapchain,
+        std::numeric_limits<ui64>::max(),
+        semaphoreImageAvailable,
+        VK_NULL_HANDLE,
+        &m_currentBackBufferIndex
+    );
+    // TODO(v.matushkin): <SwapchainRecreation> VK_ERROR_OUT_OF_DATE_KHR should recreate the swapchain
+    if (vkAcquireResult != VK_SUCCESS && vkAcquireResult != VK_SUBOPTIMAL_KHR)
     {
-        g_IsPipelineInitialized = true;
-        CreatePipeline();
+        LOG_ERROR("VulkanBackend: vkAcquireNextImageKHR failed, VkResult: {}", static_cast<i32>(vkAcquireResult));
     }
 
-    auto semaphoreImageAvailable = m_semaphoreImageAvailable[m_currentFrame];
-    vkAcquireNextImageKHR(m_device, m_swapchain, k_Timeout, semaphoreImageAvailable, nullptr, &m_currentBackBufferIndex);
-
-    auto fence = m_fences[m_currentBackBufferIndex];
-    vkWaitForFences(m_device, 1, &fence, true, k_Timeout);
-    vkResetFences(m_device, 1, &fence);
+    //- Kick off the uploads recorded since the last frame and find out which ones are done
+    m_uploadQueue.Submit();
+    m_uploadQueue.Retire();
 
     // NOTE(v.matushkin): VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT ?
     VkCommandBufferBeginInfo vkCommandBufferBegin = {
@@ -425,73 +608,73 @@ void VulkanBackend::BeginFrame(
     };
 
     // NOTE(v.matushkin): Just make a m_currentCommandBuffer member?
-    auto commandBuffer = m_commandBuffers[m_currentBackBufferIndex];
+    auto commandBuffer = m_commandBuffers[m_currentFrame];
     vkResetCommandBuffer(commandBuffer, 0);
     vkBeginCommandBuffer(commandBuffer, &vkCommandBufferBegin);
+    // NOTE(v.matushkin): The wait above made the queries of this frame in flight readable
+    m_gpuProfiler.BeginFrame(commandBuffer, m_currentFrame);
     // NOTE(v.matushkin): vkCmdBeginRenderPass2 ?
-    vkCmdBeginRenderPass(commandBuffer, &vkRenderPassBegin, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+    // NOTE(v.matushkin): Draws are recorded into secondary command buffers in Submit(), the pipeline is bound there,
+    //  the primary can only execute them inside of this render pass
+    vkCmdBeginRenderPass(commandBuffer, &vkRenderPassBegin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
     //- Update Uniform Buffers
     {
-        void* data;
         //-- PerFrame
         PerFrame ubPerFrame = {
             ._CameraView       = cameraView,
             ._CameraProjection = cameraProjection,
         };
-        auto ubPerFrameMemory = m_ubPerFrameMemory[m_currentBackBufferIndex];
-
-        vkMapMemory(m_device, ubPerFrameMemory, 0, sizeof(PerFrame), 0, &data);
-        std::memcpy(data, &ubPerFrame, sizeof(PerFrame));
-        vkUnmapMemory(m_device, ubPerFrameMemory);
+        std::memcpy(m_ubPerFrameMemory[m_currentFrame].MappedData, &ubPerFrame, sizeof(PerFrame));
 
         //-- PerDraw
-        PerDraw ubPerDraw = {
-            ._ObjectToWorld = localToWorld
-        };
-        auto ubPerDrawMemory = m_ubPerDrawMemory[m_currentBackBufferIndex];
-
-        vkMapMemory(m_device, ubPerDrawMemory, 0, sizeof(PerDraw), 0, &data);
-        std::memcpy(data, &ubPerDraw, sizeof(PerDraw));
-        vkUnmapMemory(m_device, ubPerDrawMemory);
+        // NOTE(v.matushkin): Written in Submit, one for every draw, the wait above guarantees
+        //  that the GPU is done with this buffer and with the indirect buffer
+        m_perDrawCount = 0;
     }
-
-    vkCmdBindDescriptorSets(
-        commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        m_pipelineLayout,
-        ShaderSet::Camera,
-        1,
-        &m_descriptorSets[m_currentBackBufferIndex],
-        0,
-        nullptr
-    );
 }
 
 void VulkanBackend::EndFrame()
 {
-    auto commandBuffer = m_commandBuffers[m_currentBackBufferIndex];
+    PROFILE_ZONE("VulkanBackend::EndFrame");
+
+    auto commandBuffer = m_commandBuffers[m_currentFrame];
     vkCmdEndRenderPass(commandBuffer);
+    m_gpuProfiler.EndFrame(commandBuffer);
     vkEndCommandBuffer(commandBuffer);
 
+    m_frameSerial++;
+    m_frameSerials[m_currentFrame] = m_frameSerial;
+
     auto semaphoreImageAvailable = m_semaphoreImageAvailable[m_currentFrame];
-    auto semaphoreRenderFinished = m_semaphoreRenderFinished[m_currentFrame];
+    auto semaphoreRenderFinished = m_semaphoreRenderFinished[m_currentBackBufferIndex];
 
     const VkPipelineStageFlags vkPipelineStageFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    // NOTE(v.matushkin): The value of the binary semaphore is ignored
+    const VkSemaphore vkSignalSemaphores[]      = {semaphoreRenderFinished, m_frameTimeline};
+    const ui64        vkSignalSemaphoreValues[] = {0, m_frameSerial};
+
+    VkTimelineSemaphoreSubmitInfo vkTimelineSubmitInfo = {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = nullptr,
+        .waitSemaphoreValueCount   = 0,
+        .pWaitSemaphoreValues      = nullptr,
+        .signalSemaphoreValueCount = ARRAYSIZE(vkSignalSemaphoreValues),
+        .pSignalSemaphoreValues    = vkSignalSemaphoreValues,
+    };
     // NOTE(v.matushkin): VkSubmitInfo2KHR ?
     VkSubmitInfo vkSubmitInfo = {
         .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext                = nullptr,
+        .pNext                = &vkTimelineSubmitInfo,
         .waitSemaphoreCount   = 1,
         .pWaitSemaphores      = &semaphoreImageAvailable,
         .pWaitDstStageMask    = &vkPipelineStageFlags,
         .commandBufferCount   = 1,
-        .pCommandBuffers      = &m_commandBuffers[m_currentBackBufferIndex],
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores    = &m_semaphoreRenderFinished[m_currentFrame],
+        .pCommandBuffers      = &commandBuffer,
+        .signalSemaphoreCount = ARRAYSIZE(vkSignalSemaphores),
+        .pSignalSemaphores    = vkSignalSemaphores,
     };
-    vkQueueSubmit(m_graphicsQueue, 1, &vkSubmitInfo, m_fences[m_currentBackBufferIndex]);
+    vkQueueSubmit(m_graphicsQueue, 1, &vkSubmitInfo, VK_NULL_HANDLE);
 
     VkPresentInfoKHR vkPresentInfo = {
         .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -503,37 +686,264 @@ void VulkanBackend::EndFrame()
         .pImageIndices      = &m_currentBackBufferIndex,
         .pResults           = nullptr,
     };
-    vkQueuePresentKHR(m_graphicsQueue, &vkPresentInfo);
+    const auto vkPresentResult = vkQueuePresentKHR(m_graphicsQueue, &vkPresentInfo);
+    // TODO(v.matushkin): <SwapchainRecreation>
+    if (vkPresentResult != VK_SUCCESS && vkPresentResult != VK_SUBOPTIMAL_KHR)
+    {
+        LOG_ERROR("VulkanBackend: vkQueuePresentKHR failed, VkResult: {}", static_cast<i32>(vkPresentResult));
+    }
 
-    m_currentFrame = (m_currentFrame + 1) % k_BackBufferFrames;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
 }
 
-void VulkanBackend::DrawBuffer(TextureHandle textureHandle, BufferHandle bufferHandle, i32 indexCount, i32 vertexCount)
+void VulkanBackend::Submit(const RenderCommandStream& commandStream)
 {
-    auto commandBuffer = m_commandBuffers[m_currentBackBufferIndex];
-
-    //- Set Index/Vertex buffers
-    const auto& buffer = m_buffers[bufferHandle];
-    VkBuffer     vkVertexBuffers[] = {buffer.Position, buffer.Normal, buffer.TexCoord0};
-    VkDeviceSize vkOffsets[]       = {0, 0, 0};
-    // TODO(v.matushkin): Vertex type shouldn't be hardcoded
-    vkCmdBindIndexBuffer(commandBuffer, buffer.Index, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindVertexBuffers(commandBuffer, 0, 3, vkVertexBuffers, vkOffsets);
-    
-    //- Set Material Texture
-    const auto& texture = m_textures[textureHandle];
+    PROFILE_ZONE("VulkanBackend::Submit");
+
+    //- Resolve the stream
+    // NOTE(v.matushkin): Every draw gets its PerDraw here, one per instance, instances of a draw take consecutive ones.
+    //  Draws from the geometry arena become indirect commands,
+    //  the rest are collected for the recording workers, so the workers don't have to walk the stream.
+    //  Draws whose resources are still being uploaded are dropped, they'll be drawn once the upload has retired.
+    m_directDraws.clear();
+
+    auto sbPerDrawMemory  = static_cast<PerDraw*>(m_sbPerDrawMemory[m_currentFrame].MappedData);
+    auto indirectCommands = static_cast<VkDrawIndexedIndirectCommand*>(m_indirectBufferMemory[m_currentFrame].MappedData);
+    ui32 indirectDrawCounts[k_GeometryArenaIndexTypes] = {};
+
+    const auto instanceData = commandStream.GetInstanceData();
+
+    const VulkanBuffer*  buffer        = nullptr;
+    const VulkanTexture* texture       = nullptr;
+    const glm::mat4x4*   objectToWorld = nullptr;
+
+    const auto addDraw = [&](i32 indexCount, std::span<const glm::mat4x4> instances) {
+        if (m_uploadQueue.IsRetired(buffer->Upload) == false || m_uploadQueue.IsRetired(texture->Upload) == false)
+        {
+            return;
+        }
+
+        const auto instanceCount = static_cast<ui32>(instances.size());
+        SNV_ASSERT(m_perDrawCount + instanceCount <= k_MaxInstancesPerFrame, "PerDraw buffer overflow, increase k_MaxInstancesPerFrame");
+        const auto firstPerDraw = m_perDrawCount;
+        m_perDrawCount         += instanceCount;
+
+        for (ui32 i = 0; i < instanceCount; ++i)
+        {
+            auto& perDraw = sbPerDrawMemory[firstPerDraw + i];
+            std::memcpy(&perDraw._ObjectToWorld, &instances[i], sizeof(glm::mat4x4));
+            perDraw._BaseColorMapIndex = texture->DescriptorIndex;
+        }
+
+        if (buffer->InGeometryArena)
+        {
+            const ui32 indexTypeIndex = buffer->IndexType == VK_INDEX_TYPE_UINT16 ? 0 : 1;
+            SNV_ASSERT(indirectDrawCounts[indexTypeIndex] < k_MaxDrawsPerFrame, "Indirect buffer overflow, increase k_MaxDrawsPerFrame");
+
+            const auto commandIndex = indexTypeIndex * k_MaxDrawsPerFrame + indirectDrawCounts[indexTypeIndex]++;
+
+            indirectCommands[commandIndex] = VkDrawIndexedIndirectCommand{
+                .indexCount    = static_cast<ui32>(indexCount),
+                .instanceCount = instanceCount,
+                .firstIndex    = buffer->ArenaFirstIndex,
+                .vertexOffset  = buffer->ArenaVertexOffset,
+                .firstInstance = firstPerDraw,
+            };
+        }
+        else
+        {
+            m_directDraws.push_back({
+                .Buffer        = buffer,
+                .IndexCount    = static_cast<ui32>(indexCount),
+                .InstanceCount = instanceCount,
+                .PerDrawIndex  = firstPerDraw,
+            });
+        }
+    };
+
+    for (RenderCommandReader reader(commandStream); reader.IsEnd() == false;)
+    {
+        switch (reader.GetType())
+        {
+        case RenderCommandType::BindBuffer:
+            buffer = &m_buffers.find(reader.Read<BindBufferCommand>().Buffer)->second;
+            break;
+        case RenderCommandType::BindTexture:
+            texture = &m_textures.find(reader.Read<BindTextureCommand>().Texture)->second;
+            break;
+        case RenderCommandType::SetObjectToWorld:
+            objectToWorld = &reader.Read<SetObjectToWorldCommand>().ObjectToWorld;
+            break;
+        case RenderCommandType::DrawIndexed:
+            addDraw(reader.Read<DrawIndexedCommand>().IndexCount, std::span(objectToWorld, 1));
+            break;
+        case RenderCommandType::DrawIndexedInstanced:
+        {
+            const auto& command = reader.Read<DrawIndexedInstancedCommand>();
+            addDraw(command.IndexCount, instanceData.subspan(command.FirstInstance, command.InstanceCount));
+            break;
+        }
+        }
+    }
+
+    //- Record
+    // NOTE(v.matushkin): The geometry arena pass is a few commands, it's recorded next to the direct draw chunks
+    const auto directDrawCount  = static_cast<ui32>(m_directDraws.size());
+    const auto chunkCount       = std::min((directDrawCount + k_MinDrawsPerChunk - 1) / k_MinDrawsPerChunk, k_MaxRecordingChunks);
+    const auto hasIndirectDraws = indirectDrawCounts[0] + indirectDrawCounts[1] > 0;
+
+    JobSystem::ParallelFor(chunkCount + 1, [this, &indirectDrawCounts, directDrawCount, chunkCount, hasIndirectDraws](ui32 secondaryIndex) {
+        if (secondaryIndex == 0)
+        {
+            if (hasIndirectDraws)
+            {
+                RecordGeometryArenaDraws(indirectDrawCounts);
+            }
+            return;
+        }
+
+        const auto chunkIndex = secondaryIndex - 1;
+        const auto firstDraw  = chunkIndex * directDrawCount / chunkCount;
+        const auto lastDraw   = (chunkIndex + 1) * directDrawCount / chunkCount;
+        RecordDirectDraws(secondaryIndex, chunkCount, std::span(m_directDraws).subspan(firstDraw, lastDraw - firstDraw));
+    });
+
+    //- Execute, the arena pass goes first, then the direct draws in the stream order
+    const ui32 firstSecondary = hasIndirectDraws ? 0 : 1;
+    const auto executeCount   = chunkCount + 1 - firstSecondary;
+    if (executeCount > 0)
+    {
+        vkCmdExecuteCommands(
+            m_commandBuffers[m_currentFrame],
+            executeCount,
+            &m_secondaryCommandBuffers[m_currentFrame][firstSecondary]
+        );
+    }
+}
+
+VkCommandBuffer VulkanBackend::BeginSecondaryCommandBuffer(ui32 secondaryIndex)
+{
+    auto commandPool   = m_secondaryCommandPools[m_currentFrame][secondaryIndex];
+    auto commandBuffer = m_secondaryCommandBuffers[m_currentFrame][secondaryIndex];
+
+    // NOTE(v.matushkin): BeginFrame waited on m_frameTimeline for the last serial of this frame slot, the GPU is done with the pool
+    vkResetCommandPool(m_device, commandPool, 0);
+
+    VkCommandBufferInheritanceInfo vkInheritanceInfo = {
+        .sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext                = nullptr,
+        .renderPass           = m_renderPass,
+        .subpass              = 0,
+        .framebuffer          = m_framebuffers[m_currentBackBufferIndex],
+        .occlusionQueryEnable = false,
+        .queryFlags           = 0,
+        .pipelineStatistics   = m_gpuProfiler.GetPipelineStatistics(), // NOTE(v.matushkin): The query of the primary is active
+    };
+    VkCommandBufferBeginInfo vkCommandBufferBegin = {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext            = nullptr,
+        .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &vkInheritanceInfo,
+    };
+    vkBeginCommandBuffer(commandBuffer, &vkCommandBufferBegin);
+
+    // NOTE(v.matushkin): Secondary command buffers don't inherit any state.
+    //  Both sets are bound once, draws find their PerDraw and textures by index
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+
+    const VkDescriptorSet vkDescriptorSets[] = {m_descriptorSets[m_currentFrame], m_descriptorSetTextures};
     vkCmdBindDescriptorSets(
         commandBuffer,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         m_pipelineLayout,
-        ShaderSet::Material,
-        1,
-        &m_descriptorSetMaterials[texture.DescriptorSetIndex],
+        ShaderSet::Camera,
+        ARRAYSIZE(vkDescriptorSets),
+        vkDescriptorSets,
         0,
         nullptr
     );
 
-    vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+    return commandBuffer;
+}
+
+void VulkanBackend::RecordGeometryArenaDraws(const ui32 (&indirectDrawCounts)[k_GeometryArenaIndexTypes])
+{
+    PROFILE_ZONE("VulkanBackend::RecordGeometryArenaDraws");
+
+    auto commandBuffer = BeginSecondaryCommandBuffer(0);
+    m_gpuProfiler.BeginPass(commandBuffer, GpuPass::GeometryArena);
+
+    //- Bind the arena, every attribute binding points into the same interleaved vertex
+    const auto vertexBindingCount = static_cast<ui32>(m_vertexLayout.size());
+
+    VkBuffer     vkVertexBuffers[static_cast<ui8>(VertexAttribute::Count)];
+    VkDeviceSize vkVertexOffsets[static_cast<ui8>(VertexAttribute::Count)];
+    for (ui32 i = 0; i < vertexBindingCount; ++i)
+    {
+        vkVertexBuffers[i] = m_geometryArena.Vertex;
+        vkVertexOffsets[i] = m_vertexLayout[i].Offset;
+    }
+    vkCmdBindVertexBuffers(commandBuffer, 0, vertexBindingCount, vkVertexBuffers, vkVertexOffsets);
+
+    //- One indirect draw per index type
+    // NOTE(v.matushkin): The draw count is known on the CPU, vkCmdDrawIndexedIndirectCount is for when the GPU writes them
+    for (ui32 i = 0; i < k_GeometryArenaIndexTypes; ++i)
+    {
+        if (indirectDrawCounts[i] == 0)
+        {
+            continue;
+        }
+
+        vkCmdBindIndexBuffer(commandBuffer, m_geometryArena.Index, 0, vk_GeometryArenaIndexTypes[i]);
+        vkCmdDrawIndexedIndirect(
+            commandBuffer,
+            m_indirectBuffers[m_currentFrame],
+            i * k_MaxDrawsPerFrame * sizeof(VkDrawIndexedIndirectCommand),
+            indirectDrawCounts[i],
+            sizeof(VkDrawIndexedIndirectCommand)
+        );
+    }
+
+    m_gpuProfiler.EndPass(commandBuffer, GpuPass::GeometryArena);
+    vkEndCommandBuffer(commandBuffer);
+}
+
+void VulkanBackend::RecordDirectDraws(ui32 secondaryIndex, ui32 chunkCount, std::span<const DirectDraw> directDraws)
+{
+    PROFILE_ZONE("VulkanBackend::RecordDirectDraws");
+
+    auto commandBuffer = BeginSecondaryCommandBuffer(secondaryIndex);
+
+    // NOTE(v.matushkin): The chunks are executed in order, so the pass spans from the first to the last one
+    if (secondaryIndex == 1)
+    {
+        m_gpuProfiler.BeginPass(commandBuffer, GpuPass::DirectDraws);
+    }
+
+    const auto          vertexBindingCount = static_cast<ui32>(m_vertexLayout.size());
+    const VulkanBuffer* boundBuffer        = nullptr;
+
+    for (const auto& directDraw : directDraws)
+    {
+        if (directDraw.Buffer != boundBuffer)
+        {
+            boundBuffer = directDraw.Buffer;
+
+            VkBuffer vkVertexBuffers[static_cast<ui8>(VertexAttribute::Count)];
+            std::fill_n(vkVertexBuffers, vertexBindingCount, boundBuffer->Vertex);
+
+            vkCmdBindIndexBuffer(commandBuffer, boundBuffer->Index, 0, boundBuffer->IndexType);
+            vkCmdBindVertexBuffers(commandBuffer, 0, vertexBindingCount, vkVertexBuffers, boundBuffer->VertexOffsets);
+        }
+
+        vkCmdDrawIndexed(commandBuffer, directDraw.IndexCount, directDraw.InstanceCount, 0, 0, directDraw.PerDrawIndex);
+    }
+
+    if (secondaryIndex == chunkCount)
+    {
+        m_gpuProfiler.EndPass(commandBuffer, GpuPass::DirectDraws);
+    }
+    vkEndCommandBuffer(commandBuffer);
 }
 
 void VulkanBackend::DrawArrays(i32 count)
@@ -545,6 +955,7 @@ void VulkanBackend::DrawElements(i32 count)
 
 BufferHandle VulkanBackend::CreateBuffer(
     std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
     std::span<const std::byte>              vertexData,
     const std::vector<VertexAttributeDesc>& vertexLayout
 )
@@ -552,175 +963,66 @@ BufferHandle VulkanBackend::CreateBuffer(
     // NOTE(v.matushkin): It almost like it got slower after moving VkBuffer
     // from VISIBLE|COHERENT to DEVICE LOCAL, it can't be, right?
 
-    VulkanBuffer vulkanBuffer;
-
-    VkBuffer* vkBuffers[] = {
-        &vulkanBuffer.Position,
-        &vulkanBuffer.Normal,
-        &vulkanBuffer.TexCoord0,
-    };
-    VkDeviceMemory* vkBuffersMemory[] = {
-        &vulkanBuffer.PositionMemory,
-        &vulkanBuffer.NormalMemory,
-        &vulkanBuffer.TexCoord0Memory,
-    };
-
-    VkBuffer       vkStagingBuffers[4];
-    VkDeviceMemory vkStagingBuffersMemory[4];
-
-    //- Create CPU->GPU buffer transfer VkCommnadBuffer
-    VkCommandBuffer vkCommandBuffer;
-    {
-        VkCommandBufferAllocateInfo vkCommandBufferInfo = {
-            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool        = m_commandPool,
-            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = 1,
-        };
-        vkAllocateCommandBuffers(m_device, &vkCommandBufferInfo, &vkCommandBuffer);
-
-        VkCommandBufferBeginInfo vkCommandBufferBeginInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        };
-        vkBeginCommandBuffer(vkCommandBuffer, &vkCommandBufferBeginInfo);
-    }
-
-    VkBufferCopy vkBufferCopyRegion = {
-        .srcOffset = 0,
-        .dstOffset = 0,
-    };
-
-    //- Create Vertex buffers
-    for (ui32 i = 0; i < vertexLayout.size(); ++i)
+    //- Check the vertex format
+    if (m_vertexLayout.empty())
     {
-        // TODO(v.matushkin): Adjust VertexAttributeDescriptor to remove this hacks
-        const auto& vertexAttribute = vertexLayout[i];
-        const auto  currOffset      = vertexAttribute.Offset;
-        const auto  nextOffset      = (i + 1) < vertexLayout.size() ? vertexLayout[i + 1].Offset : vertexData.size_bytes();
-        const auto  attributeSize   = (nextOffset - currOffset);
+        SNV_ASSERT(m_pipelines.empty(), "A pipeline was created without a vertex layout");
+        m_vertexLayout                   = vertexLayout;
+        m_pipelineState.VertexLayoutHash = HashBytes(std::as_bytes(std::span(m_vertexLayout)));
 
-        //-- Create staging VkBuffer
-        auto& vkStagingBuffer       = vkStagingBuffers[i];
-        auto& vkStagingBufferMemory = vkStagingBuffersMemory[i];
+        // NOTE(v.matushkin): The vertex input is known now, create pipelines of the already loaded shaders
+        for (const auto& handleAndShader : m_shaders)
         {
-            VkBufferCreateInfo vkBufferInfo = {
-                .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-                .pNext                 = nullptr,
-                .flags                 = 0,
-                .size                  = attributeSize,
-                .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
-                .queueFamilyIndexCount = 0, // NOTE(v.matushkin): This is for VK_SHARING_MODE_CONCURRENT ?
-                .pQueueFamilyIndices   = nullptr,
-            };
-            vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vkStagingBuffer);
-
-            // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-            VkMemoryRequirements vkMemoryRequirements;
-            vkGetBufferMemoryRequirements(m_device, vkStagingBuffer, &vkMemoryRequirements);
-
-            //--- Allocate VkDeviceMemory
-            VkMemoryAllocateInfo vkAllocateInfo = {
-                .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                .pNext           = nullptr,
-                .allocationSize  = vkMemoryRequirements.size,
-                .memoryTypeIndex = m_bufferMemoryTypeIndex.CPUtoGPU,
-            };
-            vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &vkStagingBufferMemory);
+            (void) GetOrCreatePipeline(handleAndShader.first);
+        }
+    }
+    SNV_ASSERT(
+        std::equal(vertexLayout.begin(), vertexLayout.end(), m_vertexLayout.begin(), m_vertexLayout.end(), IsSameVertexFormat),
+        "Every buffer must have the same vertex format, there is only one pipeline"
+    );
 
-            //--- Bind VkDeviceMemory to VkBuffer
-            // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
-            vkBindBufferMemory(m_device, vkStagingBuffer, vkStagingBufferMemory, 0);
+    static ui32 buffer_handle_workaround = 0;
 
-            //--- Copy vertex data to VkDeviceMemory
-            void* data;
-            vkMapMemory(m_device, vkStagingBufferMemory, 0, attributeSize, 0, &data);
-            std::memcpy(data, vertexData.data() + currOffset, attributeSize);
-            vkUnmapMemory(m_device, vkStagingBufferMemory);
-        }
-        //-- Create GPU VkBuffer
-        auto vkBuffer       = vkBuffers[i];
-        auto vkBufferMemory = vkBuffersMemory[i];
-        {
-            VkBufferCreateInfo vkStagingBufferInfo = {
-                .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-                .pNext                 = nullptr,
-                .flags                 = 0,
-                .size                  = attributeSize,
-                .usage                 = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
-                .queueFamilyIndexCount = 0, // NOTE(v.matushkin): This is for VK_SHARING_MODE_CONCURRENT ?
-                .pQueueFamilyIndices   = nullptr,
-            };
-            vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, vkBuffer);
-
-            // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-            VkMemoryRequirements vkMemoryRequirements;
-            vkGetBufferMemoryRequirements(m_device, *vkBuffer, &vkMemoryRequirements);
-
-            //--- Allocate VkDeviceMemory
-            VkMemoryAllocateInfo vkAllocateInfo = {
-                .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                .pNext           = nullptr,
-                .allocationSize  = vkMemoryRequirements.size,
-                .memoryTypeIndex = m_bufferMemoryTypeIndex.GPUVertex,
-            };
-            vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, vkBufferMemory);
+    VulkanBuffer vulkanBuffer = {};
 
-            //--- Bind VkDeviceMemory to VkBuffer
-            // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
-            vkBindBufferMemory(m_device, *vkBuffer, *vkBufferMemory, 0);
-        }
+    //- Sub-allocate from the geometry arena
+    if (AllocateFromGeometryArena(indexData, indexFormat, vertexData, vertexLayout, vulkanBuffer))
+    {
+        auto bufferHandle = static_cast<BufferHandle>(buffer_handle_workaround++);
+        m_buffers[bufferHandle] = vulkanBuffer;
 
-        vkBufferCopyRegion.size = attributeSize;
-        // NOTE(v.matushkin): vkCmdCopyBuffer2KHR ?
-        vkCmdCopyBuffer(vkCommandBuffer, vkStagingBuffer, *vkBuffer, 1, &vkBufferCopyRegion);
+        return bufferHandle;
     }
 
-    //- Create Index buffer
-    //-- Create staging VkBuffer
-    auto& vkIndexStagingBuffer       = vkStagingBuffers[3];
-    auto& vkIndexStagingBufferMemory = vkStagingBuffersMemory[3];
+    //- Create Vertex buffer
+    // NOTE(v.matushkin): One buffer for all the attributes, the layout tells where each one of them is
     {
         VkBufferCreateInfo vkBufferInfo = {
             .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .pNext                 = nullptr,
             .flags                 = 0,
-            .size                  = indexData.size_bytes(),
-            .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .size                  = vertexData.size_bytes(),
+            .usage                 = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
             .queueFamilyIndexCount = 0, // NOTE(v.matushkin): This is for VK_SHARING_MODE_CONCURRENT ?
             .pQueueFamilyIndices   = nullptr,
         };
-        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vkIndexStagingBuffer);
-
-        // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetBufferMemoryRequirements(m_device, vkIndexStagingBuffer, &vkMemoryRequirements);
-
-        //--- Allocate VkDeviceMemory
-        VkMemoryAllocateInfo vkAllocateInfo = {
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext           = nullptr,
-            .allocationSize  = vkMemoryRequirements.size,
-            .memoryTypeIndex = m_bufferMemoryTypeIndex.CPUtoGPU,
-        };
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &vkIndexStagingBufferMemory);
+        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vulkanBuffer.Vertex);
 
-        //--- Bind VkDeviceMemory to VkBuffer
-        // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
-        vkBindBufferMemory(m_device, vkIndexStagingBuffer, vkIndexStagingBufferMemory, 0);
+        //-- Allocate and bind memory
+        vulkanBuffer.VertexMemory = m_memoryAllocator.AllocateBuffer(vulkanBuffer.Vertex, m_bufferMemoryTypeIndex.GPUVertex);
 
-        //--- Copy vertex data to VkDeviceMemory
-        void* data;
-        vkMapMemory(m_device, vkIndexStagingBufferMemory, 0, indexData.size_bytes(), 0, &data);
-        std::memcpy(data, indexData.data(), indexData.size_bytes());
-        vkUnmapMemory(m_device, vkIndexStagingBufferMemory);
+        for (ui32 i = 0; i < vertexLayout.size(); ++i)
+        {
+            vulkanBuffer.VertexOffsets[i] = vertexLayout[i].Offset;
+        }
     }
-    //-- Create GPU VkBuffer
+    //-- Stage vertex data, the copy happens when the upload batch is submitted
+    vulkanBuffer.Upload = m_uploadQueue.UploadBuffer(vulkanBuffer.Vertex, 0, vertexData);
+
+    //- Create Index buffer
     {
-        VkBufferCreateInfo vkStagingBufferInfo = {
+        VkBufferCreateInfo vkBufferInfo = {
             .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .pNext                 = nullptr,
             .flags                 = 0,
@@ -730,109 +1032,85 @@ BufferHandle VulkanBackend::CreateBuffer(
             .queueFamilyIndexCount = 0, // NOTE(v.matushkin): This is for VK_SHARING_MODE_CONCURRENT ?
             .pQueueFamilyIndices   = nullptr,
         };
-        vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, &vulkanBuffer.Index);
-
-        // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetBufferMemoryRequirements(m_device, vulkanBuffer.Index, &vkMemoryRequirements);
-
-        //--- Allocate VkDeviceMemory
-        VkMemoryAllocateInfo vkAllocateInfo = {
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext           = nullptr,
-            .allocationSize  = vkMemoryRequirements.size,
-            .memoryTypeIndex = m_bufferMemoryTypeIndex.GPUVertex,
-        };
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &vulkanBuffer.IndexMemory);
+        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vulkanBuffer.Index);
 
-        //--- Bind VkDeviceMemory to VkBuffer
-        // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
-        vkBindBufferMemory(m_device, vulkanBuffer.Index, vulkanBuffer.IndexMemory, 0);
+        //-- Allocate and bind memory
+        vulkanBuffer.IndexMemory = m_memoryAllocator.AllocateBuffer(vulkanBuffer.Index, m_bufferMemoryTypeIndex.GPUIndex);
+        vulkanBuffer.IndexType   = indexFormat == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
     }
+    // NOTE(v.matushkin): Serials only grow, so the last upload is the one that retires last
+    vulkanBuffer.Upload = m_uploadQueue.UploadBuffer(vulkanBuffer.Index, 0, indexData);
 
-    vkBufferCopyRegion.size = indexData.size_bytes();
-    vkCmdCopyBuffer(vkCommandBuffer, vkStagingBuffers[3], vulkanBuffer.Index, 1, &vkBufferCopyRegion);
+    auto bufferHandle = static_cast<BufferHandle>(buffer_handle_workaround++);
 
-    //- Copy vertex data from staging buffers to GPU
-    vkEndCommandBuffer(vkCommandBuffer);
-    VkSubmitInfo vkSubmitInfo = {
-        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers    = &vkCommandBuffer,
-    };
-    vkQueueSubmit(m_graphicsQueue, 1, &vkSubmitInfo, nullptr);
-    vkQueueWaitIdle(m_graphicsQueue);
+    m_buffers[bufferHandle] = vulkanBuffer;
 
-    vkFreeCommandBuffers(m_device, m_commandPool, 1, &vkCommandBuffer);
+    return bufferHandle;
+}
 
-    //- Destroy staging buffers
-    for (ui32 i = 0; i < 4; ++i)
+bool VulkanBackend::AllocateFromGeometryArena(
+    std::span<const std::byte>              indexData,
+    IndexFormat                             indexFormat,
+    std::span<const std::byte>              vertexData,
+    const std::vector<VertexAttributeDesc>& vertexLayout,
+    VulkanBuffer&                           vulkanBuffer
+)
+{
+    //- The arena holds one interleaved vertex stream, the binding offsets are the same for every mesh in it
+    // NOTE(v.matushkin): Planar layouts have per mesh attribute offsets, they would need an arena per attribute
+    const auto vertexStride  = m_vertexLayout[0].Stride;
+    const auto isInterleaved = std::equal(
+        vertexLayout.begin(), vertexLayout.end(), m_vertexLayout.begin(), m_vertexLayout.end(),
+        [vertexStride](const VertexAttributeDesc& lhs, const VertexAttributeDesc& rhs) {
+            return lhs.Offset == rhs.Offset && lhs.Offset < vertexStride && lhs.Stride == vertexStride;
+        }
+    );
+    if (isInterleaved == false)
     {
-        vkDestroyBuffer(m_device, vkStagingBuffers[i], nullptr);
-        vkFreeMemory(m_device, vkStagingBuffersMemory[i], nullptr);
+        return false;
     }
 
-    static ui32 buffer_handle_workaround = 0;
-    auto        bufferHandle     = static_cast<BufferHandle>(buffer_handle_workaround++);
+    //- Find space
+    // NOTE(v.matushkin): Every mesh in the arena has the same stride, so VertexHead is always a whole number of vertices.
+    //  firstIndex counts indices from the start of the buffer, so the index offset must be a multiple of the index size
+    const auto indexSize   = static_cast<VkDeviceSize>(GetIndexFormatSize(indexFormat));
+    const auto indexOffset = (m_geometryArena.IndexHead + indexSize - 1) / indexSize * indexSize;
 
-    m_buffers[bufferHandle] = vulkanBuffer;
+    if (m_geometryArena.VertexHead + vertexData.size_bytes() > k_GeometryArenaVertexSize
+        || indexOffset + indexData.size_bytes() > k_GeometryArenaIndexSize)
+    {
+        LOG_WARN("Geometry arena is full, the mesh gets its own buffers");
+        return false;
+    }
 
-    return bufferHandle;
+    vulkanBuffer.Index             = m_geometryArena.Index;
+    vulkanBuffer.Vertex            = m_geometryArena.Vertex;
+    vulkanBuffer.IndexType         = indexFormat == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    vulkanBuffer.InGeometryArena   = true;
+    vulkanBuffer.ArenaVertexOffset = static_cast<i32>(m_geometryArena.VertexHead / vertexStride);
+    vulkanBuffer.ArenaFirstIndex   = static_cast<ui32>(indexOffset / indexSize);
+
+    //- Stage the data, the copies happen when the upload batch is submitted
+    // NOTE(v.matushkin): Serials only grow, so the last upload is the one that retires last
+    static_cast<void>(m_uploadQueue.UploadBuffer(m_geometryArena.Vertex, m_geometryArena.VertexHead, vertexData));
+    vulkanBuffer.Upload = m_uploadQueue.UploadBuffer(m_geometryArena.Index, indexOffset, indexData);
+
+    m_geometryArena.VertexHead += vertexData.size_bytes();
+    m_geometryArena.IndexHead   = indexOffset + indexData.size_bytes();
+
+    return true;
 }
 
 TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const ui8* textureData)
 {
-    // TODO(v.matushkin): Assuming texture format is RGBA8888. Shouldn't be hardcoded
-    //  Seems like there was no need to know the actual texture data size in another backends, which is strange.
-    //  But here I need it.
-    //  Pass textureData as std::span? Add size member to TextureDesc? Convert texture format to pixel size?
-    //  May be if I used VkImage as a staging buffer instead of VkBuffer, texture width/height/format would be enough.
-    //  But here - https://developer.nvidia.com/vulkan-memory-management, the say that it is better to use VkBuffer.
-    const auto textureSize = textureDesc.Width * textureDesc.Height * sizeof(ui8) * 4;
+    // NOTE(v.matushkin): https://developer.nvidia.com/vulkan-memory-management, the say that it is better to use VkBuffer
+    //  as a staging buffer instead of VkImage.
+    const auto mipCount = textureDesc.MipCount;
 
     const auto vkTextureFormat = vk_TextureFormat[static_cast<ui8>(textureDesc.Format)];
 
     VulkanTexture vulkanTexture;
 
-    //- Create staging texture VkBuffer
-    VkBuffer vkTextureStagingBuffer;
-    VkDeviceMemory vkTextureStagingBufferMemory;
-    {
-        VkBufferCreateInfo vkBufferInfo = {
-            .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext                 = nullptr,
-            .flags                 = 0,
-            .size                  = textureSize,
-            .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 0, // NOTE(v.matushkin): This is for VK_SHARING_MODE_CONCURRENT ?
-            .pQueueFamilyIndices   = nullptr,
-        };
-        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vkTextureStagingBuffer);
-
-        // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetBufferMemoryRequirements(m_device, vkTextureStagingBuffer, &vkMemoryRequirements);
-
-        //-- Allocate VkDeviceMemory
-        VkMemoryAllocateInfo vkAllocateInfo = {
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext           = nullptr,
-            .allocationSize  = vkMemoryRequirements.size,
-            .memoryTypeIndex = m_bufferMemoryTypeIndex.CPUtoGPU,
-        };
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &vkTextureStagingBufferMemory);
-
-        //-- Bind VkDeviceMemory to VkBuffer
-        // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
-        vkBindBufferMemory(m_device, vkTextureStagingBuffer, vkTextureStagingBufferMemory, 0);
-
-        //-- Copy texture data to VkDeviceMemory
-        void* data;
-        vkMapMemory(m_device, vkTextureStagingBufferMemory, 0, textureSize, 0, &data);
-        std::memcpy(data, textureData, textureSize);
-        vkUnmapMemory(m_device, vkTextureStagingBufferMemory);
-    }
     //- Create VkImage
     {
         VkImageCreateInfo vkImageInfo = {
@@ -842,7 +1120,7 @@ TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const
             .imageType             = VK_IMAGE_TYPE_2D,
             .format                = vkTextureFormat,
             .extent                = {textureDesc.Width, textureDesc.Height, 1},
-            .mipLevels             = 1,
+            .mipLevels             = mipCount,
             .arrayLayers           = 1,
             .samples               = VK_SAMPLE_COUNT_1_BIT,
             .tiling                = VK_IMAGE_TILING_OPTIMAL,
@@ -854,126 +1132,11 @@ TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const
         };
         vkCreateImage(m_device, &vkImageInfo, nullptr, &vulkanTexture.Image);
 
-        // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetImageMemoryRequirements(m_device, vulkanTexture.Image, &vkMemoryRequirements);
-
-        //-- Allocate VkDeviceMemory
-        VkMemoryAllocateInfo vkAllocateInfo = {
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext           = nullptr,
-            .allocationSize  = vkMemoryRequirements.size,
-            .memoryTypeIndex = m_bufferMemoryTypeIndex.GPUTexture,
-        };
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &vulkanTexture.Memory);
-
-        //-- Bind VkDeviceMemory to VkImage
-        // NOTE(v.matushkin): vkBindImageMemory2 ?
-        vkBindImageMemory(m_device, vulkanTexture.Image, vulkanTexture.Memory, 0);
+        //-- Allocate and bind memory
+        vulkanTexture.Memory = m_memoryAllocator.AllocateImage(vulkanTexture.Image, m_bufferMemoryTypeIndex.GPUTexture);
     }
-    //- Transfer texture from CPU to GPU
-    {
-        VkCommandBuffer vkCommandBuffer;
-
-        //- Allocate
-        VkCommandBufferAllocateInfo vkCommandBufferInfo = {
-            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool        = m_commandPool,
-            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = 1,
-        };
-        vkAllocateCommandBuffers(m_device, &vkCommandBufferInfo, &vkCommandBuffer);
-        //- Begin
-        VkCommandBufferBeginInfo vkCommandBufferBeginInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        };
-        vkBeginCommandBuffer(vkCommandBuffer, &vkCommandBufferBeginInfo);
-        //- VkImage Memory Barrier UNDEFINED->DST_OPTIMAL
-        VkImageSubresourceRange vkImageSubresourceRange = {
-            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel   = 0,
-            .levelCount     = 1,
-            .baseArrayLayer = 0,
-            .layerCount     = 1,
-        };
-        // TODO(v.matushkin): VkImageMemoryBarrier2KHR
-        VkImageMemoryBarrier vkImageMemoryBarrier = {
-            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .pNext               = nullptr,
-            .srcAccessMask       = 0,
-            .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,
-            .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image               = vulkanTexture.Image,
-            .subresourceRange    = vkImageSubresourceRange,
-        };
-        // TODO(v.matushkin): vkCmdPipelineBarrier2KHR?
-        vkCmdPipelineBarrier(
-            vkCommandBuffer,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0, // NOTE(v.matushkin): ???
-            0, nullptr,
-            0, nullptr,
-            1, &vkImageMemoryBarrier
-        );
-        //- Copy VkBuffer to VkImage
-        VkImageSubresourceLayers vkImageSubresourceLayers = {
-            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-            .mipLevel       = 0,
-            .baseArrayLayer = 0,
-            .layerCount     = 1,
-        };
-        // NOTE(v.matushkin): VkBufferImageCopy2KHR?
-        VkBufferImageCopy vkBufferImageCopy = {
-            .bufferOffset      = 0,
-            .bufferRowLength   = 0,
-            .bufferImageHeight = 0,
-            .imageSubresource  = vkImageSubresourceLayers,
-            .imageOffset       = {0, 0, 0},
-            .imageExtent       = {textureDesc.Width, textureDesc.Height, 1},
-        };
-        vkCmdCopyBufferToImage(
-            vkCommandBuffer,
-            vkTextureStagingBuffer,
-            vulkanTexture.Image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &vkBufferImageCopy
-        );
-        //- VkImage Memory Barrier DST_OPTIMAL->SHADER_READ_ONLY_OPTIMAL
-        vkImageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        vkImageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        vkImageMemoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        vkImageMemoryBarrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        vkCmdPipelineBarrier(
-            vkCommandBuffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0, // NOTE(v.matushkin): ???
-            0, nullptr,
-            0, nullptr,
-            1, &vkImageMemoryBarrier
-        );
-
-        //- Submit
-        vkEndCommandBuffer(vkCommandBuffer);
-
-        VkSubmitInfo vkSubmitInfo = {
-            .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .commandBufferCount = 1,
-            .pCommandBuffers    = &vkCommandBuffer,
-        };
-        vkQueueSubmit(m_graphicsQueue, 1, &vkSubmitInfo, nullptr);
-        vkQueueWaitIdle(m_graphicsQueue);
-
-        vkFreeCommandBuffers(m_device, m_commandPool, 1, &vkCommandBuffer);
-    }
-    vkDestroyBuffer(m_device, vkTextureStagingBuffer, nullptr);
-    vkFreeMemory(m_device, vkTextureStagingBufferMemory, nullptr);
+    //- Stage texture data, the copy happens when the upload batch is submitted
+    vulkanTexture.Upload = m_uploadQueue.UploadTexture(vulkanTexture.Image, textureDesc, textureData);
 
     //- Create VkImageView
     {
@@ -986,7 +1149,7 @@ TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const
         VkImageSubresourceRange vkImageSubresourceRange = {
             .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
             .baseMipLevel   = 0,
-            .levelCount     = 1,
+            .levelCount     = mipCount,
             .baseArrayLayer = 0,
             .layerCount     = 1,
         };
@@ -1005,30 +1168,23 @@ TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const
 
     static ui32 texture_handle_workaround = 0;
 
-    //- Create Texture descriptor
-    vulkanTexture.DescriptorSetIndex = texture_handle_workaround;
+    //- Write to the bindless texture array
+    // NOTE(v.matushkin): The handle is the array element, handles are never reused so the array only grows
+    SNV_ASSERT(texture_handle_workaround < m_maxTextureDescriptors, "Bindless texture array is full");
+    vulkanTexture.DescriptorIndex = texture_handle_workaround;
     {
-        //-- Allocate DescriptorSet
-        VkDescriptorSetAllocateInfo vkDescriptorSetInfo = {
-            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-            .pNext              = nullptr,
-            .descriptorPool     = m_descriptorPool,
-            .descriptorSetCount = 1,
-            .pSetLayouts        = &m_descriptorSetLayourMaterial,
-        };
-        vkAllocateDescriptorSets(m_device, &vkDescriptorSetInfo, &m_descriptorSetMaterials[texture_handle_workaround]);
-        //-- Write to DescriptorSet
         VkDescriptorImageInfo vkDescriptorImageInfo = {
             .sampler     = nullptr, // NOTE(v.matushkin): What to set when using immutable sampler?
             .imageView   = vulkanTexture.View,
             .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         };
+        // NOTE(v.matushkin): The set is UPDATE_AFTER_BIND, frames in flight use it, but never this element
         VkWriteDescriptorSet vkWriteDescriptorSet = {
             .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext            = nullptr,
-            .dstSet           = m_descriptorSetMaterials[texture_handle_workaround],
-            .dstBinding       = ShaderBinding::tBaseColorMap,
-            .dstArrayElement  = 0,
+            .dstSet           = m_descriptorSetTextures,
+            .dstBinding       = ShaderBinding::tTextures,
+            .dstArrayElement  = vulkanTexture.DescriptorIndex,
             .descriptorCount  = 1,
             .descriptorType   = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
             .pImageInfo       = &vkDescriptorImageInfo,
@@ -1038,19 +1194,99 @@ TextureHandle VulkanBackend::CreateTexture(const TextureDesc& textureDesc, const
         vkUpdateDescriptorSets(m_device, 1, &vkWriteDescriptorSet, 0, nullptr);
     }
 
-    auto textureHandle = static_cast<TextureHandle>(texture_handle_workaround++);
+    auto textureHandle = static_cast<TextureHandle>(texture_handle_workaround++);
+
+    m_textures[textureHandle] = vulkanTexture;
+
+    return textureHandle;
+}
+
+ShaderHandle VulkanBackend::CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    VulkanShader vulkanShader;
+    if (CreateShaderModules(vertexSource, fragmentSource, vulkanShader) == false)
+    {
+        LOG_ERROR("VulkanBackend: failed to create a shader");
+        return ShaderHandle::InvalidHandle;
+    }
+
+    static ui32 shader_handle_workaround = 0;
+    auto        shaderHandle             = static_cast<ShaderHandle>(shader_handle_workaround++);
+
+    m_shaders[shaderHandle] = vulkanShader;
+
+    if (m_vertexLayout.empty() == false)
+    {
+        (void) GetOrCreatePipeline(shaderHandle);
+    }
+
+    return shaderHandle;
+}
+
+bool VulkanBackend::ReloadShader(ShaderHandle shaderHandle, std::span<const char> vertexSource, std::span<const char> fragmentSource)
+{
+    // NOTE(v.matushkin): Runs on the shader watcher thread. Compilation and pipeline creation are the slow parts,
+    //  they're done here so the render loop never waits for them, BeginFrame() only swaps the handles
+    VulkanShader vulkanShader;
+    if (CreateShaderModules(vertexSource, fragmentSource, vulkanShader) == false)
+    {
+        LOG_ERROR("VulkanBackend: failed to reload shader {}, the old one is kept", static_cast<ui32>(shaderHandle));
+        return false;
+    }
+
+    PipelineState pipelineState;
+    {
+        std::lock_guard lock(m_shaderReloadMutex);
+        pipelineState = m_reloadPipelineState;
+    }
+    pipelineState.Shader = shaderHandle;
 
-    m_textures[textureHandle] = vulkanTexture;
+    // NOTE(v.matushkin): The pipelines of the other states are created from the new modules on the next lookup
+    const auto pipeline = pipelineState.VertexLayoutHash != 0 ? CreatePipeline(pipelineState, vulkanShader) : VK_NULL_HANDLE;
 
-    return textureHandle;
+    std::lock_guard lock(m_shaderReloadMutex);
+    m_pendingShaderReloads.push_back(PendingShaderReload{
+        .Handle   = shaderHandle,
+        .Shader   = vulkanShader,
+        .Pipeline = pipeline,
+        .State    = pipelineState,
+    });
+
+    return true;
 }
 
-ShaderHandle VulkanBackend::CreateShader(std::span<const char> vertexSource, std::span<const char> fragmentSource)
+bool VulkanBackend::CreateShaderModules(
+    std::span<const char> vertexSource,
+    std::span<const char> fragmentSource,
+    VulkanShader&         vulkanShader
+)
 {
-    const auto vertexBytecode   = VulkanShaderCompiler::CompileShader(VulkanShaderCompiler::ShaderType::Vertex, vertexSource);
-    const auto fragmentBytecode = VulkanShaderCompiler::CompileShader(VulkanShaderCompiler::ShaderType::Fragment, fragmentSource);
+    // NOTE(v.matushkin): A stage is either SPIR-V precompiled by SuperNovaShaderCompiler or GLSL that is compiled here,
+    //  AssetDatabase passes GLSL only when the precompiled one is stale
+    const auto getBytecode = [](VulkanShaderCompiler::ShaderType shaderType, std::span<const char> shaderSource) {
+        ui32 firstWord = 0;
+        if (shaderSource.size() >= sizeof(ui32) && shaderSource.size() % sizeof(ui32) == 0)
+        {
+            std::memcpy(&firstWord, shaderSource.data(), sizeof(ui32));
+        }
 
-    VulkanShader vulkanShader;
+        if (firstWord == VulkanShaderCompiler::k_SpirvMagicNumber)
+        {
+            std::vector<ui32> spirvBytecode(shaderSource.size() / sizeof(ui32));
+            std::memcpy(spirvBytecode.data(), shaderSource.data(), shaderSource.size());
+            return spirvBytecode;
+        }
+
+        return VulkanShaderCompiler::CompileShader(shaderType, shaderSource);
+    };
+
+    const auto vertexBytecode   = getBytecode(VulkanShaderCompiler::ShaderType::Vertex, vertexSource);
+    const auto fragmentBytecode = getBytecode(VulkanShaderCompiler::ShaderType::Fragment, fragmentSource);
+
+    if (vertexBytecode.empty() || fragmentBytecode.empty())
+    {
+        return false;
+    }
 
     VkShaderModuleCreateInfo vkVertexShaderInfo = {
        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
@@ -1070,12 +1306,103 @@ ShaderHandle VulkanBackend::CreateShader(std::span<const char> vertexSource, std
     };
     vkCreateShaderModule(m_device, &vkFragmentShaderInfo, nullptr, &vulkanShader.Fragment);
 
-    static ui32 shader_handle_workaround = 0;
-    auto        shaderHandle             = static_cast<ShaderHandle>(shader_handle_workaround++);
+    return true;
+}
 
-    m_shaders[shaderHandle] = vulkanShader;
+void VulkanBackend::ApplyShaderReloads()
+{
+    DestroyRetiredShaders(false);
 
-    return shaderHandle;
+    std::vector<PendingShaderReload> shaderReloads;
+    {
+        std::lock_guard lock(m_shaderReloadMutex);
+        m_reloadPipelineState = m_pipelineState;
+        shaderReloads.swap(m_pendingShaderReloads);
+    }
+
+    for (const auto& shaderReload : shaderReloads)
+    {
+        const auto shaderIt = m_shaders.find(shaderReload.Handle);
+        if (shaderIt == m_shaders.end())
+        {
+            vkDestroyPipeline(m_device, shaderReload.Pipeline, nullptr);
+            vkDestroyShaderModule(m_device, shaderReload.Shader.Vertex, nullptr);
+            vkDestroyShaderModule(m_device, shaderReload.Shader.Fragment, nullptr);
+            continue;
+        }
+
+        //- Retire the old shader with all of its pipelines, the frames in flight may still use them
+        RetiredShader retiredShader = {
+            .Shader      = shaderIt->second,
+            .Pipelines   = {},
+            .FrameSerial = m_frameSerial,
+        };
+        std::erase_if(m_pipelines, [&retiredShader, &shaderReload](const auto& stateAndPipeline) {
+            if (stateAndPipeline.first.Shader != shaderReload.Handle)
+            {
+                return false;
+            }
+            retiredShader.Pipelines.push_back(stateAndPipeline.second);
+            return true;
+        });
+        m_retiredShaders.push_back(std::move(retiredShader));
+
+        //- Swap in the new one
+        shaderIt->second = shaderReload.Shader;
+        if (shaderReload.Pipeline != VK_NULL_HANDLE)
+        {
+            m_pipelines[shaderReload.State] = shaderReload.Pipeline;
+        }
+
+        LOG_INFO("VulkanBackend: shader {} reloaded", static_cast<ui32>(shaderReload.Handle));
+    }
+}
+
+void VulkanBackend::DestroyRetiredShaders(bool destroyAll)
+{
+    ui64 completedFrameSerial;
+    vkGetSemaphoreCounterValue(m_device, m_frameTimeline, &completedFrameSerial);
+
+    std::erase_if(m_retiredShaders, [this, destroyAll, completedFrameSerial](const RetiredShader& retiredShader) {
+        if (destroyAll == false && retiredShader.FrameSerial > completedFrameSerial)
+        {
+            return false;
+        }
+
+        for (auto pipeline : retiredShader.Pipelines)
+        {
+            vkDestroyPipeline(m_device, pipeline, nullptr);
+        }
+        vkDestroyShaderModule(m_device, retiredShader.Shader.Vertex, nullptr);
+        vkDestroyShaderModule(m_device, retiredShader.Shader.Fragment, nullptr);
+
+        return true;
+    });
+}
+
+void VulkanBackend::WaitForFrame(ui64 frameSerial)
+{
+    PROFILE_ZONE("VulkanBackend::WaitForFrame");
+
+    VkSemaphoreWaitInfo vkSemaphoreWaitInfo = {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext          = nullptr,
+        .flags          = 0,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_frameTimeline,
+        .pValues        = &frameSerial,
+    };
+
+    VkResult vkWaitResult;
+    while ((vkWaitResult = vkWaitSemaphores(m_device, &vkSemaphoreWaitInfo, k_FrameWaitTimeout)) == VK_TIMEOUT)
+    {
+        LOG_WARN("VulkanBackend: frame {} is taking more than a second on the GPU", frameSerial);
+    }
+
+    if (vkWaitResult != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanBackend: waiting for frame {} failed, VkResult: {}", frameSerial, static_cast<i32>(vkWaitResult));
+    }
 }
 
 
@@ -1172,6 +1499,26 @@ void VulkanBackend::CreateDevice()
     m_physiacalDevice     = vkPhysicalDevice;
     m_graphicsQueueFamily = vkGraphicsQueueFamily;
 
+    //- Bindless texture array size
+    {
+        VkPhysicalDeviceDescriptorIndexingProperties vkDescriptorIndexingProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+            .pNext = nullptr,
+        };
+        VkPhysicalDeviceProperties2 vkDeviceProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &vkDescriptorIndexingProperties,
+        };
+        vkGetPhysicalDeviceProperties2(m_physiacalDevice, &vkDeviceProperties);
+
+        m_maxTextureDescriptors = std::min({
+            k_MaxTextureDescriptors,
+            vkDescriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+            vkDescriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        });
+        LOG_INFO("Bindless texture array size: {}", m_maxTextureDescriptors);
+    }
+
     //- Create VkDevice with graphics queue
     const f32               k_QueuePriority   = 1.0f;
     // NOTE(v.matushkin): Use VkDeviceQueueGlobalPriorityCreateInfoEXT ?
@@ -1183,11 +1530,39 @@ void VulkanBackend::CreateDevice()
         .queueCount       = 1,
         .pQueuePriorities = &k_QueuePriority,
     };
-    VkPhysicalDeviceFeatures vkPhysicalDeviceFeatures{};
+    // NOTE(v.matushkin): The pipeline statistics query of VulkanGpuProfiler is active while the secondary
+    //  command buffers execute, without inheritedQueries there are no statistics at all
+    VkPhysicalDeviceFeatures vkSupportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_physiacalDevice, &vkSupportedFeatures);
+    m_isPipelineStatisticsEnabled = vkSupportedFeatures.pipelineStatisticsQuery && vkSupportedFeatures.inheritedQueries;
+
+    // NOTE(v.matushkin): Draws from the geometry arena are indirect, firstInstance is the PerDraw index
+    VkPhysicalDeviceFeatures vkPhysicalDeviceFeatures = {
+        .multiDrawIndirect                      = true,
+        .drawIndirectFirstInstance              = true,
+        .pipelineStatisticsQuery                = m_isPipelineStatisticsEnabled,
+        .shaderSampledImageArrayDynamicIndexing = true,
+        .inheritedQueries                       = m_isPipelineStatisticsEnabled,
+    };
+    // NOTE(v.matushkin): Core in 1.2, used by VulkanUploadQueue
+    VkPhysicalDeviceTimelineSemaphoreFeatures vkTimelineSemaphore = {
+        .sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+        .pNext             = nullptr,
+        .timelineSemaphore = true,
+    };
+    // NOTE(v.matushkin): Core in 1.2 but optional, checked in IsPhysicalDeviceSuitable()
+    VkPhysicalDeviceDescriptorIndexingFeatures vkDescriptorIndexing = {
+        .sType                                        = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .pNext                                        = &vkTimelineSemaphore,
+        .shaderSampledImageArrayNonUniformIndexing    = true,
+        .descriptorBindingSampledImageUpdateAfterBind = true,
+        .descriptorBindingPartiallyBound              = true,
+        .runtimeDescriptorArray                       = true,
+    };
     // NOTE(v.matushkin): Check for SeparateDepthStencilLayoutsFeatures support?
     VkPhysicalDeviceSeparateDepthStencilLayoutsFeatures vkSeparateDepthStencilLayout = {
         .sType                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SEPARATE_DEPTH_STENCIL_LAYOUTS_FEATURES,
-        .pNext                       = nullptr,
+        .pNext                       = &vkDescriptorIndexing,
         .separateDepthStencilLayouts = true,
     };
     VkDeviceCreateInfo vkDeviceInfo = {
@@ -1208,7 +1583,7 @@ void VulkanBackend::CreateDevice()
     vkGetDeviceQueue(m_device, m_graphicsQueueFamily, 0, &m_graphicsQueue);
 }
 
-void VulkanBackend::CreateSwapchain()
+void VulkanBackend::CreateSwapchain(PresentMode preferredPresentMode)
 {
     //- Surface format
     // TODO(v.matushkin): <SwapchainCreation/Format>
@@ -1229,15 +1604,16 @@ void VulkanBackend::CreateSwapchain()
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physiacalDevice, m_surface, &vkSurfaceCapabilities);
 
     //-- Image Count
-    ui32 vkMinImageCount = k_BackBufferFrames;
+    // NOTE(v.matushkin): One more than the minimum, so the acquire doesn't wait for the presentation engine
+    //  to release an image. Doesn't depend on the frames in flight, that is only about the CPU running ahead
+    ui32 vkMinImageCount = vkSurfaceCapabilities.minImageCount + 1;
     {
-        const auto minImageCount = vkSurfaceCapabilities.minImageCount;
-        const auto maxImageCount = vkSurfaceCapabilities.maxImageCount;
-        if (vkMinImageCount < minImageCount || (maxImageCount > 0 && maxImageCount < vkMinImageCount))
+        const auto maxImageCount = vkSurfaceCapabilities.maxImageCount; // NOTE(v.matushkin): 0 means no limit
+        if (maxImageCount > 0)
         {
-            // TODO(v.matushkin): <SwapchainCreation/ImageCount>
-            SNV_ASSERT(false, "<SwapchainCreation/ImageCount>");
+            vkMinImageCount = std::min(vkMinImageCount, maxImageCount);
         }
+        vkMinImageCount = std::min(vkMinImageCount, k_MaxSwapchainImages);
     }
 
     //-- Image Extent
@@ -1272,8 +1648,11 @@ void VulkanBackend::CreateSwapchain()
     }
 
     //- Present Mode
+    // NOTE(v.matushkin): FIFO is the only one that is guaranteed to be supported
     VkPresentModeKHR vkPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     {
+        const auto vkPreferredPresentMode = vk_PresentMode[static_cast<ui8>(preferredPresentMode)];
+
         ui32 vkPresentModeCount;
         vkGetPhysicalDeviceSurfacePresentModesKHR(m_physiacalDevice, m_surface, &vkPresentModeCount, nullptr);
         auto vkPresentModes = new VkPresentModeKHR[vkPresentModeCount];
@@ -1281,12 +1660,17 @@ void VulkanBackend::CreateSwapchain()
 
         for (ui32 i = 0; i < vkPresentModeCount; ++i)
         {
-            if (vkPresentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
+            if (vkPresentModes[i] == vkPreferredPresentMode)
             {
                 vkPresentMode = vkPresentModes[i];
             }
         }
         delete[] vkPresentModes;
+
+        if (vkPresentMode != vkPreferredPresentMode)
+        {
+            LOG_WARN("VulkanBackend: the surface doesn't support the preferred present mode, falling back to FIFO");
+        }
     }
 
     //- Create Swapchain
@@ -1313,12 +1697,16 @@ void VulkanBackend::CreateSwapchain()
     vkCreateSwapchainKHR(m_device, &vkSwapchainInfo, nullptr, &m_swapchain);
 
     //- Get Swapchain Images
+    // NOTE(v.matushkin): The implementation can create more images than minImageCount
     ui32 vkSwapchainImageCount;
     vkGetSwapchainImagesKHR(m_device, m_swapchain, &vkSwapchainImageCount, nullptr);
-    SNV_ASSERT(vkSwapchainImageCount == k_BackBufferFrames, "<SwapchainCreation/ImageCount>");
-    VkImage vkSwapchainImages[k_BackBufferFrames];
+    SNV_ASSERT(vkSwapchainImageCount <= k_MaxSwapchainImages, "Swapchain has more images than k_MaxSwapchainImages");
+    VkImage vkSwapchainImages[k_MaxSwapchainImages];
     vkGetSwapchainImagesKHR(m_device, m_swapchain, &vkSwapchainImageCount, vkSwapchainImages);
 
+    m_swapchainImageCount = vkSwapchainImageCount;
+    LOG_INFO("Swapchain: {} images, present mode {}, {} frames in flight", m_swapchainImageCount, static_cast<i32>(vkPresentMode), m_framesInFlight);
+
     //- Create Swapchain Image Views
     VkComponentMapping vkComponentMapping = {
         .r = VK_COMPONENT_SWIZZLE_R,
@@ -1374,22 +1762,9 @@ void VulkanBackend::CreateDepthBuffer()
         };
         vkCreateImage(m_device, &vkImageInfo, nullptr, &m_depthImage);
 
-        // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetImageMemoryRequirements(m_device, m_depthImage, &vkMemoryRequirements);
-
-        //- Allocate VkDeviceMemory
-        VkMemoryAllocateInfo vkAllocateInfo = {
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext           = nullptr,
-            .allocationSize  = vkMemoryRequirements.size,
-            .memoryTypeIndex = m_bufferMemoryTypeIndex.GPUTexture,
-        };
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &m_depthImageMemory);
-
-        //- Bind VkDeviceMemory to VkImage
-        // NOTE(v.matushkin): vkBindImageMemory2 ?
-        vkBindImageMemory(m_device, m_depthImage, m_depthImageMemory, 0);
+        //- Allocate and bind memory
+        // NOTE(v.matushkin): Render targets would benefit from a dedicated allocation (VK_KHR_dedicated_allocation)
+        m_depthImageMemory = m_memoryAllocator.AllocateImage(m_depthImage, m_bufferMemoryTypeIndex.GPUTexture);
     }
     //- Create VkImageView
     {
@@ -1531,7 +1906,7 @@ void VulkanBackend::CreateFramebuffers()
         .layers          = 1,
     };
 
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_swapchainImageCount; ++i)
     {
         vkAttachments[0] = m_backBuffers[i];
         vkFramebufferInfo.pAttachments = vkAttachments;
@@ -1554,8 +1929,8 @@ void VulkanBackend::CreateDescriptorSetLayouts()
             },
             // PerDraw
             {
-                .binding            = ShaderBinding::ubPerDraw,
-                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .binding            = ShaderBinding::sbPerDraw,
+                .descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                 .descriptorCount    = 1,
                 .stageFlags         = VK_SHADER_STAGE_VERTEX_BIT,
                 .pImmutableSamplers = nullptr,
@@ -1579,31 +1954,152 @@ void VulkanBackend::CreateDescriptorSetLayouts()
         vkCreateDescriptorSetLayout(m_device, &vkDescriptorSetLayoutInfo, nullptr, &m_descriptorSetLayoutCamera);
     }
     //- Set 1
+    // NOTE(v.matushkin): Bindless texture array. PARTIALLY_BOUND, elements that no texture was written to yet
+    //  are never accessed. UPDATE_AFTER_BIND, CreateTexture() writes to it while the set is used by the frames in flight
     {
         VkDescriptorSetLayoutBinding vkDescriptorSetLayoutBinding = {
-            .binding            = ShaderBinding::tBaseColorMap,
+            .binding            = ShaderBinding::tTextures,
             .descriptorType     = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-            .descriptorCount    = 1,
+            .descriptorCount    = m_maxTextureDescriptors,
             .stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT,
             .pImmutableSamplers = nullptr,
         };
+        const VkDescriptorBindingFlags vkDescriptorBindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                                                                | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+        VkDescriptorSetLayoutBindingFlagsCreateInfo vkDescriptorSetLayoutBindingFlagsInfo = {
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .pNext         = nullptr,
+            .bindingCount  = 1,
+            .pBindingFlags = &vkDescriptorBindingFlags,
+        };
         VkDescriptorSetLayoutCreateInfo vkDescriptorSetLayoutInfo = {
             .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            .pNext        = nullptr,
-            .flags        = 0,
+            .pNext        = &vkDescriptorSetLayoutBindingFlagsInfo,
+            .flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
             .bindingCount = 1,
             .pBindings    = &vkDescriptorSetLayoutBinding,
         };
-        vkCreateDescriptorSetLayout(m_device, &vkDescriptorSetLayoutInfo, nullptr, &m_descriptorSetLayourMaterial);
+        vkCreateDescriptorSetLayout(m_device, &vkDescriptorSetLayoutInfo, nullptr, &m_descriptorSetLayoutTextures);
     }
 
 }
 
-void VulkanBackend::CreatePipeline()
+void VulkanBackend::CreatePipelineLayout()
 {
-    //- ShaderStages
-    auto& shader = m_shaders.begin()->second;
+    VkDescriptorSetLayout      vkDescriptorSetLayouts[] = {m_descriptorSetLayoutCamera, m_descriptorSetLayoutTextures};
+    VkPipelineLayoutCreateInfo vkPipelineLayoutInfo = {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext                  = nullptr,
+        .flags                  = 0, // SPEC: reserved for future use
+        .setLayoutCount         = ARRAYSIZE(vkDescriptorSetLayouts),
+        .pSetLayouts            = vkDescriptorSetLayouts,
+        .pushConstantRangeCount = 0,
+        .pPushConstantRanges    = nullptr,
+    };
+    vkCreatePipelineLayout(m_device, &vkPipelineLayoutInfo, nullptr, &m_pipelineLayout);
+}
+
+void VulkanBackend::CreatePipelineCache()
+{
+    // NOTE(v.matushkin): The driver must reject incompatible data by itself, but not all of them do,
+    //  so the header is checked against the current device before handing the data over
+    VkPhysicalDeviceProperties vkDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physiacalDevice, &vkDeviceProperties);
+
+    MappedFile                 cacheFile(k_PipelineCachePath);
+    std::span<const std::byte> cacheData;
+
+    if (cacheFile.IsValid())
+    {
+        const auto fileData = cacheFile.GetData();
+
+        VkPipelineCacheHeaderVersionOne vkCacheHeader = {};
+        if (fileData.size() >= sizeof(vkCacheHeader))
+        {
+            std::memcpy(&vkCacheHeader, fileData.data(), sizeof(vkCacheHeader));
+        }
+
+        if (fileData.size() >= sizeof(vkCacheHeader)
+            && vkCacheHeader.headerSize >= sizeof(vkCacheHeader)
+            && vkCacheHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && vkCacheHeader.vendorID == vkDeviceProperties.vendorID
+            && vkCacheHeader.deviceID == vkDeviceProperties.deviceID
+            && std::memcmp(vkCacheHeader.pipelineCacheUUID, vkDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+        {
+            cacheData = fileData;
+        }
+        else
+        {
+            LOG_INFO("Vulkan pipeline cache {} is for a different device or driver, it will be rebuilt", k_PipelineCachePath);
+        }
+    }
+
+    VkPipelineCacheCreateInfo vkPipelineCacheInfo = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext           = nullptr,
+        .flags           = 0,
+        .initialDataSize = cacheData.size(),
+        .pInitialData    = cacheData.data(),
+    };
+    vkCreatePipelineCache(m_device, &vkPipelineCacheInfo, nullptr, &m_pipelineCache);
+}
+
+void VulkanBackend::SavePipelineCache()
+{
+    size_t cacheSize = 0;
+    vkGetPipelineCacheData(m_device, m_pipelineCache, &cacheSize, nullptr);
+
+    std::vector<std::byte> cacheData(cacheSize);
+    if (cacheSize == 0 || vkGetPipelineCacheData(m_device, m_pipelineCache, &cacheSize, cacheData.data()) != VK_SUCCESS)
+    {
+        return;
+    }
 
+    // NOTE(v.matushkin): Write into a temporary file first, so a crash can't leave a half written cache
+    const std::filesystem::path cacheFilePath(k_PipelineCachePath);
+    const std::filesystem::path tempFilePath(cacheFilePath.string() + ".tmp");
+
+    std::error_code errorCode;
+    {
+        std::ofstream cacheFile(tempFilePath, std::ios::binary | std::ios::out | std::ios::trunc);
+        cacheFile.write(reinterpret_cast<const char*>(cacheData.data()), cacheSize);
+
+        if (cacheFile.good() == false)
+        {
+            LOG_WARN("Failed to write Vulkan pipeline cache {}", tempFilePath.string());
+            cacheFile.close();
+            std::filesystem::remove(tempFilePath, errorCode);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempFilePath, cacheFilePath, errorCode);
+    if (errorCode)
+    {
+        LOG_WARN("Failed to rename {} to {}, error: {}", tempFilePath.string(), k_PipelineCachePath, errorCode.message());
+        std::filesystem::remove(tempFilePath, errorCode);
+    }
+}
+
+VkPipeline VulkanBackend::GetOrCreatePipeline(ShaderHandle shaderHandle)
+{
+    SNV_ASSERT(m_vertexLayout.empty() == false, "Pipelines can't be created before the vertex layout is known");
+
+    auto pipelineState   = m_pipelineState;
+    pipelineState.Shader = shaderHandle;
+
+    auto [pipelineIt, isInserted] = m_pipelines.try_emplace(pipelineState, VK_NULL_HANDLE);
+    if (isInserted)
+    {
+        pipelineIt->second = CreatePipeline(pipelineState, m_shaders.find(shaderHandle)->second);
+    }
+
+    return pipelineIt->second;
+}
+
+VkPipeline VulkanBackend::CreatePipeline(const PipelineState& pipelineState, const VulkanShader& shader)
+{
+    //- ShaderStages
     VkPipelineShaderStageCreateInfo vkShaderStages[] = {
         // Vertex
         {
@@ -1627,51 +2123,38 @@ void VulkanBackend::CreatePipeline()
     };
 
     //- VertexInput
-    // TODO(v.matushkin): Hardcoded
-    VkVertexInputBindingDescription vkVertexBindingDescriptions[] = {
-        {
-            .binding   = 0,
-            .stride    = sizeof(f32) * 3,
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        },
-        {
-            .binding   = 1,
-            .stride    = sizeof(f32) * 3,
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        },
-        {
-            .binding   = 2,
-            .stride    = sizeof(f32) * 3,
+    // NOTE(v.matushkin): A binding per attribute, BindBuffer commands bind the same VkBuffer at the attribute offsets,
+    //  so the same pipeline works for planar and interleaved layouts
+    VkVertexInputBindingDescription   vkVertexBindingDescriptions[static_cast<ui8>(VertexAttribute::Count)];
+    VkVertexInputAttributeDescription vkVertexAttributeDescriptions[static_cast<ui8>(VertexAttribute::Count)];
+
+    const auto vertexAttributeCount = static_cast<ui32>(m_vertexLayout.size());
+    for (ui32 i = 0; i < vertexAttributeCount; ++i)
+    {
+        const auto& vertexAttribute = m_vertexLayout[i];
+        const auto  vkFormatTable   = vertexAttribute.Normalized ? vk_VertexAttributeFormatNormalized : vk_VertexAttributeFormat;
+        const auto  vkFormat        = vkFormatTable[static_cast<ui8>(vertexAttribute.Format)][vertexAttribute.Dimension - 1];
+        SNV_ASSERT(vkFormat != VK_FORMAT_UNDEFINED, "Unsupported vertex attribute format");
+
+        vkVertexBindingDescriptions[i] = VkVertexInputBindingDescription{
+            .binding   = i,
+            .stride    = vertexAttribute.Stride,
             .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        },
-    };
-    VkVertexInputAttributeDescription vkVertexAttributeDescriptions[] = {
-        {
-            .location = 0,
-            .binding  = 0,
-            .format   = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset   = 0,
-        },
-        {
-            .location = 1,
-            .binding  = 1,
-            .format   = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset   = 0,
-        },
-        {
-            .location = 2,
-            .binding  = 2,
-            .format   = VK_FORMAT_R32G32B32_SFLOAT,
+        };
+        vkVertexAttributeDescriptions[i] = VkVertexInputAttributeDescription{
+            .location = static_cast<ui32>(vertexAttribute.Attribute),
+            .binding  = i,
+            .format   = vkFormat,
             .offset   = 0,
-        },
-    };
+        };
+    }
     VkPipelineVertexInputStateCreateInfo vkVertexInputState = {
         .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext                           = nullptr,
         .flags                           = 0, // SPEC: reserved for future use
-        .vertexBindingDescriptionCount   = ARRAYSIZE(vkVertexBindingDescriptions),
+        .vertexBindingDescriptionCount   = vertexAttributeCount,
         .pVertexBindingDescriptions      = vkVertexBindingDescriptions,
-        .vertexAttributeDescriptionCount = ARRAYSIZE(vkVertexAttributeDescriptions),
+        .vertexAttributeDescriptionCount = vertexAttributeCount,
         .pVertexAttributeDescriptions    = vkVertexAttributeDescriptions,
     };
 
@@ -1742,9 +2225,9 @@ void VulkanBackend::CreatePipeline()
         .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
         .pNext                 = nullptr,
         .flags                 = 0, // SPEC: reserved for future use
-        .depthTestEnable       = true,
-        .depthWriteEnable      = true,
-        .depthCompareOp        = VK_COMPARE_OP_LESS,
+        .depthTestEnable       = pipelineState.DepthTestEnable,
+        .depthWriteEnable      = pipelineState.DepthTestEnable,
+        .depthCompareOp        = vk_CompareOp[static_cast<ui32>(pipelineState.DepthCompare)],
         .depthBoundsTestEnable = false,
         .stencilTestEnable     = false,
         // .front                 = ,     // for stencilTestEnable=true
@@ -1756,12 +2239,12 @@ void VulkanBackend::CreatePipeline()
     //- ColorBlend
     // NOTE(v.matushkin): VkPipelineColorBlendAttachmentState - per framebuffer, VkPipelineColorBlendStateCreateInfo - global
     VkPipelineColorBlendAttachmentState vkColorBlendAttachment = {
-        .blendEnable         = false,
-        .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
-        .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .blendEnable         = pipelineState.BlendEnable,
+        .srcColorBlendFactor = vk_BlendFactor[static_cast<ui32>(pipelineState.SourceBlendFactor)],
+        .dstColorBlendFactor = vk_BlendFactor[static_cast<ui32>(pipelineState.DestinationBlendFactor)],
         .colorBlendOp        = VK_BLEND_OP_ADD,
-        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
-        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .srcAlphaBlendFactor = vk_BlendFactor[static_cast<ui32>(pipelineState.SourceBlendFactor)],
+        .dstAlphaBlendFactor = vk_BlendFactor[static_cast<ui32>(pipelineState.DestinationBlendFactor)],
         .alphaBlendOp        = VK_BLEND_OP_ADD,
         .colorWriteMask      = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
     };
@@ -1780,19 +2263,6 @@ void VulkanBackend::CreatePipeline()
     // NOTE(v.matushkin): Not needed right now
     // VkPipelineDynamicStateCreateInfo vkDynamicStateInfo;
 
-    //- Create VkPipelineLayout
-    VkDescriptorSetLayout      vkDescriptorSetLayouts[] = {m_descriptorSetLayoutCamera, m_descriptorSetLayourMaterial};
-    VkPipelineLayoutCreateInfo vkPipelineLayoutInfo = {
-        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .pNext                  = nullptr,
-        .flags                  = 0, // SPEC: reserved for future use
-        .setLayoutCount         = ARRAYSIZE(vkDescriptorSetLayouts),
-        .pSetLayouts            = vkDescriptorSetLayouts,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges    = nullptr,
-    };
-    vkCreatePipelineLayout(m_device, &vkPipelineLayoutInfo, nullptr, &m_pipelineLayout);
-
     //- Create GraphicsPipeline
     VkGraphicsPipelineCreateInfo vkGraphicsPipelineInfo = {
         .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
@@ -1815,8 +2285,10 @@ void VulkanBackend::CreatePipeline()
         .basePipelineHandle  = nullptr, // NOTE(v.matushkin): create a new graphics pipeline by deriving from an existing pipeline
         .basePipelineIndex   = -1,
     };
-    // NOTE(v.matushkin): VkPipelineCache ?
-    vkCreateGraphicsPipelines(m_device, nullptr, 1, &vkGraphicsPipelineInfo, nullptr, &m_graphicsPipeline);
+    VkPipeline vkPipeline;
+    vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &vkGraphicsPipelineInfo, nullptr, &vkPipeline);
+
+    return vkPipeline;
 }
 
 void VulkanBackend::CreateTextureSampler()
@@ -1825,9 +2297,9 @@ void VulkanBackend::CreateTextureSampler()
         .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .pNext                   = nullptr,
         .flags                   = 0,
-        .magFilter               = VK_FILTER_NEAREST,
-        .minFilter               = VK_FILTER_NEAREST,
-        .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+        .magFilter               = VK_FILTER_LINEAR,
+        .minFilter               = VK_FILTER_LINEAR,
+        .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR,
         .addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
         .addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
         .addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
@@ -1839,7 +2311,7 @@ void VulkanBackend::CreateTextureSampler()
         .compareEnable           = false, // ???
         .compareOp               = VK_COMPARE_OP_ALWAYS,
         .minLod                  = 0.0f,
-        .maxLod                  = 0.0f,
+        .maxLod                  = VK_LOD_CLAMP_NONE,
         .borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK, // NOTE(v.matushkin): Only used for ADDRESS_MODE_CLAMP_TO_BORDER
         .unnormalizedCoordinates = false, // false - uv[0, 1) | true - uv[0, width) [0, height)
     };
@@ -1858,68 +2330,95 @@ void VulkanBackend::CreateUniformBuffers()
         .queueFamilyIndexCount = 0,
         .pQueueFamilyIndices   = nullptr,
     };
-    VkMemoryAllocateInfo vkAllocateInfo = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .pNext           = nullptr,
-        .memoryTypeIndex = m_bufferMemoryTypeIndex.CPU,
-    };
-
     //- PerFrame
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
-        auto perFrameBuffer       = &m_ubPerFrame[i];
-        auto perFrameBufferMemory = &m_ubPerFrameMemory[i];
-
-        vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, perFrameBuffer);
-
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetBufferMemoryRequirements(m_device, *perFrameBuffer, &vkMemoryRequirements);
-
-        vkAllocateInfo.allocationSize = vkMemoryRequirements.size;
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, perFrameBufferMemory);
-
-        vkBindBufferMemory(m_device, *perFrameBuffer, *perFrameBufferMemory, 0);
+        vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, &m_ubPerFrame[i]);
+        m_ubPerFrameMemory[i] = m_memoryAllocator.AllocateBuffer(m_ubPerFrame[i], m_bufferMemoryTypeIndex.CPU);
     }
     //- PerDraw
-    vkStagingBufferInfo.size = sizeof(PerDraw);
+    // NOTE(v.matushkin): One PerDraw per instance, the whole buffer is bound once and the shader
+    //  indexes it with gl_InstanceIndex
+    vkStagingBufferInfo.size  = sizeof(PerDraw) * k_MaxInstancesPerFrame;
+    vkStagingBufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
-        auto perDrawBuffer       = &m_ubPerDraw[i];
-        auto perDrawBufferMemory = &m_ubPerDrawMemory[i];
-
-        vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, perDrawBuffer);
-
-        VkMemoryRequirements vkMemoryRequirements;
-        vkGetBufferMemoryRequirements(m_device, *perDrawBuffer, &vkMemoryRequirements);
+        vkCreateBuffer(m_device, &vkStagingBufferInfo, nullptr, &m_sbPerDraw[i]);
+        m_sbPerDrawMemory[i] = m_memoryAllocator.AllocateBuffer(m_sbPerDraw[i], m_bufferMemoryTypeIndex.CPU);
+    }
+}
 
-        vkAllocateInfo.allocationSize = vkMemoryRequirements.size;
-        vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, perDrawBufferMemory);
+void VulkanBackend::CreateIndirectBuffers()
+{
+    VkBufferCreateInfo vkBufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .size                  = sizeof(VkDrawIndexedIndirectCommand) * k_MaxDrawsPerFrame * k_GeometryArenaIndexTypes,
+        .usage                 = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices   = nullptr,
+    };
 
-        vkBindBufferMemory(m_device, *perDrawBuffer, *perDrawBufferMemory, 0);
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
+    {
+        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &m_indirectBuffers[i]);
+        m_indirectBufferMemory[i] = m_memoryAllocator.AllocateBuffer(m_indirectBuffers[i], m_bufferMemoryTypeIndex.CPU);
     }
 }
 
+void VulkanBackend::CreateGeometryArena()
+{
+    VkBufferCreateInfo vkBufferInfo = {
+        .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .size                  = k_GeometryArenaVertexSize,
+        .usage                 = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices   = nullptr,
+    };
+    //- Vertex
+    vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &m_geometryArena.Vertex);
+    m_geometryArena.VertexMemory = m_memoryAllocator.AllocateBuffer(m_geometryArena.Vertex, m_bufferMemoryTypeIndex.GPUVertex);
+    //- Index
+    vkBufferInfo.size  = k_GeometryArenaIndexSize;
+    vkBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+    vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &m_geometryArena.Index);
+    m_geometryArena.IndexMemory = m_memoryAllocator.AllocateBuffer(m_geometryArena.Index, m_bufferMemoryTypeIndex.GPUIndex);
+
+    m_geometryArena.VertexHead = 0;
+    m_geometryArena.IndexHead  = 0;
+}
+
 void VulkanBackend::CreateDescriptorPool()
 {
     // TODO(v.matushkin): <DescriptorSet>
     VkDescriptorPoolSize vkDescriptorPoolSizes[] = {
         {
             .type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount = k_BackBufferFrames * 2, // (PerFrame and PerDraw) * k_BackBufferFrames
+            .descriptorCount = m_framesInFlight, // PerFrame * m_framesInFlight
+        },
+        {
+            .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = m_framesInFlight, // PerDraw * m_framesInFlight
         },
         {
             .type            = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-            .descriptorCount = k_MaxTextureDescriptors,
+            .descriptorCount = m_maxTextureDescriptors, // Bindless texture array
         }
     };
 
-    // NOTE(v.matushkin): Flags?
+    // NOTE(v.matushkin): UPDATE_AFTER_BIND is required by the bindless texture set layout
     VkDescriptorPoolCreateInfo vkDescriptorPoolInfo = {
         .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
         .pNext         = nullptr,
-        .flags         = 0,
-        .maxSets       = k_BackBufferFrames + k_MaxTextureDescriptors,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets       = m_framesInFlight + 1,
         .poolSizeCount = ARRAYSIZE(vkDescriptorPoolSizes),
         .pPoolSizes    = vkDescriptorPoolSizes,
     };
@@ -1930,26 +2429,27 @@ void VulkanBackend::CreateDescriptorSets()
 {
     // TODO(v.matushkin): <DescriptorSet>
     //- Allocate DescriptorSets
-    const VkDescriptorSetLayout descriptorSetLayouts[] = {
-        m_descriptorSetLayoutCamera,
-        m_descriptorSetLayoutCamera,
-        m_descriptorSetLayoutCamera
-    };
+    VkDescriptorSetLayout descriptorSetLayouts[k_MaxFramesInFlight];
+    std::fill_n(descriptorSetLayouts, m_framesInFlight, m_descriptorSetLayoutCamera);
 
     VkDescriptorSetAllocateInfo vkDescriptorSetInfo = {
         .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .pNext              = nullptr,
         .descriptorPool     = m_descriptorPool,
-        .descriptorSetCount = ARRAYSIZE(descriptorSetLayouts),
+        .descriptorSetCount = m_framesInFlight,
         .pSetLayouts        = descriptorSetLayouts,
     };
     vkAllocateDescriptorSets(m_device, &vkDescriptorSetInfo, m_descriptorSets);
 
+    vkDescriptorSetInfo.descriptorSetCount = 1;
+    vkDescriptorSetInfo.pSetLayouts        = &m_descriptorSetLayoutTextures;
+    vkAllocateDescriptorSets(m_device, &vkDescriptorSetInfo, &m_descriptorSetTextures);
+
     //- Configure descriptors
-    VkDescriptorBufferInfo vkDescriptorBufferInfos[k_BackBufferFrames * 2];
-    VkWriteDescriptorSet   vkWriteDescriptorSets[k_BackBufferFrames * 2];
+    VkDescriptorBufferInfo vkDescriptorBufferInfos[k_MaxFramesInFlight * 2];
+    VkWriteDescriptorSet   vkWriteDescriptorSets[k_MaxFramesInFlight * 2];
 
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
         //- PerFrame
         vkDescriptorBufferInfos[i] = {
@@ -1970,21 +2470,21 @@ void VulkanBackend::CreateDescriptorSets()
             .pTexelBufferView = nullptr,
         };
         //- PerDraw
-        const auto perDrawIndex = i + k_BackBufferFrames;
+        const auto perDrawIndex = i + m_framesInFlight;
 
         vkDescriptorBufferInfos[perDrawIndex] = {
-            .buffer = m_ubPerDraw[i],
+            .buffer = m_sbPerDraw[i],
             .offset = 0,
-            .range  = sizeof(PerDraw),
+            .range  = VK_WHOLE_SIZE,
         };
         vkWriteDescriptorSets[perDrawIndex] = {
             .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext            = nullptr,
             .dstSet           = m_descriptorSets[i],
-            .dstBinding       = ShaderBinding::ubPerDraw,
+            .dstBinding       = ShaderBinding::sbPerDraw,
             .dstArrayElement  = 0,
             .descriptorCount  = 1,
-            .descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .pImageInfo       = nullptr,
             .pBufferInfo      = &vkDescriptorBufferInfos[perDrawIndex],
             .pTexelBufferView = nullptr,
@@ -1993,7 +2493,7 @@ void VulkanBackend::CreateDescriptorSets()
 
     // NOTE(v.matushkin): What is vkUpdateDescriptorSetWithTemplate?
     // NOTE(v.matushkin): Can I use VkCopyDescriptorSet somehow?
-    vkUpdateDescriptorSets(m_device, ARRAYSIZE(vkWriteDescriptorSets), vkWriteDescriptorSets, 0, nullptr);
+    vkUpdateDescriptorSets(m_device, m_framesInFlight * 2, vkWriteDescriptorSets, 0, nullptr);
 }
 
 void VulkanBackend::CreateCommandPool()
@@ -2017,7 +2517,7 @@ void VulkanBackend::FindMemoryTypeIndices()
 
     //- CPU
     m_bufferMemoryTypeIndex.CPU = FindBufferMemoryTypeIndex(
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         vkMemoryProperties
     );
@@ -2062,11 +2562,38 @@ void VulkanBackend::CreateCommandBuffers()
         .pNext              = nullptr,
         .commandPool        = m_commandPool,
         .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = k_BackBufferFrames,
+        .commandBufferCount = m_framesInFlight,
     };
     vkAllocateCommandBuffers(m_device, &vkCommandBufferInfo, m_commandBuffers);
 }
 
+void VulkanBackend::CreateSecondaryCommandBuffers()
+{
+    VkCommandPoolCreateInfo vkCommandPoolInfo = {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext            = nullptr,
+        .flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = m_graphicsQueueFamily,
+    };
+
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
+    {
+        for (ui32 j = 0; j < k_SecondaryCommandBufferCount; ++j)
+        {
+            vkCreateCommandPool(m_device, &vkCommandPoolInfo, nullptr, &m_secondaryCommandPools[i][j]);
+
+            VkCommandBufferAllocateInfo vkCommandBufferInfo = {
+                .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .pNext              = nullptr,
+                .commandPool        = m_secondaryCommandPools[i][j],
+                .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                .commandBufferCount = 1,
+            };
+            vkAllocateCommandBuffers(m_device, &vkCommandBufferInfo, &m_secondaryCommandBuffers[i][j]);
+        }
+    }
+}
+
 void VulkanBackend::CreateSyncronizationObjects()
 {
     VkSemaphoreCreateInfo vkSemaphoreInfo = {
@@ -2074,19 +2601,28 @@ void VulkanBackend::CreateSyncronizationObjects()
         .pNext = nullptr,
         .flags = 0, // SPEC: reserved for future use
     };
-    VkFenceCreateInfo vkFenceInfo = {
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT,
-    };
 
-    for (ui32 i = 0; i < k_BackBufferFrames; ++i)
+    for (ui32 i = 0; i < m_framesInFlight; ++i)
     {
         vkCreateSemaphore(m_device, &vkSemaphoreInfo, nullptr, &m_semaphoreImageAvailable[i]);
+    }
+    for (ui32 i = 0; i < m_swapchainImageCount; ++i)
+    {
         vkCreateSemaphore(m_device, &vkSemaphoreInfo, nullptr, &m_semaphoreRenderFinished[i]);
-
-        vkCreateFence(m_device, &vkFenceInfo, nullptr, &m_fences[i]);
     }
+
+    //- Frame Timeline
+    // NOTE(v.matushkin): Serial 0 is signaled from the start, so the first frames don't wait for anything
+    VkSemaphoreTypeCreateInfo vkSemaphoreTypeInfo = {
+        .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext         = nullptr,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue  = 0,
+    };
+    vkSemaphoreInfo.pNext = &vkSemaphoreTypeInfo;
+    vkCreateSemaphore(m_device, &vkSemaphoreInfo, nullptr, &m_frameTimeline);
+
+    std::fill(std::begin(m_frameSerials), std::end(m_frameSerials), 0);
 }
 
 
@@ -2135,6 +2671,34 @@ bool VulkanBackend::IsPhysicalDeviceSuitable(VkPhysicalDevice physicalDevice, ui
         return false;
     }
 
+    //- Bindless textures
+    VkPhysicalDeviceDescriptorIndexingFeatures vkDescriptorIndexing = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .pNext = nullptr,
+    };
+    VkPhysicalDeviceFeatures2 vkDeviceFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vkDescriptorIndexing,
+    };
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &vkDeviceFeatures);
+
+    if (vkDeviceFeatures.features.shaderSampledImageArrayDynamicIndexing == false
+        || vkDescriptorIndexing.shaderSampledImageArrayNonUniformIndexing == false
+        || vkDescriptorIndexing.descriptorBindingSampledImageUpdateAfterBind == false
+        || vkDescriptorIndexing.descriptorBindingPartiallyBound == false
+        || vkDescriptorIndexing.runtimeDescriptorArray == false)
+    {
+        return false;
+    }
+
+    //- Indirect drawing
+    if (vkDeviceFeatures.features.multiDrawIndirect == false
+        || vkDeviceFeatures.features.drawIndirectFirstInstance == false
+        || vkDeviceProperties.limits.maxDrawIndirectCount < k_MaxDrawsPerFrame)
+    {
+        return false;
+    }
+
     //- Enumerate Physical Device Queues
     ui32 vkQueueFamilyPropertyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &vkQueueFamilyPropertyCount, nullptr);
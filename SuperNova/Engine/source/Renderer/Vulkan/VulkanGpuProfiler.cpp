@@ -0,0 +1,234 @@
+#include <Engine/Renderer/Vulkan/VulkanGpuProfiler.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+
+#include <algorithm>
+#include <limits>
+
+
+namespace snv
+{
+
+void VulkanGpuProfiler::Init(
+    VkPhysicalDevice             physicalDevice,
+    VkDevice                     device,
+    ui32                         queueFamily,
+    ui32                         framesInFlight,
+    bool                         pipelineStatisticsEnabled,
+    std::span<const char* const> passNames
+)
+{
+    SNV_ASSERT(framesInFlight <= k_MaxFramesInFlight, "VulkanGpuProfiler: too many frames in flight");
+    SNV_ASSERT(passNames.size() <= k_MaxGpuPasses, "VulkanGpuProfiler: too many passes, increase k_MaxGpuPasses");
+
+    m_device                      = device;
+    m_timestampPool               = VK_NULL_HANDLE;
+    m_pipelineStatisticsPool      = VK_NULL_HANDLE;
+    m_isPipelineStatisticsEnabled = pipelineStatisticsEnabled;
+    m_passCount                   = static_cast<ui32>(passNames.size());
+    m_currentFrame                = 0;
+    m_frameStats                  = {};
+
+    std::copy(passNames.begin(), passNames.end(), m_passNames);
+    std::fill_n(m_isFrameRecorded, k_MaxFramesInFlight, false);
+
+    //- Timestamp support
+    {
+        ui32 vkQueueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &vkQueueFamilyCount, nullptr);
+        auto vkQueueFamilies = new VkQueueFamilyProperties[vkQueueFamilyCount];
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &vkQueueFamilyCount, vkQueueFamilies);
+        const auto timestampValidBits = vkQueueFamilies[queueFamily].timestampValidBits;
+        delete[] vkQueueFamilies;
+
+        VkPhysicalDeviceProperties vkDeviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &vkDeviceProperties);
+
+        m_isTimestampEnabled = timestampValidBits != 0;
+        m_timestampPeriod    = vkDeviceProperties.limits.timestampPeriod;
+        m_timestampMask      = timestampValidBits >= 64 ? std::numeric_limits<ui64>::max() : (ui64(1) << timestampValidBits) - 1;
+
+        if (m_isTimestampEnabled == false)
+        {
+            LOG_WARN("VulkanGpuProfiler: the graphics queue doesn't support timestamps, GPU timings are disabled");
+        }
+    }
+    //- Query Pools
+    if (m_isTimestampEnabled)
+    {
+        VkQueryPoolCreateInfo vkQueryPoolInfo = {
+            .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext              = nullptr,
+            .flags              = 0,
+            .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount         = framesInFlight * k_TimestampsPerFrame,
+            .pipelineStatistics = 0,
+        };
+        vkCreateQueryPool(m_device, &vkQueryPoolInfo, nullptr, &m_timestampPool);
+    }
+    if (m_isPipelineStatisticsEnabled)
+    {
+        VkQueryPoolCreateInfo vkQueryPoolInfo = {
+            .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext              = nullptr,
+            .flags              = 0,
+            .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            .queryCount         = framesInFlight,
+            .pipelineStatistics = k_PipelineStatistics,
+        };
+        vkCreateQueryPool(m_device, &vkQueryPoolInfo, nullptr, &m_pipelineStatisticsPool);
+    }
+}
+
+void VulkanGpuProfiler::Shutdown()
+{
+    // NOTE(v.matushkin): vkDestroyQueryPool ignores VK_NULL_HANDLE
+    vkDestroyQueryPool(m_device, m_timestampPool, nullptr);
+    vkDestroyQueryPool(m_device, m_pipelineStatisticsPool, nullptr);
+}
+
+
+void VulkanGpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, ui32 frameIndex)
+{
+    if (m_isFrameRecorded[frameIndex])
+    {
+        ReadFrameQueries(frameIndex);
+    }
+
+    m_currentFrame                = frameIndex;
+    m_isFrameRecorded[frameIndex] = true;
+
+    if (m_isTimestampEnabled)
+    {
+        const auto firstQuery = frameIndex * k_TimestampsPerFrame;
+        vkCmdResetQueryPool(commandBuffer, m_timestampPool, firstQuery, k_TimestampsPerFrame);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampPool, firstQuery);
+    }
+    if (m_isPipelineStatisticsEnabled)
+    {
+        vkCmdResetQueryPool(commandBuffer, m_pipelineStatisticsPool, frameIndex, 1);
+        vkCmdBeginQuery(commandBuffer, m_pipelineStatisticsPool, frameIndex, 0);
+    }
+}
+
+void VulkanGpuProfiler::EndFrame(VkCommandBuffer commandBuffer)
+{
+    if (m_isPipelineStatisticsEnabled)
+    {
+        vkCmdEndQuery(commandBuffer, m_pipelineStatisticsPool, m_currentFrame);
+    }
+    if (m_isTimestampEnabled)
+    {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampPool, m_currentFrame * k_TimestampsPerFrame + 1);
+    }
+}
+
+
+void VulkanGpuProfiler::BeginPass(VkCommandBuffer commandBuffer, ui32 passIndex) const
+{
+    if (m_isTimestampEnabled)
+    {
+        const auto query = m_currentFrame * k_TimestampsPerFrame + 2 + passIndex * 2;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampPool, query);
+    }
+}
+
+void VulkanGpuProfiler::EndPass(VkCommandBuffer commandBuffer, ui32 passIndex) const
+{
+    if (m_isTimestampEnabled)
+    {
+        const auto query = m_currentFrame * k_TimestampsPerFrame + 2 + passIndex * 2 + 1;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampPool, query);
+    }
+}
+
+
+void VulkanGpuProfiler::ReadFrameQueries(ui32 frameIndex)
+{
+    // NOTE(v.matushkin): WITH_AVAILABILITY puts a non zero value after the results of every written query,
+    //  the queries of the passes that weren't recorded stay unavailable. Without WAIT it returns VK_NOT_READY then,
+    //  that is expected
+    const VkQueryResultFlags vkResultFlags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+
+    GpuFrameStats frameStats = {};
+
+    if (m_isTimestampEnabled)
+    {
+        struct TimestampResult
+        {
+            ui64 Timestamp;
+            ui64 Available;
+        };
+        TimestampResult timestamps[k_TimestampsPerFrame];
+
+        (void) vkGetQueryPoolResults(
+            m_device,
+            m_timestampPool,
+            frameIndex * k_TimestampsPerFrame,
+            k_TimestampsPerFrame,
+            sizeof(timestamps),
+            timestamps,
+            sizeof(TimestampResult),
+            vkResultFlags
+        );
+
+        if (timestamps[0].Available != 0 && timestamps[1].Available != 0)
+        {
+            frameStats.FrameMilliseconds = GetMilliseconds(timestamps[0].Timestamp, timestamps[1].Timestamp);
+        }
+
+        for (ui32 i = 0; i < m_passCount; ++i)
+        {
+            const auto& passBegin = timestamps[2 + i * 2];
+            const auto& passEnd   = timestamps[2 + i * 2 + 1];
+            if (passBegin.Available == 0 || passEnd.Available == 0)
+            {
+                continue;
+            }
+
+            frameStats.Passes[frameStats.PassCount++] = GpuPassStats{
+                .Name         = m_passNames[i],
+                .Milliseconds = GetMilliseconds(passBegin.Timestamp, passEnd.Timestamp),
+            };
+        }
+    }
+    if (m_isPipelineStatisticsEnabled)
+    {
+        // NOTE(v.matushkin): Statistics are in the order of their bits
+        struct PipelineStatisticsResult
+        {
+            ui64 VertexInvocations;
+            ui64 FragmentInvocations;
+            ui64 Available;
+        };
+        PipelineStatisticsResult pipelineStatistics;
+
+        (void) vkGetQueryPoolResults(
+            m_device,
+            m_pipelineStatisticsPool,
+            frameIndex,
+            1,
+            sizeof(pipelineStatistics),
+            &pipelineStatistics,
+            sizeof(PipelineStatisticsResult),
+            vkResultFlags
+        );
+
+        if (pipelineStatistics.Available != 0)
+        {
+            frameStats.VertexInvocations   = pipelineStatistics.VertexInvocations;
+            frameStats.FragmentInvocations = pipelineStatistics.FragmentInvocations;
+        }
+    }
+
+    m_frameStats = frameStats;
+}
+
+f32 VulkanGpuProfiler::GetMilliseconds(ui64 beginTimestamp, ui64 endTimestamp) const
+{
+    const auto ticks = (endTimestamp - beginTimestamp) & m_timestampMask;
+    return static_cast<f32>(static_cast<f64>(ticks) * m_timestampPeriod / 1'000'000.0);
+}
+
+} // namespace snv
@@ -0,0 +1,319 @@
+#include <Engine/Renderer/Vulkan/VulkanMemoryAllocator.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+
+#include <algorithm>
+
+
+namespace
+{
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+
+namespace snv
+{
+
+void VulkanMemoryAllocator::Init(VkPhysicalDevice physicalDevice, VkDevice device)
+{
+    m_device                = device;
+    m_deviceAllocationCount = 0;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+
+    VkPhysicalDeviceProperties vkDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &vkDeviceProperties);
+    m_maxAllocationCount = vkDeviceProperties.limits.maxMemoryAllocationCount;
+}
+
+void VulkanMemoryAllocator::Shutdown()
+{
+    LogStats();
+
+    for (auto& memoryTypeBlocks : m_blocks)
+    {
+        for (auto& blocks : memoryTypeBlocks)
+        {
+            for (auto& block : blocks)
+            {
+                if (block.Memory != VK_NULL_HANDLE)
+                {
+                    if (block.MappedData != nullptr)
+                    {
+                        vkUnmapMemory(m_device, block.Memory);
+                    }
+                    vkFreeMemory(m_device, block.Memory, nullptr);
+                }
+            }
+            blocks.clear();
+        }
+    }
+
+    m_deviceAllocationCount = 0;
+}
+
+
+VulkanAllocation VulkanMemoryAllocator::AllocateBuffer(VkBuffer buffer, ui32 memoryTypeIndex)
+{
+    // NOTE(v.matushkin): VkMemoryRequirements2, VkMemoryDedicatedRequirements ?
+    VkMemoryRequirements vkMemoryRequirements;
+    vkGetBufferMemoryRequirements(m_device, buffer, &vkMemoryRequirements);
+
+    const auto allocation = Allocate(vkMemoryRequirements, memoryTypeIndex, VulkanResourceKind::Buffer);
+    // NOTE(v.matushkin): Use vkBindBufferMemory2 to bind multiple buffers at once?
+    vkBindBufferMemory(m_device, buffer, allocation.Memory, allocation.Offset);
+
+    return allocation;
+}
+
+VulkanAllocation VulkanMemoryAllocator::AllocateImage(VkImage image, ui32 memoryTypeIndex)
+{
+    VkMemoryRequirements vkMemoryRequirements;
+    vkGetImageMemoryRequirements(m_device, image, &vkMemoryRequirements);
+
+    const auto allocation = Allocate(vkMemoryRequirements, memoryTypeIndex, VulkanResourceKind::Image);
+    // NOTE(v.matushkin): vkBindImageMemory2 ?
+    vkBindImageMemory(m_device, image, allocation.Memory, allocation.Offset);
+
+    return allocation;
+}
+
+void VulkanMemoryAllocator::Free(const VulkanAllocation& allocation)
+{
+    auto& blocks = m_blocks[allocation.MemoryTypeIndex][static_cast<ui8>(allocation.Kind)];
+    auto& block  = blocks[allocation.BlockIndex];
+    SNV_ASSERT(block.Memory == allocation.Memory, "VulkanAllocation doesn't belong to this block");
+
+    block.UsedSize -= allocation.Size;
+    block.AllocationCount--;
+
+    //- Return the range, merging it with the neighbours
+    auto& freeRanges = block.FreeRanges;
+    auto  next       = std::lower_bound(
+        freeRanges.begin(),
+        freeRanges.end(),
+        allocation.Offset,
+        [](const FreeRange& freeRange, VkDeviceSize offset) { return freeRange.Offset < offset; }
+    );
+    auto  current    = freeRanges.insert(next, FreeRange{.Offset = allocation.Offset, .Size = allocation.Size});
+
+    if (auto following = current + 1; following != freeRanges.end() && current->Offset + current->Size == following->Offset)
+    {
+        current->Size += following->Size;
+        freeRanges.erase(following);
+    }
+    if (current != freeRanges.begin())
+    {
+        if (auto previous = current - 1; previous->Offset + previous->Size == current->Offset)
+        {
+            previous->Size += current->Size;
+            freeRanges.erase(current);
+        }
+    }
+
+    //- Release the block if it's empty, but keep one regular sized block per memory type around
+    if (block.AllocationCount == 0)
+    {
+        const auto liveBlockCount = std::count_if(blocks.begin(), blocks.end(), [](const MemoryBlock& memoryBlock) {
+            return memoryBlock.Memory != VK_NULL_HANDLE;
+        });
+        if (liveBlockCount > 1 || block.Size > k_BlockSize)
+        {
+            if (block.MappedData != nullptr)
+            {
+                vkUnmapMemory(m_device, block.Memory);
+            }
+            vkFreeMemory(m_device, block.Memory, nullptr);
+            m_deviceAllocationCount--;
+
+            block = MemoryBlock{.Memory = VK_NULL_HANDLE};
+        }
+    }
+}
+
+
+VulkanMemoryStats VulkanMemoryAllocator::GetStats() const
+{
+    VulkanMemoryStats stats               = {};
+    VkDeviceSize      largestFreeRangeSum = 0;
+
+    for (const auto& memoryTypeBlocks : m_blocks)
+    {
+        for (const auto& blocks : memoryTypeBlocks)
+        {
+            for (const auto& block : blocks)
+            {
+                if (block.Memory == VK_NULL_HANDLE)
+                {
+                    continue;
+                }
+
+                stats.BlockCount++;
+                stats.AllocationCount += block.AllocationCount;
+                stats.BytesReserved   += block.Size;
+                stats.BytesUsed       += block.UsedSize;
+                stats.FreeRangeCount  += static_cast<ui32>(block.FreeRanges.size());
+
+                VkDeviceSize largestFreeRange = 0;
+                for (const auto& freeRange : block.FreeRanges)
+                {
+                    largestFreeRange = std::max(largestFreeRange, freeRange.Size);
+                }
+                largestFreeRangeSum    += largestFreeRange;
+                stats.LargestFreeRange  = std::max(stats.LargestFreeRange, largestFreeRange);
+            }
+        }
+    }
+
+    const auto bytesFree = stats.BytesReserved - stats.BytesUsed;
+    stats.Fragmentation  = bytesFree == 0 ? 0.0f : 1.0f - f32(f64(largestFreeRangeSum) / f64(bytesFree));
+
+    return stats;
+}
+
+void VulkanMemoryAllocator::LogStats() const
+{
+    const auto stats = GetStats();
+    const auto toMiB = [](ui64 bytes) { return f64(bytes) / (1024.0 * 1024.0); };
+
+    LOG_INFO(
+        "Vulkan memory\n"
+        "\tBlocks: {} (device allocations: {}, max: {})\n"
+        "\tAllocations: {}\n"
+        "\tUsed: {:.2f}MiB of {:.2f}MiB reserved\n"
+        "\tFree ranges: {} (largest: {:.2f}MiB)\n"
+        "\tFragmentation: {:.3f}",
+        stats.BlockCount, m_deviceAllocationCount, m_maxAllocationCount,
+        stats.AllocationCount,
+        toMiB(stats.BytesUsed), toMiB(stats.BytesReserved),
+        stats.FreeRangeCount, toMiB(stats.LargestFreeRange),
+        stats.Fragmentation
+    );
+}
+
+
+VulkanAllocation VulkanMemoryAllocator::Allocate(
+    const VkMemoryRequirements& vkMemoryRequirements,
+    ui32                        memoryTypeIndex,
+    VulkanResourceKind          resourceKind
+)
+{
+    SNV_ASSERT(vkMemoryRequirements.memoryTypeBits & (1u << memoryTypeIndex), "Resource doesn't support this memory type");
+
+    const auto size      = vkMemoryRequirements.size;
+    const auto alignment = vkMemoryRequirements.alignment;
+
+    auto& blocks = m_blocks[memoryTypeIndex][static_cast<ui8>(resourceKind)];
+
+    //- First fit in the existing blocks, create a new one if nothing fits
+    ui32 blockIndex = 0;
+    ui32 rangeIndex = 0;
+    bool isFound    = false;
+
+    for (ui32 i = 0; i < blocks.size() && isFound == false; ++i)
+    {
+        const auto& block = blocks[i];
+        if (block.Memory == VK_NULL_HANDLE || block.Size - block.UsedSize < size)
+        {
+            continue;
+        }
+
+        for (ui32 j = 0; j < block.FreeRanges.size(); ++j)
+        {
+            const auto& freeRange = block.FreeRanges[j];
+            if (AlignUp(freeRange.Offset, alignment) + size <= freeRange.Offset + freeRange.Size)
+            {
+                blockIndex = i;
+                rangeIndex = j;
+                isFound    = true;
+                break;
+            }
+        }
+    }
+
+    if (isFound == false)
+    {
+        blockIndex = CreateBlock(blocks, std::max(k_BlockSize, AlignUp(size, alignment)), memoryTypeIndex);
+        rangeIndex = 0;
+    }
+
+    //- Carve the allocation out of the free range, alignment padding stays free
+    auto&      block           = blocks[blockIndex];
+    const auto freeRange       = block.FreeRanges[rangeIndex];
+    const auto offset          = AlignUp(freeRange.Offset, alignment);
+    const auto paddingSize     = offset - freeRange.Offset;
+    const auto remainingOffset = offset + size;
+    const auto remainingSize   = freeRange.Offset + freeRange.Size - remainingOffset;
+
+    block.FreeRanges.erase(block.FreeRanges.begin() + rangeIndex);
+    if (remainingSize != 0)
+    {
+        block.FreeRanges.insert(block.FreeRanges.begin() + rangeIndex, FreeRange{.Offset = remainingOffset, .Size = remainingSize});
+    }
+    if (paddingSize != 0)
+    {
+        block.FreeRanges.insert(block.FreeRanges.begin() + rangeIndex, FreeRange{.Offset = freeRange.Offset, .Size = paddingSize});
+    }
+
+    block.UsedSize += size;
+    block.AllocationCount++;
+
+    return VulkanAllocation{
+        .Memory          = block.Memory,
+        .Offset          = offset,
+        .Size            = size,
+        .MappedData      = block.MappedData == nullptr ? nullptr : static_cast<ui8*>(block.MappedData) + offset,
+        .MemoryTypeIndex = memoryTypeIndex,
+        .BlockIndex      = blockIndex,
+        .Kind            = resourceKind,
+    };
+}
+
+ui32 VulkanMemoryAllocator::CreateBlock(std::vector<MemoryBlock>& blocks, VkDeviceSize blockSize, ui32 memoryTypeIndex)
+{
+    SNV_ASSERT(m_deviceAllocationCount < m_maxAllocationCount, "Exceeded maxMemoryAllocationCount");
+
+    MemoryBlock block = {
+        .Size            = blockSize,
+        .UsedSize        = 0,
+        .MappedData      = nullptr,
+        .AllocationCount = 0,
+        .FreeRanges      = {FreeRange{.Offset = 0, .Size = blockSize}},
+    };
+
+    VkMemoryAllocateInfo vkAllocateInfo = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = nullptr,
+        .allocationSize  = blockSize,
+        .memoryTypeIndex = memoryTypeIndex,
+    };
+    const auto vkResult = vkAllocateMemory(m_device, &vkAllocateInfo, nullptr, &block.Memory);
+    SNV_ASSERT(vkResult == VK_SUCCESS, "vkAllocateMemory failed");
+    m_deviceAllocationCount++;
+
+    if (m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        vkMapMemory(m_device, block.Memory, 0, VK_WHOLE_SIZE, 0, &block.MappedData);
+    }
+
+    //- Reuse a released slot, so the BlockIndex of live allocations never changes
+    for (ui32 i = 0; i < blocks.size(); ++i)
+    {
+        if (blocks[i].Memory == VK_NULL_HANDLE)
+        {
+            blocks[i] = std::move(block);
+            return i;
+        }
+    }
+
+    blocks.push_back(std::move(block));
+    return static_cast<ui32>(blocks.size() - 1);
+}
+
+} // namespace snv
@@ -2,6 +2,7 @@
 #include <Engine/Core/Log.hpp>
 
 #include <glslang/SPIRV/GlslangToSpv.h>
+#include <spirv-tools/optimizer.hpp>
 
 
 // NOTE(v.matushkin): Just a quick/simple implementation
@@ -183,4 +184,22 @@ std::vector<ui32> CompileShader(ShaderType shaderType, std::span<const char> sha
     return spirvBytecode;
 }
 
+std::vector<ui32> OptimizeShader(std::span<const ui32> spirvBytecode)
+{
+    spvtools::Optimizer optimizer(SPV_ENV_VULKAN_1_2);
+    optimizer.SetMessageConsumer([](spv_message_level_t level, const char* source, const spv_position_t& position, const char* message) {
+        LOG_WARN("SPIRV-Tools optimizer: {} at {}:{}", message, position.line, position.column);
+    });
+    optimizer.RegisterPerformancePasses();
+
+    std::vector<ui32> optimizedBytecode;
+    if (optimizer.Run(spirvBytecode.data(), spirvBytecode.size(), &optimizedBytecode) == false)
+    {
+        LOG_ERROR("SPIRV-Tools optimizer failed, the shader is left unoptimized");
+        return std::vector<ui32>(spirvBytecode.begin(), spirvBytecode.end());
+    }
+
+    return optimizedBytecode;
+}
+
 } // namespace snv::VulkanShaderCompiler
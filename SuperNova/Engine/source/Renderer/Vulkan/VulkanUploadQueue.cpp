@@ -0,0 +1,447 @@
+#include <Engine/Renderer/Vulkan/VulkanUploadQueue.hpp>
+
+#include <Engine/Core/Assert.hpp>
+#include <Engine/Core/Log.hpp>
+
+#include <cstring>
+#include <limits>
+
+
+namespace snv
+{
+
+void VulkanUploadQueue::Init(
+    VkDevice               device,
+    VkQueue                queue,
+    ui32                   queueFamily,
+    VulkanMemoryAllocator* memoryAllocator,
+    ui32                   stagingMemoryTypeIndex
+)
+{
+    m_device                 = device;
+    m_queue                  = queue;
+    m_memoryAllocator        = memoryAllocator;
+    m_stagingMemoryTypeIndex = stagingMemoryTypeIndex;
+
+    m_ringHead           = 0;
+    m_ringTail           = 0;
+    m_firstBatch         = 0;
+    m_batchesInFlight    = 0;
+    m_isRecording        = false;
+    m_recordingBatchSize = 0;
+    m_submittedSerial    = 0;
+    m_retiredSerial      = 0;
+    m_stats              = {};
+
+    //- Command Buffers
+    {
+        VkCommandPoolCreateInfo vkCommandPoolInfo = {
+            .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext            = nullptr,
+            .flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = queueFamily,
+        };
+        vkCreateCommandPool(m_device, &vkCommandPoolInfo, nullptr, &m_commandPool);
+
+        VkCommandBuffer vkCommandBuffers[k_MaxBatches];
+        VkCommandBufferAllocateInfo vkCommandBufferInfo = {
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext              = nullptr,
+            .commandPool        = m_commandPool,
+            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = k_MaxBatches,
+        };
+        vkAllocateCommandBuffers(m_device, &vkCommandBufferInfo, vkCommandBuffers);
+
+        for (ui32 i = 0; i < k_MaxBatches; ++i)
+        {
+            m_batches[i].CommandBuffer = vkCommandBuffers[i];
+        }
+    }
+    //- Timeline Semaphore
+    {
+        VkSemaphoreTypeCreateInfo vkSemaphoreTypeInfo = {
+            .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .pNext         = nullptr,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue  = 0,
+        };
+        VkSemaphoreCreateInfo vkSemaphoreInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &vkSemaphoreTypeInfo,
+            .flags = 0,
+        };
+        vkCreateSemaphore(m_device, &vkSemaphoreInfo, nullptr, &m_timelineSemaphore);
+    }
+    //- Staging Ring
+    {
+        VkBufferCreateInfo vkBufferInfo = {
+            .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext                 = nullptr,
+            .flags                 = 0,
+            .size                  = k_StagingRingSize,
+            .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices   = nullptr,
+        };
+        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &m_stagingRing);
+        m_stagingRingMemory = m_memoryAllocator->AllocateBuffer(m_stagingRing, m_stagingMemoryTypeIndex);
+    }
+}
+
+void VulkanUploadQueue::Shutdown()
+{
+    Submit();
+    while (m_batchesInFlight > 0)
+    {
+        WaitOldestBatch();
+    }
+
+    LOG_INFO(
+        "Vulkan uploads\n\tUploads: {} ({:.2f}MiB)\n\tSubmissions: {}\n\tStaging ring stalls: {}",
+        m_stats.Uploads,
+        f64(m_stats.BytesUploaded) / (1024.0 * 1024.0),
+        m_stats.Submissions,
+        m_stats.RingStalls
+    );
+
+    vkDestroyBuffer(m_device, m_stagingRing, nullptr);
+    m_memoryAllocator->Free(m_stagingRingMemory);
+
+    vkDestroySemaphore(m_device, m_timelineSemaphore, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+}
+
+
+UploadSerial VulkanUploadQueue::UploadBuffer(VkBuffer buffer, VkDeviceSize bufferOffset, std::span<const std::byte> data)
+{
+    const auto stagingRange = Stage(data.data(), data.size_bytes());
+    auto&      batch        = GetRecordingBatch();
+
+    VkBufferCopy vkBufferCopyRegion = {
+        .srcOffset = stagingRange.Offset,
+        .dstOffset = bufferOffset,
+        .size      = data.size_bytes(),
+    };
+    // NOTE(v.matushkin): vkCmdCopyBuffer2KHR ?
+    vkCmdCopyBuffer(batch.CommandBuffer, stagingRange.Buffer, buffer, 1, &vkBufferCopyRegion);
+    batch.HasBufferCopies = true;
+
+    m_stats.Uploads++;
+    m_stats.BytesUploaded += data.size_bytes();
+
+    const auto serial = batch.Serial;
+    SubmitIfFull();
+
+    return serial;
+}
+
+UploadSerial VulkanUploadQueue::UploadTexture(VkImage image, const TextureDesc& textureDesc, const ui8* textureData)
+{
+    const auto textureSize = GetTextureSize(textureDesc);
+    const auto mipCount    = textureDesc.MipCount;
+
+    const auto stagingRange = Stage(textureData, textureSize);
+    auto&      batch        = GetRecordingBatch();
+
+    //- VkImage Memory Barrier UNDEFINED->DST_OPTIMAL
+    VkImageSubresourceRange vkImageSubresourceRange = {
+        .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel   = 0,
+        .levelCount     = mipCount,
+        .baseArrayLayer = 0,
+        .layerCount     = 1,
+    };
+    // TODO(v.matushkin): VkImageMemoryBarrier2KHR
+    VkImageMemoryBarrier vkImageMemoryBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext               = nullptr,
+        .srcAccessMask       = 0,
+        .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = image,
+        .subresourceRange    = vkImageSubresourceRange,
+    };
+    // TODO(v.matushkin): vkCmdPipelineBarrier2KHR?
+    vkCmdPipelineBarrier(
+        batch.CommandBuffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &vkImageMemoryBarrier
+    );
+    //- Copy VkBuffer to VkImage, one region per mip
+    // NOTE(v.matushkin): VkBufferImageCopy2KHR?
+    std::vector<VkBufferImageCopy> vkBufferImageCopies(mipCount);
+    VkDeviceSize                   mipOffset = stagingRange.Offset;
+    for (ui32 mip = 0; mip < mipCount; ++mip)
+    {
+        VkImageSubresourceLayers vkImageSubresourceLayers = {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel       = mip,
+            .baseArrayLayer = 0,
+            .layerCount     = 1,
+        };
+        vkBufferImageCopies[mip] = {
+            .bufferOffset      = mipOffset,
+            .bufferRowLength   = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource  = vkImageSubresourceLayers,
+            .imageOffset       = {0, 0, 0},
+            .imageExtent       = {GetMipDimension(textureDesc.Width, mip), GetMipDimension(textureDesc.Height, mip), 1},
+        };
+        mipOffset += GetMipSize(textureDesc, mip);
+    }
+    vkCmdCopyBufferToImage(
+        batch.CommandBuffer,
+        stagingRange.Buffer,
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        mipCount,
+        vkBufferImageCopies.data()
+    );
+    //- VkImage Memory Barrier DST_OPTIMAL->SHADER_READ_ONLY_OPTIMAL
+    vkImageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkImageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkImageMemoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkImageMemoryBarrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(
+        batch.CommandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &vkImageMemoryBarrier
+    );
+
+    m_stats.Uploads++;
+    m_stats.BytesUploaded += textureSize;
+
+    const auto serial = batch.Serial;
+    SubmitIfFull();
+
+    return serial;
+}
+
+
+void VulkanUploadQueue::Submit()
+{
+    if (m_isRecording == false)
+    {
+        return;
+    }
+
+    auto& batch = m_batches[(m_firstBatch + m_batchesInFlight) % k_MaxBatches];
+
+    // NOTE(v.matushkin): One barrier for all the buffer copies of the batch, pipeline barriers also order
+    //  the commands of the later submissions to the same queue, so the frame doesn't have to wait on the semaphore
+    if (batch.HasBufferCopies)
+    {
+        VkMemoryBarrier vkMemoryBarrier = {
+            .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext         = nullptr,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+        };
+        vkCmdPipelineBarrier(
+            batch.CommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            0,
+            1, &vkMemoryBarrier,
+            0, nullptr,
+            0, nullptr
+        );
+    }
+    vkEndCommandBuffer(batch.CommandBuffer);
+
+    batch.RingHead = m_ringHead;
+
+    VkTimelineSemaphoreSubmitInfo vkTimelineSubmitInfo = {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = nullptr,
+        .waitSemaphoreValueCount   = 0,
+        .pWaitSemaphoreValues      = nullptr,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues    = &batch.Serial,
+    };
+    VkSubmitInfo vkSubmitInfo = {
+        .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext                = &vkTimelineSubmitInfo,
+        .waitSemaphoreCount   = 0,
+        .pWaitSemaphores      = nullptr,
+        .pWaitDstStageMask    = nullptr,
+        .commandBufferCount   = 1,
+        .pCommandBuffers      = &batch.CommandBuffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores    = &m_timelineSemaphore,
+    };
+    vkQueueSubmit(m_queue, 1, &vkSubmitInfo, VK_NULL_HANDLE);
+
+    m_submittedSerial = batch.Serial;
+    m_batchesInFlight++;
+    m_isRecording = false;
+    m_stats.Submissions++;
+}
+
+void VulkanUploadQueue::Retire()
+{
+    ui64 completedSerial;
+    vkGetSemaphoreCounterValue(m_device, m_timelineSemaphore, &completedSerial);
+
+    while (m_batchesInFlight > 0)
+    {
+        auto& batch = m_batches[m_firstBatch];
+        if (batch.Serial > completedSerial)
+        {
+            break;
+        }
+
+        m_ringTail = batch.RingHead;
+
+        for (ui32 i = 0; i < batch.DedicatedBuffers.size(); ++i)
+        {
+            vkDestroyBuffer(m_device, batch.DedicatedBuffers[i], nullptr);
+            m_memoryAllocator->Free(batch.DedicatedMemory[i]);
+        }
+        batch.DedicatedBuffers.clear();
+        batch.DedicatedMemory.clear();
+
+        m_firstBatch = (m_firstBatch + 1) % k_MaxBatches;
+        m_batchesInFlight--;
+    }
+
+    m_retiredSerial = completedSerial;
+}
+
+
+VulkanUploadQueue::Batch& VulkanUploadQueue::GetRecordingBatch()
+{
+    if (m_isRecording == false)
+    {
+        if (m_batchesInFlight == k_MaxBatches)
+        {
+            WaitOldestBatch();
+        }
+
+        auto& batch = m_batches[(m_firstBatch + m_batchesInFlight) % k_MaxBatches];
+        batch.Serial          = m_submittedSerial + 1;
+        batch.HasBufferCopies = false;
+
+        VkCommandBufferBeginInfo vkCommandBufferBeginInfo = {
+            .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .pNext            = nullptr,
+            .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = nullptr,
+        };
+        vkResetCommandBuffer(batch.CommandBuffer, 0);
+        vkBeginCommandBuffer(batch.CommandBuffer, &vkCommandBufferBeginInfo);
+
+        m_isRecording        = true;
+        m_recordingBatchSize = 0;
+    }
+
+    return m_batches[(m_firstBatch + m_batchesInFlight) % k_MaxBatches];
+}
+
+VulkanUploadQueue::StagingRange VulkanUploadQueue::Stage(const void* data, VkDeviceSize size)
+{
+    SNV_ASSERT(size > 0, "Nothing to upload");
+
+    //- Doesn't fit in the ring at all, give it a dedicated staging buffer that lives until the batch retires
+    if (size > k_StagingRingSize)
+    {
+        VkBufferCreateInfo vkBufferInfo = {
+            .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext                 = nullptr,
+            .flags                 = 0,
+            .size                  = size,
+            .usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices   = nullptr,
+        };
+        VkBuffer vkBuffer;
+        vkCreateBuffer(m_device, &vkBufferInfo, nullptr, &vkBuffer);
+        const auto allocation = m_memoryAllocator->AllocateBuffer(vkBuffer, m_stagingMemoryTypeIndex);
+        std::memcpy(allocation.MappedData, data, size);
+
+        auto& batch = GetRecordingBatch();
+        batch.DedicatedBuffers.push_back(vkBuffer);
+        batch.DedicatedMemory.push_back(allocation);
+        m_recordingBatchSize += size;
+
+        return StagingRange{.Buffer = vkBuffer, .Offset = 0};
+    }
+
+    //- Reserve a contiguous range in the ring, wait for the GPU if there is not enough space
+    VkDeviceSize wrapPadding;
+    for (;;)
+    {
+        // NOTE(v.matushkin): Nothing is using the ring, start from the beginning so there is no wrap padding
+        if (m_batchesInFlight == 0 && m_ringHead == m_ringTail)
+        {
+            m_ringHead = 0;
+            m_ringTail = 0;
+        }
+
+        const auto headOffset = m_ringHead % k_StagingRingSize;
+        wrapPadding           = headOffset + size > k_StagingRingSize ? k_StagingRingSize - headOffset : 0;
+
+        if (m_ringHead + wrapPadding + size - m_ringTail <= k_StagingRingSize)
+        {
+            break;
+        }
+
+        m_stats.RingStalls++;
+        // NOTE(v.matushkin): The recording batch holds the rest of the ring, it has to go first
+        if (m_batchesInFlight == 0)
+        {
+            Submit();
+        }
+        WaitOldestBatch();
+    }
+
+    const auto rangeStart = m_ringHead + wrapPadding;
+    const auto offset     = rangeStart % k_StagingRingSize;
+    m_ringHead            = (rangeStart + size + k_StagingAlignment - 1) & ~(k_StagingAlignment - 1);
+
+    std::memcpy(static_cast<ui8*>(m_stagingRingMemory.MappedData) + offset, data, size);
+    m_recordingBatchSize += size;
+
+    return StagingRange{.Buffer = m_stagingRing, .Offset = offset};
+}
+
+void VulkanUploadQueue::SubmitIfFull()
+{
+    if (m_recordingBatchSize >= k_BatchSubmitSize)
+    {
+        Submit();
+    }
+}
+
+void VulkanUploadQueue::WaitOldestBatch()
+{
+    SNV_ASSERT(m_batchesInFlight > 0, "No upload batches in flight");
+
+    VkSemaphoreWaitInfo vkSemaphoreWaitInfo = {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext          = nullptr,
+        .flags          = 0,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_timelineSemaphore,
+        .pValues        = &m_batches[m_firstBatch].Serial,
+    };
+    vkWaitSemaphores(m_device, &vkSemaphoreWaitInfo, std::numeric_limits<ui64>::max());
+
+    Retire();
+}
+
+} // namespace snv
@@ -0,0 +1,144 @@
+#include <Engine/Utils/MappedFile.hpp>
+
+#include <Engine/Core/Log.hpp>
+
+#ifdef SNV_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <utility>
+
+
+namespace snv
+{
+
+MappedFile::MappedFile(const std::string& filePath)
+{
+#ifdef SNV_PLATFORM_WINDOWS
+    const HANDLE fileHandle = CreateFileA(
+        filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+    );
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER fileSize;
+    // NOTE(v.matushkin): Empty files can't be mapped
+    if (GetFileSizeEx(fileHandle, &fileSize) == FALSE || fileSize.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    const HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        LOG_ERROR("MappedFile: CreateFileMapping failed for {}, error: {}", filePath, GetLastError());
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    const void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        LOG_ERROR("MappedFile: MapViewOfFile failed for {}, error: {}", filePath, GetLastError());
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    m_data          = static_cast<const std::byte*>(data);
+    m_size          = static_cast<size_t>(fileSize.QuadPart);
+    m_fileHandle    = fileHandle;
+    m_mappingHandle = mappingHandle;
+#else
+    const i32 fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor == -1)
+    {
+        return;
+    }
+
+    struct stat fileStat;
+    // NOTE(v.matushkin): Empty files can't be mapped
+    if (fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+    {
+        close(fileDescriptor);
+        return;
+    }
+
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // NOTE(v.matushkin): The mapping keeps its own reference to the file
+    close(fileDescriptor);
+    if (data == MAP_FAILED)
+    {
+        LOG_ERROR("MappedFile: mmap failed for {}", filePath);
+        return;
+    }
+
+    m_data = static_cast<const std::byte*>(data);
+    m_size = static_cast<size_t>(fileStat.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+#ifdef SNV_PLATFORM_WINDOWS
+    , m_fileHandle(std::exchange(other.m_fileHandle, nullptr))
+    , m_mappingHandle(std::exchange(other.m_mappingHandle, nullptr))
+#endif
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        m_data          = std::exchange(other.m_data, nullptr);
+        m_size          = std::exchange(other.m_size, 0);
+#ifdef SNV_PLATFORM_WINDOWS
+        m_fileHandle    = std::exchange(other.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+
+void MappedFile::Close()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+
+#ifdef SNV_PLATFORM_WINDOWS
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+    m_fileHandle    = nullptr;
+    m_mappingHandle = nullptr;
+#else
+    munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace snv
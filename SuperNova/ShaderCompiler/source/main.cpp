@@ -0,0 +1,93 @@
+#include <Engine/Assets/ShaderCache.hpp>
+#include <Engine/Core/Core.hpp>
+#include <Engine/Core/Log.hpp>
+#include <Engine/Renderer/Vulkan/VulkanShaderCompiler.hpp>
+#include <Engine/Utils/Hash.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+
+
+// NOTE(v.matushkin): Offline compiler of the Vulkan GLSL shaders into optimized SPIR-V, run by the build
+//  for every shader in assets/shaders/vk/, so the engine doesn't have to run glslang on startup.
+//  Usage: SuperNovaShaderCompiler <name>_vs.glsl|<name>_fs.glsl <outputPath>
+
+
+i32 main(i32 argc, char** argv)
+{
+    if (argc != 3)
+    {
+        LOG_ERROR("Usage: SuperNovaShaderCompiler <name>_vs.glsl|<name>_fs.glsl <outputPath>");
+        return 1;
+    }
+
+    const std::string sourcePath = argv[1];
+    const std::string outputPath = argv[2];
+
+    using snv::VulkanShaderCompiler::ShaderType;
+
+    ShaderType shaderType;
+    if (sourcePath.ends_with("_vs.glsl"))
+    {
+        shaderType = ShaderType::Vertex;
+    }
+    else if (sourcePath.ends_with("_fs.glsl"))
+    {
+        shaderType = ShaderType::Fragment;
+    }
+    else
+    {
+        LOG_ERROR("Can't get the shader stage of {}, it should end with _vs.glsl or _fs.glsl", sourcePath);
+        return 1;
+    }
+
+    std::error_code errorCode;
+    const auto      sourceSize = std::filesystem::file_size(sourcePath, errorCode);
+    if (errorCode)
+    {
+        LOG_ERROR("Can't read {}, error: {}", sourcePath, errorCode.message());
+        return 1;
+    }
+    // NOTE(v.matushkin): glslang wants a null terminated string
+    auto source = std::make_unique<char[]>(sourceSize + 1);
+    {
+        std::ifstream sourceFile(sourcePath, std::ios::binary | std::ios::in);
+        sourceFile.read(source.get(), sourceSize);
+    }
+
+    const std::span<const char> sourceData(source.get(), sourceSize);
+    const auto                  sourceHash = snv::HashBytes(std::as_bytes(sourceData));
+
+    snv::ShaderCache::CookedShader cookedShader;
+    if (snv::ShaderCache::Read(outputPath, sourceHash, cookedShader))
+    {
+        LOG_INFO("{} is up to date", outputPath);
+        return 0;
+    }
+
+    snv::VulkanShaderCompiler::Init();
+    const auto spirvBytecode     = snv::VulkanShaderCompiler::CompileShader(shaderType, sourceData);
+    const auto optimizedBytecode = spirvBytecode.empty() ? spirvBytecode : snv::VulkanShaderCompiler::OptimizeShader(spirvBytecode);
+    snv::VulkanShaderCompiler::Shutdown();
+
+    if (optimizedBytecode.empty())
+    {
+        LOG_ERROR("Failed to compile {}", sourcePath);
+        return 1;
+    }
+
+    if (snv::ShaderCache::Write(outputPath, sourceHash, optimizedBytecode) == false)
+    {
+        return 1;
+    }
+
+    LOG_INFO(
+        "{} -> {} ({} -> {} bytes of SPIR-V)",
+        sourcePath, outputPath, spirvBytecode.size() * sizeof(ui32), optimizedBytecode.size() * sizeof(ui32)
+    );
+
+    return 0;
+}
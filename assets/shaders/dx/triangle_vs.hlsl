@@ -13,7 +13,7 @@ struct Attributes
 {
     float3 positionOS : POSITION;
     float3 normalOS   : NORMAL;
-    float3 texCoord0  : TEXCOORD0;
+    float2 texCoord0  : TEXCOORD0;
 };
 
 struct Varyings
@@ -33,7 +33,7 @@ Varyings main(Attributes IN)
     OUT.positionCS = mul(_CameraProjection, mul(_CameraView, positionWS));
     OUT.positionWS = positionWS.xyz;
     OUT.normalWS   = mul((float3x3)_ObjectToWorld, IN.normalOS);
-    OUT.texCoord0  = IN.texCoord0.xy;
+    OUT.texCoord0  = IN.texCoord0;
 
     return OUT;
 }
@@ -1,12 +1,14 @@
 #version 460 core
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(set = 0, binding = 2) uniform sampler   s_Sampler;
-layout(set = 1, binding = 0) uniform texture2D _BaseColorMap;
+layout(set = 1, binding = 0) uniform texture2D _Textures[];
 
 
 layout(location = 0) in vec3 in_PositionWS;
 layout(location = 1) in vec3 in_NormalWS;
 layout(location = 2) in vec2 in_TexCoord0;
+layout(location = 3) in flat uint in_BaseColorMapIndex;
 
 layout(location = 0) out vec4 out_FragColor;
 
@@ -15,7 +17,8 @@ void main()
 {
     vec3 normalWS = normalize(in_NormalWS);
 
-    vec4 baseColor = texture(sampler2D(_BaseColorMap, s_Sampler), in_TexCoord0);
+    // NOTE(v.matushkin): Indirect draws can share a subgroup, the index is not dynamically uniform
+    vec4 baseColor = texture(sampler2D(_Textures[nonuniformEXT(in_BaseColorMapIndex)], s_Sampler), in_TexCoord0);
 
     out_FragColor = baseColor; //vec4(normalWS, 1);
 }
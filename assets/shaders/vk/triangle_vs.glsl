@@ -1,34 +1,46 @@
 #version 460 core
 
+struct PerDrawData
+{
+    mat4x4 ObjectToWorld;
+    uint   BaseColorMapIndex;
+};
+
+
 layout(set = 0, binding = 0) uniform PerFrame
 {
     mat4x4 View;
     mat4x4 Projection;
 } ub_Camera;
 
-layout(set = 0, binding = 1) uniform PerDraw
+// NOTE(v.matushkin): firstInstance of every draw is its PerDraw index
+layout(set = 0, binding = 1) readonly buffer PerDraw
 {
-    mat4x4 ObjectToWorld;
-} ub_Model;
+    PerDrawData Draws[];
+} sb_PerDraw;
 
 
 layout(location = 0) in vec3 in_PositionOS;
 layout(location = 1) in vec3 in_NormalOS;
-layout(location = 2) in vec3 in_TexCoord0;
+layout(location = 2) in vec2 in_TexCoord0;
 
 layout(location = 0) out vec3 out_PositionWS;
 layout(location = 1) out vec3 out_NormalWS;
 layout(location = 2) out vec2 out_TexCoord0;
+layout(location = 3) out flat uint out_BaseColorMapIndex;
 
 
 void main()
 {
-    vec4 positionWS = ub_Model.ObjectToWorld * vec4(in_PositionOS, 1.0);
+    PerDrawData perDraw = sb_PerDraw.Draws[gl_InstanceIndex];
+
+    vec4 positionWS = perDraw.ObjectToWorld * vec4(in_PositionOS, 1.0);
 
     gl_Position = ub_Camera.Projection * ub_Camera.View * positionWS;
     gl_Position.y = -gl_Position.y;
 
-    out_PositionWS = positionWS.xyz;
-    out_NormalWS   = mat3x3(ub_Model.ObjectToWorld) * in_NormalOS;
-    out_TexCoord0  = in_TexCoord0.xy;
+    out_PositionWS        = positionWS.xyz;
+    out_NormalWS          = mat3x3(perDraw.ObjectToWorld) * in_NormalOS;
+    out_TexCoord0         = in_TexCoord0;
+    out_BaseColorMapIndex = perDraw.BaseColorMapIndex;
 }